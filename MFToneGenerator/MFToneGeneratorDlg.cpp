@@ -206,6 +206,7 @@ BEGIN_MESSAGE_MAP(CMFToneGeneratorDlg, CDialogEx)
 	ON_CBN_SELCHANGE(IDC_COMBO_WAVE_FORM, &CMFToneGeneratorDlg::OnCbnSelchangeComboWaveForm)
 	ON_WM_GETMINMAXINFO()
 	ON_WM_SIZE()
+	ON_WM_HSCROLL()
 END_MESSAGE_MAP()
 
 
@@ -404,7 +405,8 @@ void CMFToneGeneratorDlg::OnKeyButtonClicked(float key)
 	if(!m_pcmData) {
 		auto& sp = m_sampleDataTypeProperties[m_sampleType.GetCurSel()];
 		auto& wp = m_WaveFormProperties[m_waveForm.GetCurSel()];
-		float param = 0.0f;
+		// Parameter that is not set by the dialog(Digit, Seed and Order) uses the default value.
+		float param = wp.defaultParameter;
 		switch(wp.parameter) {
 		case PcmDataEnumerator::FactoryParameter::Duty:
 			param = (float)m_duty.GetPos() / SliderMaxValue;
@@ -421,6 +423,8 @@ void CMFToneGeneratorDlg::OnKeyButtonClicked(float key)
 			ATL::CA2T waveForm(m_pcmData->getWaveFormTypeName());
 			logger.log(_T("Created PcmData %s(%f) %d bps, %d Hz, %d channels")
 				, (LPCTSTR)waveForm, param, m_pcmData->getBitsPerSample(), m_pcmData->getSamplesPerSec(), m_pcmData->getChannels());
+			// Key buttons pressed while playing change the tone without click noise.
+			m_pcmData->setRetuneMode(IPcmData::RetuneMode::Continuous);
 		} else {
 			showStatus(_T("Failed to create PcmData for generator(0x%p)"), generator);
 			return;
@@ -499,3 +503,13 @@ void CMFToneGeneratorDlg::OnSize(UINT nType, int cx, int cy)
 		m_context->onResizeWindow();
 	}
 }
+
+void CMFToneGeneratorDlg::OnHScroll(UINT nSBCode, UINT nPos, CScrollBar* pScrollBar)
+{
+	// Level slider changes level of the tone being played without generating PCM data again.
+	if(m_pcmData && (pScrollBar == (CScrollBar*)&m_level)) {
+		m_pcmData->setLevel((float)m_level.GetPos() / SliderMaxValue);
+	}
+
+	__super::OnHScroll(nSBCode, nPos, pScrollBar);
+}
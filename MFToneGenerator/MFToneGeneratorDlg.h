@@ -100,4 +100,5 @@ public:
 	// Specify whether wave form of each channel is show in pane
 	BOOL m_showInPane;
 	afx_msg void OnSize(UINT nType, int cx, int cy);
+	afx_msg void OnHScroll(UINT nSBCode, UINT nPos, CScrollBar* pScrollBar);
 };
@@ -2,28 +2,29 @@
 
 #include "ToneAudioStream.h"
 
+// Sample duration in mSec.
+static const UINT32 duration = 200;
+
 ToneAudioStream::ToneAudioStream(ToneMediaSource* mediaSource, IMFStreamDescriptor* sd, std::shared_ptr<IPcmData>& pcmData)
 	: ToneMediaStream(mediaSource, sd), m_pcmData(pcmData), m_key(0)
 {
+	// Every onRequestSample() copies same size of samples.
+	// Tiled cycle data allows IPcmData::copyTo() to copy them by single memcpy().
+	if(m_pcmData) {
+		HR_EXPECT_OK(m_pcmData->setBlockSize(m_pcmData->getSampleBufferSize(duration)));
+		m_cursor = m_pcmData->createCursor();
+	}
 }
 
 /*static*/ HRESULT ToneAudioStream::createStreamDescriptor(IPcmData* pPcmData, DWORD streamId, IMFStreamDescriptor** ppsd)
 {
-	const DWORD nSamplesPerSec = pPcmData->getSamplesPerSec();
-	const WORD nBlockAlign = pPcmData->getBlockAlign();
-	WAVEFORMATEX waveFormat = {
-		pPcmData->getFormatTag(),			// wFormatTag
-		pPcmData->getChannels(),			// nChannels
-		nSamplesPerSec,						// nSamplesPerSec
-		nSamplesPerSec * nBlockAlign,		// nAvgBytesPerSec
-		nBlockAlign,						// nBlockAlign
-		pPcmData->getBitsPerSample(),		// wBitsPerSample
-		0,									// cbSize(No extra information)
-	};
+	// WAVEFORMATEXTENSIBLE for 24-bit sample in 32-bit container, otherwise WAVEFORMATEX(cbSize == 0).
+	WAVEFORMATEXTENSIBLE waveFormat;
+	pPcmData->getWaveFormat(waveFormat);
 
 	CComPtr<IMFMediaType> mediaType;
 	HR_ASSERT_OK(MFCreateMediaType(&mediaType));
-	HR_ASSERT_OK(MFInitMediaTypeFromWaveFormatEx(mediaType, &waveFormat, sizeof(waveFormat)));
+	HR_ASSERT_OK(MFInitMediaTypeFromWaveFormatEx(mediaType, &waveFormat.Format, sizeof(WAVEFORMATEX) + waveFormat.Format.cbSize));
 
 	IMFMediaType* mediaTypes[] = { mediaType };
 	return ToneMediaStream::createStreamDescriptor(mediaTypes, streamId, ppsd);
@@ -33,16 +34,13 @@ HRESULT ToneAudioStream::onRequestSample(IMFSample* sample)
 {
 	if (!m_pcmData) { return S_FALSE; }
 
-	// Sample duration in mSec.
-	static const UINT32 duration = 200;
-
 	// Copy PCM data generated by WaveGenerator to IMFMediaBuffer.
 	CComPtr<IMFMediaBuffer> buffer;
 	BYTE* rawBuffer;
 	DWORD size = m_pcmData->getSampleBufferSize(duration);
 	HR_ASSERT_OK(MFCreateMemoryBuffer(size, &buffer));
 	HR_ASSERT_OK(buffer->Lock(&rawBuffer, nullptr, nullptr));
-	HR_ASSERT_OK(m_pcmData->copyTo(rawBuffer, size));
+	HR_ASSERT_OK(m_cursor->copyTo(rawBuffer, size));
 	HR_ASSERT_OK(buffer->Unlock());
 	HR_ASSERT_OK(buffer->SetCurrentLength(size));
 
@@ -73,6 +71,10 @@ HRESULT ToneAudioStream::onStart(const PROPVARIANT* pvarStartPosition)
 	HR_ASSERT(pWaveFormat->wFormatTag == m_pcmData->getFormatTag(), MF_E_NOT_AVAILABLE);
 	HR_ASSERT(pWaveFormat->wBitsPerSample == m_pcmData->getBitsPerSample(), MF_E_NOT_AVAILABLE);
 	HR_ASSERT(pWaveFormat->nBlockAlign == m_pcmData->getBlockAlign(), MF_E_NOT_AVAILABLE);
+	if(pWaveFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+		auto pExtensible = (const WAVEFORMATEXTENSIBLE*)pWaveFormat.m_pData;
+		HR_ASSERT(pExtensible->Samples.wValidBitsPerSample == m_pcmData->getValidBitsPerSample(), MF_E_NOT_AVAILABLE);
+	}
 
 	return S_OK;
 }
@@ -85,6 +87,7 @@ HRESULT ToneAudioStream::onStop()
 
 HRESULT ToneAudioStream::onShutdown()
 {
+	m_cursor.reset();
 	m_pcmData.reset();
 
 	return S_OK;
@@ -20,4 +20,6 @@ protected:
 
     // PCM data generator.
     std::shared_ptr<IPcmData> m_pcmData;
+    // Position of audio stream, that is not affected by ToneVideoStream.
+    std::unique_ptr<IPcmDataCursor> m_cursor;
 };
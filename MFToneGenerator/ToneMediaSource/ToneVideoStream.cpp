@@ -153,9 +153,10 @@ void ToneVideoStream::drawWaveForm(CDC& dc, int width, int height)
 
 	if(!m_pcmSample || (m_pcmSample->getSampleCount() != m_pcmData->getSamplesPerCycle())) {
 		// Copy 1-cycle samples to the buffer and create IPcmSample object that references the buffer.
+		// New cursor copies from the beginning of the cycle, without moving position of ToneAudioStream.
 		auto bufferSize = m_pcmData->getSampleBufferSize(0);
 		m_sampleBuffer.reset(new BYTE[bufferSize]);
-		m_pcmData->copyTo(m_sampleBuffer.get(), bufferSize);
+		m_pcmData->createCursor()->copyTo(m_sampleBuffer.get(), bufferSize);
 		m_pcmSample.reset(createPcmSample(sampleDataType, m_sampleBuffer.get(), bufferSize));
 		m_startSampleIndex = 0;
 	}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "PcmDataImpl.h"
+#include "SimdKernel.h"
+
+#include <vector>
+#include <algorithm>
+
+/*
+ * DualTonePcmData template class derived from PcmData class.
+ *
+ * Renders digits of DTMF or MF(R1) signalling passed to generateDigits() method,
+ * or continuous dual tone of the digit passed to the factory by generate() method.
+ *
+ * Each frequency of the signalling has it's own tone table that contains exact period at the sample rate,
+ * that is (samplesPerSec / gcd(samplesPerSec, frequency)) frames of (frequency / gcd) cycles.
+ * Tone tables are built once when the first tone is generated, and are never changed or deleted while this object exists.
+ * copyTo() mixes contiguous reads of the low and high tone tables by SimdKernel::add(), instead of calculating sine,
+ * so that long digit scripts are rendered many times faster than real time.
+ *
+ * Script of digits is published to copyTo() without lock as cycle data of PcmData class.
+ * This class has no 1-cycle data, so that getSynthesisMode() returns SynthesisMode::Stream and
+ * createPcmSample() returns nullptr.
+ */
+template<typename T>
+class DualTonePcmData : public PcmData<T>
+{
+public:
+	DualTonePcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+		: PcmData<T>(samplesPerSec, channels, waveGenerator), m_toneTableSamples(0) {}
+
+	using PcmData<T>::copyTo;
+	// Generates continuous dual tone of the digit passed to the factory. key and phaseShift are ignored.
+	virtual void generate(float key, float level, float phaseShift) override;
+	// Channels are not independent.
+	virtual HRESULT generateChannels(const IPcmData::ToneParameter*) override { return E_NOTIMPL; }
+	virtual HRESULT generateDigits(const char* digits, size_t toneMilliseconds, size_t pauseMilliseconds, float level) override;
+
+	// Tone tables are not tiled. So blockSize is ignored.
+	virtual HRESULT setBlockSize(size_t, size_t) override { return S_OK; }
+	// Tone tables always have exact period unless it exceeds MaxToneTableFrames.
+	virtual HRESULT setExactPeriod(size_t) override { return S_OK; }
+	// Script always restarts when digits are generated. So retune mode is ignored.
+	virtual HRESULT setRetuneMode(IPcmData::RetuneMode, size_t) override { return S_OK; }
+
+	virtual IPcmData::SynthesisMode getSynthesisMode() const override { return IPcmData::SynthesisMode::Stream; }
+	virtual size_t getCycleDataSize() const override { return m_toneTableSamples * sizeof(float); }
+	virtual bool isTiled() const override { return false; }
+
+	// Max frame count of a tone table.
+	// Tone whose exact period exceeds this is rounded to the nearest cycles in this frames.
+	static const size_t MaxToneTableFrames = 0x40000;
+
+protected:
+	// Exact period of a tone at height 0.5, so that sum of 2 tones does not exceed +-1.0.
+	struct ToneTable
+	{
+		WORD frequency;
+		size_t frames;
+		size_t cycles;
+		std::unique_ptr<float[]> samples;
+	};
+
+	// Tone tables of all frequencies of the signalling.
+	std::vector<ToneTable> m_toneTables;
+	size_t m_toneTableSamples;
+
+	// Part of the script that plays a digit or silence.
+	struct Segment
+	{
+		size_t start;				// Frame in the script.
+		size_t frames;
+		const ToneTable* low;		// nullptr for silence.
+		const ToneTable* high;
+	};
+
+	// Digits calculated by generate() or generateDigits() method and read by copyTo() method.
+	struct Script
+	{
+		Script(size_t generation) : frames(0), generation(generation) {}
+
+		std::vector<Segment> segments;
+		// Total frames of the segments, that are repeated.
+		size_t frames;
+		// Incremented by generate() and generateDigits(). Position restarts when the generation is changed.
+		const size_t generation;
+	};
+
+	EpochPtr<Script> m_script;
+
+	// position.position of Position holds frame in the script.
+	virtual HRESULT copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest) override;
+
+	// Returns tone table of the frequency, building all tables of the signalling if necessary.
+	const ToneTable* getToneTable(WORD frequency);
+	// Returns difference between actual frequency of the tables of the digit and nominal frequency, whichever is larger.
+	double getFrequencyError(const DualToneWaveForm::Digit& digit);
+	// Publishes the script to copyTo(), and sets properties.
+	void publish(std::unique_ptr<Script>&& script, size_t samplesPerCycle, double frequencyError, float level);
+};
+
+template<typename T>
+HRESULT DualTonePcmData<T>::copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest)
+{
+	typename EpochPtr<Script>::Reader script(m_script);
+
+	// Assert that data has been generated.
+	HR_ASSERT(script.get(), E_ILLEGAL_METHOD_CALL);
+
+	if(position.generation.load() != script->generation) {
+		position.generation = script->generation;
+		position.position = 0;
+	}
+
+	auto& segments = script->segments;
+	auto current = position.position.load();
+	const auto level = this->getLevel(script->generation);
+
+	// Mixed tones are rendered in the buffer on the stack as master of all channels(stride = 0).
+	float buffer[PcmData<T>::ConvertBufferSamples];
+	for(size_t frame = 0; frame < dest.frames; frame += PcmData<T>::ConvertBufferSamples) {
+		auto count = min(dest.frames - frame, PcmData<T>::ConvertBufferSamples);
+		for(size_t done = 0; done < count;) {
+			// Segment that contains current frame.
+			auto it = std::upper_bound(segments.begin(), segments.end(), current,
+										[](size_t f, const Segment& s) { return f < s.start; }) - 1;
+			auto offset = current - it->start;
+			auto n = min(count - done, it->frames - offset);
+			if(it->low) {
+				// Each tone starts from phase 0 at the beginning of the digit.
+				auto lowOffset = offset % it->low->frames;
+				auto highOffset = offset % it->high->frames;
+				n = min(n, min(it->low->frames - lowOffset, it->high->frames - highOffset));
+				SimdKernel::add(&buffer[done], &it->low->samples[lowOffset], &it->high->samples[highOffset], n);
+			} else {
+				std::fill_n(&buffer[done], n, 0.0f);
+			}
+			done += n;
+			current += n;
+			if(script->frames <= current) { current = 0; }
+		}
+		this->put(position, level, dest, frame, buffer, 0, count);
+	}
+	position.position = current;
+	return S_OK;
+}
+
+template<typename T>
+void DualTonePcmData<T>::generate(float, float level, float)
+{
+	CriticalSection lock(this->m_cycleDataLock);
+
+	auto& digit = ((const DualToneWaveForm&)this->m_waveGenerator->getWaveForm()).getDigit();
+	std::unique_ptr<Script> script(new Script(++this->m_generation));
+	// Frames of continuous tone is the max value, that is never reached by copyTo().
+	script->frames = SIZE_MAX;
+	script->segments.push_back({ 0, SIZE_MAX, getToneTable(digit.lowFrequency), getToneTable(digit.highFrequency) });
+
+	// Samples per cycle is used to calculate buffer size for 1 cycle of the low tone.
+	auto samplesPerCycle = this->ceiling((size_t)(this->m_samplesPerSec * this->m_channels / digit.lowFrequency), this->m_channels);
+	publish(std::move(script), samplesPerCycle, getFrequencyError(digit), level);
+}
+
+template<typename T>
+HRESULT DualTonePcmData<T>::generateDigits(const char* digits, size_t toneMilliseconds, size_t pauseMilliseconds, float level)
+{
+	HR_ASSERT(digits, E_POINTER);
+	HR_ASSERT(*digits, E_INVALIDARG);
+
+	auto toneFrames = this->m_samplesPerSec * toneMilliseconds / 1000;
+	auto pauseFrames = this->m_samplesPerSec * pauseMilliseconds / 1000;
+	HR_ASSERT(0 < toneFrames, E_INVALIDARG);
+
+	CriticalSection lock(this->m_cycleDataLock);
+
+	auto type = this->getWaveFormType();
+	std::unique_ptr<Script> script(new Script(this->m_generation + 1));
+	double frequencyError = 0;
+	auto addSegment = [&script](size_t frames, const ToneTable* low, const ToneTable* high) {
+		if(frames) {
+			script->segments.push_back({ script->frames, frames, low, high });
+			script->frames += frames;
+		}
+	};
+	for(auto p = digits; *p; p++) {
+		if(*p == ',') {
+			addSegment(toneFrames + pauseFrames, nullptr, nullptr);
+			continue;
+		}
+		auto digit = DualToneWaveForm::findDigit(type, *p);
+		HR_ASSERT(digit, E_INVALIDARG);
+		addSegment(toneFrames, getToneTable(digit->lowFrequency), getToneTable(digit->highFrequency));
+		addSegment(pauseFrames, nullptr, nullptr);
+		auto error = getFrequencyError(*digit);
+		if(fabs(frequencyError) < fabs(error)) { frequencyError = error; }
+	}
+
+	++this->m_generation;
+	publish(std::move(script), 0, frequencyError, level);
+	return S_OK;
+}
+
+template<typename T>
+const typename DualTonePcmData<T>::ToneTable* DualTonePcmData<T>::getToneTable(WORD frequency)
+{
+	if(m_toneTables.empty()) {
+		auto frequencies = DualToneWaveForm::getFrequencies(this->getWaveFormType());
+		// Tables are not moved after they are referred by the script.
+		m_toneTables.resize(frequencies.size());
+		for(size_t i = 0; i < frequencies.size(); i++) {
+			auto& table = m_toneTables[i];
+			table.frequency = frequencies[i];
+
+			// Euclidean algorithm.
+			size_t a = this->m_samplesPerSec, b = table.frequency;
+			while(b) { auto r = a % b; a = b; b = r; }
+			table.frames = this->m_samplesPerSec / a;
+			table.cycles = table.frequency / a;
+			if(MaxToneTableFrames < table.frames) {
+				table.frames = MaxToneTableFrames;
+				table.cycles = (size_t)(((double)table.frequency * MaxToneTableFrames / this->m_samplesPerSec) + 0.5);
+			}
+
+			table.samples.reset(new float[table.frames]);
+			SimdKernel::sine(table.samples.get(), 1, table.frames, table.cycles, 0, 0.5f);
+			m_toneTableSamples += table.frames;
+		}
+	}
+
+	for(auto& table : m_toneTables) {
+		if(table.frequency == frequency) { return &table; }
+	}
+	return nullptr;
+}
+
+template<typename T>
+double DualTonePcmData<T>::getFrequencyError(const DualToneWaveForm::Digit& digit)
+{
+	double error = 0;
+	for(auto table : { getToneTable(digit.lowFrequency), getToneTable(digit.highFrequency) }) {
+		auto e = ((double)this->m_samplesPerSec * table->cycles / table->frames) - table->frequency;
+		if(fabs(error) < fabs(e)) { error = e; }
+	}
+	return error;
+}
+
+template<typename T>
+void DualTonePcmData<T>::publish(std::unique_ptr<Script>&& script, size_t samplesPerCycle, double frequencyError, float level)
+{
+	// Samples per cycle of digits is the whole script, so that getSampleBufferSize(0) returns size of all digits.
+	if(!samplesPerCycle) { samplesPerCycle = script->frames * this->m_channels; }
+
+	// Publish new script to copyTo() without blocking it.
+	this->publishLevel(level, 0, script->generation);
+	m_script.publish(std::move(script));
+
+	this->m_samplesPerCycle = samplesPerCycle;
+	this->m_cycles = 1;
+	this->m_frequencyError = frequencyError;
+}
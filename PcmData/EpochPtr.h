@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PcmData.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/*
+ * EpochPtr template class
+ *
+ * Holds pointer to an object that is read by lock-free readers and replaced by a writer.
+ * Writer publishes new object by atomic exchange,
+ * and deletes old object after all readers that might refer to it have left(Epoch-based reclamation).
+ *
+ * Readers are counted for the epoch in which they entered.
+ * Epoch is incremented when new object is published.
+ * Then readers of previous epoch are waited, because only they might refer to the old object.
+ * Reader never blocks. Writer waits at most for the duration of the longest reader.
+ *
+ * Writers should be serialized by the caller, for example, using CriticalSection.
+ */
+template<typename D>
+class EpochPtr : DoNotCopy
+{
+public:
+	EpochPtr() : m_ptr(nullptr), m_epoch(0) { m_readers[0] = 0; m_readers[1] = 0; }
+	~EpochPtr() { delete m_ptr.load(); }
+
+	/*
+	 * Reader class
+	 *
+	 * Object retrieved by get() method is not deleted while the Reader object exists.
+	 * Create Reader on the stack and destroy it as soon as possible.
+	 */
+	class Reader : DoNotCopy
+	{
+	public:
+		Reader(EpochPtr& owner) {
+			// Retry if the epoch is incremented by the writer before entering.
+			// Otherwise the writer might not wait for this reader.
+			for(;;) {
+				auto epoch = owner.m_epoch.load();
+				m_readers = &owner.m_readers[epoch & 1];
+				(*m_readers)++;
+				if(epoch == owner.m_epoch.load()) { break; }
+				(*m_readers)--;
+			}
+			m_ptr = owner.m_ptr.load();
+		}
+		~Reader() { (*m_readers)--; }
+
+		D* get() const { return m_ptr; }
+		D* operator->() const { return m_ptr; }
+
+	protected:
+		std::atomic<size_t>* m_readers;
+		D* m_ptr;
+	};
+
+	// Returns current object.
+	// Call from the writer, or the object might be deleted by the writer.
+	D* get() const { return m_ptr.load(); }
+
+	// Replaces current object with new one.
+	// Returns old object after all readers that might refer to it have left.
+	// Old object is deleted if the caller ignores the return value.
+	std::unique_ptr<D> publish(std::unique_ptr<D>&& ptr) {
+		std::unique_ptr<D> old(m_ptr.exchange(ptr.release()));
+		// Readers that enter after this point refer to the new object.
+		auto epoch = m_epoch.fetch_add(1);
+		while(m_readers[epoch & 1].load() != 0) {
+			std::this_thread::yield();
+		}
+		return old;
+	}
+
+protected:
+	std::atomic<D*> m_ptr;
+	std::atomic<size_t> m_epoch;
+	std::atomic<size_t> m_readers[2];
+};
@@ -2,6 +2,13 @@
 
 #include <Windows.h>
 
+/*
+ * INT24 class
+ *
+ * 24-bit signed integer sample packed in 3 bytes.
+ * Conversions are inline so that per-sample access compiles to a few shifts.
+ * Use SimdKernel::packInt24() and unpackInt24() to convert many samples at once.
+ */
 class INT24
 {
 public:
@@ -10,7 +17,10 @@ public:
 	INT24(double value) { construct((INT32)value); }
 
 	operator INT32() const { return toINT32(); }
-	INT32 toINT32() const;
+	// Sign of the highest byte is extended by arithmetic shift.
+	INT32 toINT32() const {
+		return (INT32)(((UINT32)value[0] << 8) | ((UINT32)value[1] << 16) | ((UINT32)value[2] << 24)) >> 8;
+	}
 
 	INT24 operator+(const INT24& that) const { return INT24(this->toINT32() + that.toINT32()); }
 	INT24 operator+(double that) const { return INT24(this->toINT32() + that); }
@@ -22,9 +32,40 @@ public:
 	static const INT32 MinValue = 0xff800000;	// -8388608;
 
 protected:
-	void construct(INT32);
+	// Sign bit of the INT32 value is copied to the highest byte.
+	void construct(INT32 value) {
+		this->value[0] = (BYTE)value;
+		this->value[1] = (BYTE)(value >> 8);
+		this->value[2] = (BYTE)((value >> 16) | ((value >> 24) & 0x80));
+	}
 
 	// 24bit internal value.
 	// Note: Do not define this value in struct, or sizeof(INT24) can not be 3.
 	BYTE value[3];
 };
+
+/*
+ * INT24in32 class
+ *
+ * 24-bit signed integer sample in 32-bit container(WAVE_FORMAT_EXTENSIBLE, wValidBitsPerSample = 24).
+ * Value is left-justified in the container, and the low 8 bits are 0.
+ * Container is aligned to 4 bytes, so that samples are stored by SIMD without shuffling bytes.
+ * Conversion to/from INT32 handles the value of 24-bit range same as INT24 class.
+ */
+class INT24in32
+{
+public:
+	INT24in32() : value(0) {}
+	INT24in32(INT32 value) : value((INT32)((UINT32)value << 8)) {}
+	INT24in32(double value) : INT24in32((INT32)value) {}
+
+	operator INT32() const { return toINT32(); }
+	INT32 toINT32() const { return value >> 8; }
+
+	static const INT32 MaxValue = INT24::MaxValue;
+	static const INT32 MinValue = INT24::MinValue;
+
+protected:
+	// Value in the container.
+	INT32 value;
+};
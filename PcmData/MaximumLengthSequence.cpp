@@ -0,0 +1,126 @@
+#include "MaximumLengthSequence.h"
+#include "SimdKernel.h"
+
+#include <StateMachine/stdafx.h>
+#include <StateMachine/Assert.h>
+
+#include <algorithm>
+
+// Feedback polynomial of each order, that is primitive over GF(2).
+// Bit k is coefficient of x^k, and the sequence satisfies s[n + order] = XOR of s[n + k] for each bit k.
+static const UINT32 feedbackTaps[MaximumLengthSequence::MaxOrder + 1] = {
+	0, 0,
+	0x0003,		// x^2 + x + 1
+	0x0003,		// x^3 + x + 1
+	0x0003,		// x^4 + x + 1
+	0x0005,		// x^5 + x^2 + 1
+	0x0003,		// x^6 + x + 1
+	0x0003,		// x^7 + x + 1
+	0x0071,		// x^8 + x^6 + x^5 + x^4 + 1
+	0x0011,		// x^9 + x^4 + 1
+	0x0009,		// x^10 + x^3 + 1
+	0x0005,		// x^11 + x^2 + 1
+	0x0053,		// x^12 + x^6 + x^4 + x + 1
+	0x001b,		// x^13 + x^4 + x^3 + x + 1
+	0x002b,		// x^14 + x^5 + x^3 + x + 1
+	0x0003,		// x^15 + x + 1
+	0x002d,		// x^16 + x^5 + x^3 + x^2 + 1
+	0x0009,		// x^17 + x^3 + 1
+	0x0081,		// x^18 + x^7 + 1
+	0x0027,		// x^19 + x^5 + x^2 + x + 1
+	0x0009,		// x^20 + x^3 + 1
+	0x0005,		// x^21 + x^2 + 1
+	0x0003,		// x^22 + x + 1
+	0x0021,		// x^23 + x^5 + 1
+	0x0087,		// x^24 + x^7 + x^2 + x + 1
+};
+
+MaximumLengthSequence::MaximumLengthSequence(int order)
+	: m_order(max(MinOrder, min(order, MaxOrder))), m_length(((size_t)1 << m_order) - 1)
+	, m_bits((m_length + 63) / 64)
+{
+	auto taps = feedbackTaps[m_order];
+
+	// Lags of the recurrence s[n] = XOR of s[n - lag].
+	// Lags are doubled until the minimum lag is 64 or more, that is the polynomial raised to the power of 2^j.
+	std::vector<size_t> lags;
+	for(int k = 0; k < m_order; k++) {
+		if(taps & (1 << k)) { lags.push_back(m_order - k); }
+	}
+	while(*std::min_element(lags.begin(), lags.end()) < 64) {
+		for(auto& lag : lags) { lag *= 2; }
+	}
+	auto maxLag = *std::max_element(lags.begin(), lags.end());
+
+	// Words that precede the max lag are calculated bit by bit from the initial state of all 1s.
+	auto serialWords = min(m_bits.size(), (maxLag + 63) / 64);
+	for(size_t n = 0; n < serialWords * 64; n++) {
+		UINT64 bit = 1;
+		if((size_t)m_order <= n) {
+			bit = 0;
+			for(int k = 0; k < m_order; k++) {
+				if(taps & (1 << k)) { bit ^= getBit(n - m_order + k); }
+			}
+		}
+		m_bits[n / 64] |= bit << (n % 64);
+	}
+
+	// Following words are calculated 64 bits at once.
+	for(size_t w = serialWords; w < m_bits.size(); w++) {
+		UINT64 word = 0;
+		for(auto lag : lags) { word ^= getWord((w * 64) - lag); }
+		m_bits[w] = word;
+	}
+}
+
+UINT64 MaximumLengthSequence::getWord(size_t position) const
+{
+	auto word = position / 64;
+	auto shift = position % 64;
+	return shift ? ((m_bits[word] >> shift) | (m_bits[word + 1] << (64 - shift))) : m_bits[word];
+}
+
+void MaximumLengthSequence::generate(float* dest, size_t count, size_t index, float height) const
+{
+	index %= m_length;
+	while(count) {
+		auto n = min(count, m_length - index);
+		SimdKernel::expandBits(dest, m_bits.data(), index, n, -height, height);
+		dest += n;
+		count -= n;
+		index = 0;
+	}
+}
+
+HRESULT MaximumLengthSequence::analyze(float* impulseResponse, const float* response) const
+{
+	HR_ASSERT(impulseResponse && response, E_POINTER);
+
+	// Bit s[i + j] is inner product over GF(2) of 2 vectors of order bits: input index x(j) and output index r(i).
+	// x(j) is the state of the LFSR, that is bits s[j] ~ s[j + order - 1].
+	// r(0) is 1 that selects s[j], and r(i + 1) is r(i) stepped by transposed LFSR(Galois LFSR) of the same taps.
+	// So the circulant matrix of the sequence is Hadamard matrix whose rows and columns are permuted by r(i) and x(j).
+	std::vector<float> work((size_t)1 << m_order);
+	double sum = 0;
+	size_t x = 0;
+	for(int t = 0; t < m_order; t++) { x |= (size_t)getBit(t) << t; }
+	for(size_t j = 0; j < m_length; j++) {
+		work[x] = response[j];
+		sum += response[j];
+		x = (x >> 1) | ((size_t)getBit((j + m_order) % m_length) << (m_order - 1));
+	}
+
+	SimdKernel::hadamard(work.data(), work.size());
+
+	// Cross-correlation at lag k is the transform at r(-k), so that r is stepped backward.
+	// Correlation = (length + 1) * h[k] - sum of h, and sum of response = -(sum of h) because sum of the sequence is -1.
+	auto taps = feedbackTaps[m_order];
+	auto scale = 1.0 / (m_length + 1);
+	size_t r = 1;
+	for(size_t k = 0; k < m_length; k++) {
+		impulseResponse[k] = (float)((work[r] - sum) * scale);
+		auto top = r & 1;
+		r = ((r ^ (top ? taps : 0)) >> 1) | (top << (m_order - 1));
+	}
+	return S_OK;
+}
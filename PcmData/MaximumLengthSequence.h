@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Windows.h>
+#include <vector>
+
+/*
+ * MaximumLengthSequence class
+ *
+ * Maximum length sequence(MLS) of order N, that is periodic sequence of 2^N - 1 bits generated by
+ * linear feedback shift register(LFSR), used as excitation to measure impulse response of a room or a device.
+ * Bit 0 of the sequence is played as +height and bit 1 as -height, so that circular autocorrelation of the sequence is
+ * 2^N - 1 at lag 0 and -1 at other lags.
+ *
+ * Bits are generated 64 bits per step by word-parallel LFSR.
+ * Squaring the feedback polynomial over GF(2) doubles the lags of the recurrence,
+ * so that the recurrence whose lags are multiplied until the minimum lag is 64 or more
+ * calculates a word of 64 new bits by XOR of words of preceding bits.
+ * Bits are expanded to samples by SimdKernel::expandBits().
+ *
+ * analyze() recovers impulse response from the response to the sequence by fast Hadamard transform(Borish and Angell),
+ * that takes O(L log L) instead of O(L^2) of circular cross-correlation.
+ */
+class MaximumLengthSequence
+{
+public:
+	static const int MinOrder = 2;
+	static const int MaxOrder = 24;
+
+	// Order out of range is limited to MinOrder ~ MaxOrder.
+	MaximumLengthSequence(int order);
+
+	int getOrder() const { return m_order; }
+	// Returns length of the sequence, that is 2^order - 1.
+	size_t getLength() const { return m_length; }
+	// Returns bit of the sequence at the index(< getLength()).
+	bool getBit(size_t index) const { return (m_bits[index / 64] >> (index % 64)) & 1; }
+	// Bit n of the sequence is bit (n % 64) of word (n / 64).
+	const UINT64* getBits() const { return m_bits.data(); }
+
+	// Generates count samples of the periodic sequence from the index.
+	//   dest[i] = bit((index + i) % length) ? -height : +height
+	void generate(float* dest, size_t count, size_t index, float height) const;
+
+	// Recovers impulse response from 1 period of response to the sequence at height 1.0.
+	// response[n] is the response at bit n of the sequence in steady state.
+	// impulseResponse[k] is response at lag k to unit impulse, that is aliased by the length of the sequence.
+	// Both buffers have getLength() samples, and may be the same buffer.
+	HRESULT analyze(float* impulseResponse, const float* response) const;
+
+protected:
+	const int m_order;
+	const size_t m_length;
+	// Bits of the sequence and following bits in the last word.
+	std::vector<UINT64> m_bits;
+
+	// Returns 64 bits from the bit position.
+	UINT64 getWord(size_t position) const;
+};
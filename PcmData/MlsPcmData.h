@@ -0,0 +1,41 @@
+#pragma once
+
+#include "PcmDataImpl.h"
+
+/*
+ * MlsPcmData template class derived from PcmData class.
+ *
+ * Copies maximum length sequence of the wave form passed to createPcmData() function.
+ * 1 period of the sequence(2^order - 1 frames) is the cycle data of PcmData class,
+ * so that level, dither, tiling, cursors and createPcmSample() work as same as other wave forms in SynthesisMode::CycleTable.
+ * All channels play the same sequence from the first bit.
+ */
+template<typename T>
+class MlsPcmData : public PcmData<T>
+{
+public:
+	MlsPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+		: PcmData<T>(samplesPerSec, channels, waveGenerator) {}
+
+	// Generates cycle data of the sequence.
+	// key and phaseShift are ignored, because frequency of the period is samplesPerSec / length of the sequence.
+	virtual void generate(float key, float level, float phaseShift) override;
+	// Channels are not independent.
+	virtual HRESULT generateChannels(const IPcmData::ToneParameter*) override { return E_NOTIMPL; }
+};
+
+template<typename T>
+void MlsPcmData<T>::generate(float, float level, float)
+{
+	auto& sequence = ((const MlsWaveForm&)this->m_waveGenerator->getWaveForm()).getSequence();
+	auto frames = sequence.getLength();
+	auto samplesPerCycle = frames * this->m_channels;
+	std::unique_ptr<typename PcmData<T>::CycleData> cycleData(
+		new typename PcmData<T>::CycleData(samplesPerCycle, this->getCycleDataSamples(samplesPerCycle), 1));
+	auto master = cycleData->master.get();
+	for(WORD channel = 0; channel < this->m_channels; channel++) {
+		sequence.generate(&master[channel * frames], frames, 0, 1.0f);
+	}
+
+	this->publish(std::move(cycleData), (float)((double)this->m_samplesPerSec / frames), level);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "PcmDataImpl.h"
+
+/*
+ * NoisePcmData template class derived from PcmData class.
+ *
+ * Synthesizes white or pink noise of the wave form passed to createPcmData() function, into the buffer passed to copyTo() method.
+ * Noise is a stream of counter-based random values calculated from the seed and the frame by NoiseWaveForm,
+ * so that the cost per block is fixed and the stream is reproduced from the seed,
+ * regardless of instruction set or how samples are split into copyTo() calls.
+ * Each channel has it's own seed derived from the seed of the wave form, so that channels are not correlated.
+ * The stream repeats every 2^32 frames.
+ *
+ * Seed is published to copyTo() without lock as cycle data of PcmData class.
+ * This class has no 1-cycle data, so that getSynthesisMode() returns SynthesisMode::Stream and
+ * createPcmSample() returns nullptr.
+ */
+template<typename T>
+class NoisePcmData : public PcmData<T>
+{
+public:
+	NoisePcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+		: PcmData<T>(samplesPerSec, channels, waveGenerator) {}
+
+	using PcmData<T>::copyTo;
+	// Restarts the stream of the noise.
+	// key is used only to calculate buffer size by getSampleBufferSize(). phaseShift is ignored.
+	virtual void generate(float key, float level, float phaseShift) override;
+	// Channels are not independent.
+	virtual HRESULT generateChannels(const IPcmData::ToneParameter*) override { return E_NOTIMPL; }
+
+	// Noise is not based on cycle data. So blockSize and exact period are ignored.
+	virtual HRESULT setBlockSize(size_t, size_t) override { return S_OK; }
+	virtual HRESULT setExactPeriod(size_t) override { return S_OK; }
+	// Noise always restarts when it is generated. So retune mode is ignored.
+	virtual HRESULT setRetuneMode(IPcmData::RetuneMode, size_t) override { return S_OK; }
+
+	virtual IPcmData::SynthesisMode getSynthesisMode() const override { return IPcmData::SynthesisMode::Stream; }
+	virtual size_t getCycleDataSize() const override { return 0; }
+	virtual bool isTiled() const override { return false; }
+
+	// Returns seed of the channel.
+	static UINT32 getChannelSeed(UINT32 seed, WORD channel) { return seed ^ (channel * 0x9e3779b9); }
+
+protected:
+	// Parameters calculated by generate() method and read by copyTo() method.
+	struct Parameters
+	{
+		Parameters(UINT32 seed, size_t generation) : seed(seed), generation(generation) {}
+
+		const UINT32 seed;
+		// Incremented by generate(). Position restarts when the generation is changed.
+		const size_t generation;
+	};
+
+	EpochPtr<Parameters> m_parameters;
+
+	// position.position of Position holds frame in the stream.
+	virtual HRESULT copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest) override;
+};
+
+template<typename T>
+HRESULT NoisePcmData<T>::copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest)
+{
+	typename EpochPtr<Parameters>::Reader parameters(m_parameters);
+
+	// Assert that data has been generated.
+	HR_ASSERT(parameters.get(), E_ILLEGAL_METHOD_CALL);
+
+	if(position.generation.load() != parameters->generation) {
+		position.generation = parameters->generation;
+		position.position = 0;
+	}
+
+	auto& waveForm = (const NoiseWaveForm&)this->m_waveGenerator->getWaveForm();
+	auto current = position.position.load();
+	const auto level = this->getLevel(parameters->generation);
+
+	// Noise of each channel is synthesized in the buffer on the stack as planar master and converted to samples.
+	float buffer[PcmData<T>::ConvertBufferSamples];
+	const size_t bufferFrames = PcmData<T>::ConvertBufferSamples / this->m_channels;
+	for(size_t frame = 0; frame < dest.frames; frame += bufferFrames) {
+		auto count = min(dest.frames - frame, bufferFrames);
+		for(WORD channel = 0; channel < this->m_channels; channel++) {
+			waveForm.generate(&buffer[channel * count], count, getChannelSeed(parameters->seed, channel), (UINT32)current, 1.0f);
+		}
+		this->put(position, level, dest, frame, buffer, count, count);
+		current += count;
+	}
+	position.position = current;
+	return S_OK;
+}
+
+template<typename T>
+void NoisePcmData<T>::generate(float key, float level, float)
+{
+	CriticalSection lock(this->m_cycleDataLock);
+
+	auto& waveForm = (const NoiseWaveForm&)this->m_waveGenerator->getWaveForm();
+	this->publishLevel(level, 0, ++this->m_generation);
+	m_parameters.publish(std::unique_ptr<Parameters>(new Parameters(waveForm.getSeed(), this->m_generation)));
+
+	// Samples per cycle is used to calculate buffer size for 1 cycle of the key.
+	this->m_samplesPerCycle = this->ceiling((size_t)(this->m_samplesPerSec * this->m_channels / key), this->m_channels);
+	this->m_cycles = 1;
+	this->m_frequencyError = 0;
+}
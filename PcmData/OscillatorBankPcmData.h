@@ -0,0 +1,186 @@
+#pragma once
+
+#include "OscillatorPcmData.h"
+#include "SimdKernel.h"
+
+#include <algorithm>
+
+/*
+ * OscillatorBankPcmData template class derived from OscillatorPcmData class.
+ *
+ * Sums oscillators of tones passed to generateTones() method, such as chords, multi-tone test signals and DTMF.
+ * Each oscillator has it's own key, level, phase and wave form, and the sum is written to all channels.
+ *
+ * Oscillators are held as Structure of Arrays and are summed by SimdKernel::oscillatorBank(),
+ * that advances 8 oscillators per instruction into float accumulator before the sum is converted to samples.
+ * Phase accumulator is 32-bit(2^32 = 1 cycle), that is accurate enough for audio frequency
+ * and fits in a lane with the phase of other oscillators.
+ *
+ * Phase of each oscillator is calculated from frames copied since the tones are generated,
+ * so that Position does not hold phases of hundreds of oscillators.
+ * As a result, oscillators restart from their phase when generate() or generateTones() is called.
+ * Wave tables are shared with OscillatorPcmData class, and are copied to contiguous array of the bank
+ * so that lanes read them by offset from the same base address.
+ */
+template<typename T>
+class OscillatorBankPcmData : public OscillatorPcmData<T>
+{
+public:
+	OscillatorBankPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+		: OscillatorPcmData<T>(samplesPerSec, channels, waveGenerator) {}
+
+	using PcmData<T>::copyTo;
+	// Generates single tone of the wave form passed to createPcmData(). phaseShift is ignored because channels are same.
+	virtual void generate(float key, float level, float phaseShift) override;
+	// Channels are not independent. Use OscillatorPcmData class.
+	virtual HRESULT generateChannels(const IPcmData::ToneParameter*) override { return E_NOTIMPL; }
+	virtual HRESULT generateTones(const IPcmData::ToneParameter* toneParameters, size_t tones) override;
+
+	virtual IPcmData::SynthesisMode getSynthesisMode() const override { return IPcmData::SynthesisMode::OscillatorBank; }
+
+	static_assert(OscillatorPcmData<T>::WaveTableBits == SimdKernel::OscillatorBankTableBits, "Wave table should be read by SimdKernel::oscillatorBank().");
+	static_assert((IPcmData::MaxTones % SimdKernel::OscillatorBankLanes) == 0, "Oscillators are padded to multiple of lanes.");
+
+protected:
+	// Oscillators calculated by generateTones() method and read by copyTo() method.
+	struct Bank
+	{
+		Bank(size_t oscillators, size_t tables, size_t generation)
+			: tables(new float[tables * (OscillatorPcmData<T>::WaveTableSize + 1)])
+			, tableOffsets(new UINT32[oscillators]()), phaseDeltas(new UINT32[oscillators]())
+			, phaseOffsets(new UINT32[oscillators]()), levels(new float[oscillators]())
+			, oscillators(oscillators), generation(generation) {}
+
+		// Wave tables used by the oscillators.
+		std::unique_ptr<float[]> tables;
+		// Offset of the wave table in tables, phase increment per frame, initial phase and level of each oscillator.
+		std::unique_ptr<UINT32[]> tableOffsets;
+		std::unique_ptr<UINT32[]> phaseDeltas;
+		std::unique_ptr<UINT32[]> phaseOffsets;
+		std::unique_ptr<float[]> levels;
+		// Number of oscillators that is padded to multiple of SimdKernel::OscillatorBankLanes with level 0.
+		const size_t oscillators;
+		// Incremented by generate() and generateTones(). Position restarts when the generation is changed.
+		const size_t generation;
+	};
+
+	EpochPtr<Bank> m_bank;
+
+	// position.position of Position holds frames copied since the generation.
+	virtual HRESULT copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest) override;
+
+	// Publishes the bank to copyTo(), and sets properties for the key of the first tone.
+	// Generates sum of tones with the level of setLevel().
+	HRESULT generateTones(const IPcmData::ToneParameter* toneParameters, size_t tones, float level);
+	void publish(std::unique_ptr<Bank>&& bank, float key, float level);
+};
+
+// Number of phase units in 1 cycle of the oscillator bank.
+static const double OscillatorBankPhaseCycle = 4294967296.0;		// 2^32
+
+template<typename T>
+HRESULT OscillatorBankPcmData<T>::copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest)
+{
+	typename EpochPtr<Bank>::Reader bank(m_bank);
+
+	// Assert that data has been generated.
+	HR_ASSERT(bank.get(), E_ILLEGAL_METHOD_CALL);
+
+	if(position.generation.load() != bank->generation) {
+		position.generation = bank->generation;
+		position.position = 0;
+	}
+
+	// Phase is exact after any number of frames, because 32-bit multiplication wraps around at 1 cycle.
+	auto elapsed = (UINT32)position.position.load();
+	UINT32 phases[IPcmData::MaxTones];
+	for(size_t i = 0; i < bank->oscillators; i++) {
+		phases[i] = bank->phaseOffsets[i] + (bank->phaseDeltas[i] * elapsed);
+	}
+
+	const auto level = this->getLevel(bank->generation);
+
+	// Sum of oscillators is synthesized in the buffer on the stack as master of all channels(stride = 0).
+	float buffer[PcmData<T>::ConvertBufferSamples];
+	for(size_t frame = 0; frame < dest.frames; frame += PcmData<T>::ConvertBufferSamples) {
+		auto count = min(dest.frames - frame, PcmData<T>::ConvertBufferSamples);
+		SimdKernel::oscillatorBank(buffer, count, bank->tables.get(), bank->tableOffsets.get(),
+									phases, bank->phaseDeltas.get(), bank->levels.get(), bank->oscillators);
+		this->put(position, level, dest, frame, buffer, 0, count);
+	}
+	position.position += dest.frames;
+	return S_OK;
+}
+
+template<typename T>
+void OscillatorBankPcmData<T>::generate(float key, float level, float)
+{
+	const IPcmData::ToneParameter tone = { key, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 };
+	generateTones(&tone, 1, level);
+}
+
+template<typename T>
+HRESULT OscillatorBankPcmData<T>::generateTones(const IPcmData::ToneParameter* toneParameters, size_t tones)
+{
+	return generateTones(toneParameters, tones, 1.0f);
+}
+
+template<typename T>
+HRESULT OscillatorBankPcmData<T>::generateTones(const IPcmData::ToneParameter* toneParameters, size_t tones, float level)
+{
+	HR_ASSERT(toneParameters, E_POINTER);
+	HR_ASSERT((0 < tones) && (tones <= IPcmData::MaxTones), E_INVALIDARG);
+
+	CriticalSection lock(this->m_cycleDataLock);
+
+	// Wave table of each tone and distinct wave tables to be copied to the bank.
+	const float* waveTables[IPcmData::MaxTones];
+	std::vector<const float*> distinctTables;
+	for(size_t i = 0; i < tones; i++) {
+		auto waveTable = this->getWaveTable(toneParameters[i]);
+		HR_ASSERT(waveTable, E_INVALIDARG);
+		waveTables[i] = waveTable;
+		if(std::find(distinctTables.begin(), distinctTables.end(), waveTable) == distinctTables.end()) {
+			distinctTables.push_back(waveTable);
+		}
+	}
+
+	const size_t tableSamples = OscillatorPcmData<T>::WaveTableSize + 1;
+	const auto lanes = SimdKernel::OscillatorBankLanes;
+	auto oscillators = ((tones + lanes - 1) / lanes) * lanes;
+	std::unique_ptr<Bank> bank(new Bank(oscillators, distinctTables.size(), ++this->m_generation));
+	for(size_t t = 0; t < distinctTables.size(); t++) {
+		memcpy(&bank->tables[t * tableSamples], distinctTables[t], tableSamples * sizeof(float));
+	}
+	for(size_t i = 0; i < tones; i++) {
+		auto& tone = toneParameters[i];
+		auto t = std::find(distinctTables.begin(), distinctTables.end(), waveTables[i]) - distinctTables.begin();
+		bank->tableOffsets[i] = (UINT32)(t * tableSamples);
+
+		// Frequency should be less than or equal to Nyquist frequency.
+		auto ratio = (double)tone.key / this->m_samplesPerSec;
+		if(0.5 < ratio) { ratio = 0.5; }
+		bank->phaseDeltas[i] = (UINT32)(ratio * OscillatorBankPhaseCycle);
+		bank->phaseOffsets[i] = (UINT32)(fmod(limit(tone.phase), 1.0) * OscillatorBankPhaseCycle);
+		bank->levels[i] = limit(tone.level);
+	}
+
+	publish(std::move(bank), toneParameters[0].key, level);
+	return S_OK;
+}
+
+template<typename T>
+void OscillatorBankPcmData<T>::publish(std::unique_ptr<Bank>&& bank, float key, float level)
+{
+	auto phaseDelta = bank->phaseDeltas[0];
+
+	// Publish new bank to copyTo() without blocking it.
+	this->publishLevel(level, 0, bank->generation);
+	m_bank.publish(std::move(bank));
+
+	// Samples per cycle is used to calculate buffer size for 1 cycle of the first tone.
+	this->m_samplesPerCycle = this->ceiling((size_t)(this->m_samplesPerSec * this->m_channels / key), this->m_channels);
+	this->m_cycles = 1;
+	// Error is caused by truncation of phase delta only.
+	this->m_frequencyError = (this->m_samplesPerSec * (double)phaseDelta / OscillatorBankPhaseCycle) - key;
+}
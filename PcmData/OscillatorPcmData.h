@@ -0,0 +1,239 @@
+#pragma once
+
+#include "PcmDataImpl.h"
+#include "WaveTableCache.h"
+#include "SimdKernel.h"
+
+#include <vector>
+#include <algorithm>
+
+/*
+ * OscillatorPcmData template class derived from PcmData class.
+ *
+ * Synthesizes samples into the buffer passed to copyTo() method from wave table,
+ * using 64-bit fixed-point phase accumulator(Numerically Controlled Oscillator).
+ * Frequency is exact at any samples/second, while PcmData class rounds 1-cycle to integer sample count.
+ *
+ * Wave table contains 1-cycle of float master generated by WaveForm and is interpolated linearly by SimdKernel::oscillator().
+ * Wave tables are shared with other objects through WaveTableCache.
+ * Band-limited wave form has mip levels, and the level is selected by the key so that harmonics above Nyquist frequency do not alias.
+ * Synthesized master is converted to samples with the level and dither as PcmData class.
+ * Phase is not reset by generate() method, so that the wave continues when key is changed.
+ * Each channel has it's own wave table, phase increment and level, so that generateChannels() accepts any key for each channel.
+ * Parameters are published to copyTo() without lock as cycle data of PcmData class.
+ */
+template<typename T>
+class OscillatorPcmData : public PcmData<T>
+{
+public:
+	OscillatorPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+		: PcmData<T>(samplesPerSec, channels, waveGenerator), m_waveTableBytes(0) {}
+
+	using PcmData<T>::copyTo;
+	virtual void generate(float key, float level, float phaseShift) override;
+	virtual HRESULT generateChannels(const IPcmData::ToneParameter* channelParameters) override;
+
+	// Wave table is not tiled. So blockSize is ignored.
+	virtual HRESULT setBlockSize(size_t, size_t) override { return S_OK; }
+	// Oscillator is not based on cycle data. So exact period is ignored.
+	virtual HRESULT setExactPeriod(size_t) override { return S_OK; }
+	// Oscillator always continues phase accumulator when generate() is called. So retune mode is ignored.
+	virtual HRESULT setRetuneMode(IPcmData::RetuneMode, size_t) override { return S_OK; }
+
+	virtual IPcmData::SynthesisMode getSynthesisMode() const override { return IPcmData::SynthesisMode::Oscillator; }
+	virtual size_t getCycleDataSize() const override { return m_waveTableBytes; }
+	virtual bool isTiled() const override { return false; }
+
+	// Sample count of wave table = 2^WaveTableBits.
+	static const int WaveTableBits = 11;
+	static const size_t WaveTableSize = 1 << WaveTableBits;
+
+	static_assert(WaveTableBits == WaveTableCache::TableBits, "Wave table is a level of WaveTableCache.");
+	static_assert(WaveTableBits == SimdKernel::OscillatorBankTableBits, "Wave table should be read by SimdKernel::oscillator().");
+
+protected:
+	// Wave tables of a wave form.
+	struct WaveTable
+	{
+		IPcmData::WaveFormType waveFormType;
+		float waveFormParameter;
+		// Mip levels of 1-cycle wave normalized to -1.0(LowValue) ~ +1.0(HighValue).
+		std::shared_ptr<const WaveTableCache::Tables> tables;
+	};
+
+	// Wave tables of wave forms used by the parameters published last, accessed in m_cycleDataLock.
+	// Wave tables are got from WaveTableCache only once for each wave form while the wave form is used,
+	// and are never changed or released while copyTo() reads them even if the cache evicts them.
+	std::vector<WaveTable> m_waveTables;
+	// Byte size of m_waveTables, read by getCycleDataSize() without lock.
+	std::atomic<size_t> m_waveTableBytes;
+
+	// Parameters calculated by generate() method and read by copyTo() method.
+	struct Parameters
+	{
+		Parameters(WORD channels)
+			: waveTables(new const float*[channels]()), phaseDeltas(new UINT64[channels]())
+			, phaseOffsets(new UINT64[channels]()), levels(new float[channels]()), generation(0) {}
+
+		// Wave table of each channel, that points to samples in m_waveTables.
+		std::unique_ptr<const float*[]> waveTables;
+		// Phase increment per frame of each channel.
+		std::unique_ptr<UINT64[]> phaseDeltas;
+		// Phase of each channel added to the phase held by Position.
+		std::unique_ptr<UINT64[]> phaseOffsets;
+		// Level of each channel applied to the wave table.
+		std::unique_ptr<float[]> levels;
+		// Incremented by generate() and generateChannels(). Phase continues regardless of the generation.
+		size_t generation;
+	};
+
+	EpochPtr<Parameters> m_parameters;
+
+	// Phase of each channel is held by Position of each cursor.
+	virtual HRESULT copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest) override;
+
+	// Returns wave table of the wave form of the parameter at the level for the key, getting tables if necessary.
+	// Returns nullptr if the wave form is unknown.
+	const float* getWaveTable(const IPcmData::ToneParameter& parameter);
+	// Returns phase increment per frame for the key.
+	UINT64 getPhaseDelta(float key) const;
+	// Publishes parameters to copyTo(), and sets properties for the key of channel 0.
+	void publish(std::unique_ptr<Parameters>&& parameters, float key, float level);
+};
+
+// Number of phase units in 1 cycle.
+static const double OscillatorPhaseCycle = 18446744073709551616.0;		// 2^64
+
+template<typename T>
+HRESULT OscillatorPcmData<T>::copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest)
+{
+	typename EpochPtr<Parameters>::Reader parameters(m_parameters);
+
+	// Assert that data has been generated.
+	HR_ASSERT(parameters.get(), E_ILLEGAL_METHOD_CALL);
+
+	const auto level = this->getLevel(parameters->generation);
+
+	// Master of each channel is synthesized in the buffer on the stack as planar master and converted to samples.
+	float buffer[PcmData<T>::ConvertBufferSamples];
+	const size_t bufferFrames = PcmData<T>::ConvertBufferSamples / this->m_channels;
+	for(size_t frame = 0; frame < dest.frames; frame += bufferFrames) {
+		auto count = min(dest.frames - frame, bufferFrames);
+		for(WORD channel = 0; channel < this->m_channels; channel++) {
+			auto phase = position.phases[channel].load();
+			auto phaseDelta = parameters->phaseDeltas[channel];
+			SimdKernel::oscillator(&buffer[channel * count], count, parameters->waveTables[channel],
+									phase + parameters->phaseOffsets[channel], phaseDelta, parameters->levels[channel]);
+			position.phases[channel] = phase + (phaseDelta * count);
+		}
+		this->put(position, level, dest, frame, buffer, count, count);
+	}
+	return S_OK;
+}
+
+template<typename T>
+void OscillatorPcmData<T>::generate(float key, float level, float phaseShift)
+{
+	CriticalSection lock(this->m_cycleDataLock);
+
+	// All channels use the wave form passed to createPcmData().
+	const IPcmData::ToneParameter parameter = { key, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 };
+	auto waveTable = getWaveTable(parameter);
+	auto phaseDelta = getPhaseDelta(key);
+	std::unique_ptr<Parameters> parameters(new Parameters(this->m_channels));
+	// Each channel leads the previous channel by (1 - phaseShift) cycle as same as PcmData class.
+	for(WORD channel = 0; channel < this->m_channels; channel++) {
+		parameters->waveTables[channel] = waveTable;
+		parameters->phaseDeltas[channel] = phaseDelta;
+		parameters->phaseOffsets[channel] = (UINT64)(fmod(channel * (1.0 - limit(phaseShift)), 1.0) * OscillatorPhaseCycle);
+		parameters->levels[channel] = 1.0f;
+	}
+
+	publish(std::move(parameters), key, level);
+}
+
+template<typename T>
+HRESULT OscillatorPcmData<T>::generateChannels(const IPcmData::ToneParameter* channelParameters)
+{
+	HR_ASSERT(channelParameters, E_POINTER);
+
+	CriticalSection lock(this->m_cycleDataLock);
+
+	std::unique_ptr<Parameters> parameters(new Parameters(this->m_channels));
+	for(WORD channel = 0; channel < this->m_channels; channel++) {
+		auto& parameter = channelParameters[channel];
+		auto waveTable = getWaveTable(parameter);
+		HR_ASSERT(waveTable, E_INVALIDARG);
+		parameters->waveTables[channel] = waveTable;
+		parameters->phaseDeltas[channel] = getPhaseDelta(parameter.key);
+		parameters->phaseOffsets[channel] = (UINT64)(fmod(limit(parameter.phase), 1.0) * OscillatorPhaseCycle);
+		parameters->levels[channel] = limit(parameter.level);
+	}
+
+	publish(std::move(parameters), channelParameters[0].key, 1.0f);
+	return S_OK;
+}
+
+template<typename T>
+const float* OscillatorPcmData<T>::getWaveTable(const IPcmData::ToneParameter& parameter)
+{
+	auto level = WaveTableCache::getLevel(parameter.key, this->m_samplesPerSec);
+	auto isDefault = (parameter.waveFormType == IPcmData::WaveFormType::Unknown);
+	for(auto& waveTable : m_waveTables) {
+		if((waveTable.waveFormType == parameter.waveFormType) && (isDefault || (waveTable.waveFormParameter == parameter.waveFormParameter))) {
+			return waveTable.tables->getLevel(level);
+		}
+	}
+
+	std::unique_ptr<IWaveGenerator> holder;
+	auto waveForm = this->getWaveForm(parameter, holder);
+	if(!waveForm) { return nullptr; }
+
+	m_waveTables.push_back({ parameter.waveFormType, parameter.waveFormParameter, WaveTableCache::getInstance().getTables(*waveForm) });
+	return m_waveTables.back().tables->getLevel(level);
+}
+
+template<typename T>
+UINT64 OscillatorPcmData<T>::getPhaseDelta(float key) const
+{
+	// Frequency should be less than or equal to Nyquist frequency.
+	auto ratio = (double)key / this->m_samplesPerSec;
+	if(0.5 < ratio) { ratio = 0.5; }
+	return (UINT64)(ratio * OscillatorPhaseCycle);
+}
+
+template<typename T>
+void OscillatorPcmData<T>::publish(std::unique_ptr<Parameters>&& parameters, float key, float level)
+{
+	auto phaseDelta = parameters->phaseDeltas[0];
+
+	// Publish new parameters to copyTo() without blocking it.
+	parameters->generation = ++this->m_generation;
+	this->publishLevel(level, 0, parameters->generation);
+	m_parameters.publish(std::move(parameters));
+
+	// No reader refers to the previous parameters any more. So wave tables that are not used by any channel are released.
+	auto current = m_parameters.get();
+	auto isUsed = [&](const WaveTable& waveTable) {
+		auto& tables = *waveTable.tables;
+		auto first = tables.getLevel(0);
+		auto last = tables.getLevel(tables.getLevels() - 1);
+		for(WORD channel = 0; channel < this->m_channels; channel++) {
+			auto table = current->waveTables[channel];
+			if((first <= table) && (table <= last)) { return true; }
+		}
+		return false;
+	};
+	m_waveTables.erase(std::remove_if(m_waveTables.begin(), m_waveTables.end(), [&](const WaveTable& waveTable) { return !isUsed(waveTable); }), m_waveTables.end());
+	size_t bytes = 0;
+	for(auto& waveTable : m_waveTables) {
+		bytes += waveTable.tables->getBytes();
+	}
+	m_waveTableBytes = bytes;
+
+	// Samples per cycle is used to calculate buffer size for 1 cycle.
+	this->m_samplesPerCycle = this->ceiling((size_t)(this->m_samplesPerSec * this->m_channels / key), this->m_channels);
+	this->m_cycles = 1;
+	// Error is caused by truncation of phase delta only.
+	this->m_frequencyError = (this->m_samplesPerSec * (double)phaseDelta / OscillatorPhaseCycle) - key;
+}
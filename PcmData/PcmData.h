@@ -1,11 +1,30 @@
 #pragma once
 
 #include "framework.h"
+#include <mmreg.h>
 #include <memory>
 #include <vector>
 
 class IWaveGenerator;
 
+/*
+ * IPcmDataCursor interface.
+ *
+ * Reads data generated by IPcmData::generate() from it's own position.
+ * Cursors share the data of IPcmData and read it without lock.
+ * Cursor should be destroyed before IPcmData object that created it.
+ */
+class IPcmDataCursor
+{
+public:
+	virtual ~IPcmDataCursor() {}
+
+	// Same as IPcmData::copyTo() except that the position is not shared with IPcmData and other cursors.
+	virtual HRESULT copyTo(void* destBuffer, size_t destSize) = 0;
+	// Same as IPcmData::copyToPlanar() except that the position is not shared with IPcmData and other cursors.
+	virtual HRESULT copyToPlanar(void* const* channelBuffers, size_t frames) = 0;
+};
+
 /*
  * IPcmData interface.
  */
@@ -20,6 +39,9 @@ public:
 		PCM_16bits,		// INT16, WAVE_FORMAT_PCM
 		PCM_24bits,		// INT24, WAVE_FORMAT_PCM
 		IEEE_Float,		// float, WAVE_FORMAT_IEEE_FLOAT
+		PCM_24bits_in_32,	// INT24in32, WAVE_FORMAT_EXTENSIBLE(KSDATAFORMAT_SUBTYPE_PCM, wValidBitsPerSample = 24)
+		PCM_32bits,		// INT32, WAVE_FORMAT_PCM
+		IEEE_Double,	// double, WAVE_FORMAT_IEEE_FLOAT
 	};
 
 	enum class WaveFormType {
@@ -27,27 +49,165 @@ public:
 		SquareWave,
 		SineWave,
 		TriangleWave,
+		DTMF,			// Dual tone of a digit of Dual-Tone Multi-Frequency signalling.
+		MF,				// Dual tone of a digit of Multi-Frequency signalling(R1).
+		WhiteNoise,		// Noise of uniform distribution and flat spectrum.
+		PinkNoise,		// Noise whose spectrum falls 3dB per octave.
+		MLS,			// Maximum length sequence to measure impulse response.
+		BandLimitedSquareWave,		// Square wave whose edges are corrected by PolyBLEP to cut aliasing.
+		BandLimitedTriangleWave,	// Triangle wave whose corners are corrected by PolyBLAMP(PolyBLEP for Sawtooth).
+	};
+
+	enum class SynthesisMode {
+		CycleTable,		// Copies 1-cycle data that has integer sample count.
+		Oscillator,		// Synthesizes samples from wave table using phase accumulator. Frequency is exact.
+		OscillatorBank,	// Sums many oscillators of tones passed to generateTones(), such as chords and multi-tone signals.
+		Sweep,			// Synthesizes sine wave that sweeps frequency(chirp) by generateSweep(). Wave form is not used.
+		Stream,			// Renders stream of the wave form that has no cycle data, such as digits of signalling and noise.
+						// Selected by the wave form regardless of the synthesis mode passed to createPcmData().
 	};
 
 	// Generates 1-cycle PCM data
 	// Data to be generated depends on IWaveGenerator object passed to the createPcmData() function.
 	virtual void generate(float key, float level = 0.2f, float phaseShift = 0) = 0;
 
+	// Parameters of each channel passed to generateChannels() method, or each tone passed to generateTones() method.
+	struct ToneParameter
+	{
+		float key;
+		float level;
+		float phase;				// Phase of the tone at the beginning, 0.0 ~ 1.0(1 cycle).
+		WaveFormType waveFormType;	// WaveFormType::Unknown means the wave form passed to createPcmData() function.
+		float waveFormParameter;	// Parameter passed to the factory. See PcmDataEnumerator::WaveFormProperty.
+	};
+
+	// Generates PCM data of each channel independently.
+	// channelParameters points to getChannels() parameters.
+	// Level of each channel is applied to the wave form, and the level of setLevel() is set to 1.0.
+	// SynthesisMode::CycleTable requires the same key for all channels, because channels share cycle data.
+	// SynthesisMode::Oscillator accepts different keys, such as binaural beats.
+	virtual HRESULT generateChannels(const ToneParameter* channelParameters) = 0;
+
+	// Generates sum of tones written to all channels.
+	// Level of each tone is applied to the wave form, and the level of setLevel() is set to 1.0.
+	// Sum of the levels should be 1.0 or less to avoid clipping of integer samples.
+	// Available in SynthesisMode::OscillatorBank only, and up to MaxTones tones. Otherwise returns E_NOTIMPL or E_INVALIDARG.
+	virtual HRESULT generateTones(const ToneParameter* toneParameters, size_t tones) = 0;
+
+	static const size_t MaxTones = 1024;
+
+	// Generates dual tones of digits, each of them is followed by the pause.
+	// Characters of digits are listed by PcmDataEnumerator::getDigits(), and ',' is a pause of (tone + pause) length.
+	// Digits are repeated by copyTo(). Use getSampleBufferSize(0) to get the size of all digits.
+	// level is set as same as generate(), and sum of 2 tones at level 1.0 does not exceed full scale.
+	// Available for WaveFormType::DTMF and WaveFormType::MF only. Otherwise returns E_NOTIMPL.
+	virtual HRESULT generateDigits(const char* digits, size_t toneMilliseconds = DefaultDigitToneMilliseconds,
+									size_t pauseMilliseconds = DefaultDigitPauseMilliseconds, float level = 0.2f) = 0;
+
+	static const size_t DefaultDigitToneMilliseconds = 70;
+	static const size_t DefaultDigitPauseMilliseconds = 70;
+
+	enum class SweepLaw {
+		Linear,			// Frequency changes by the same Hz per second.
+		Logarithmic,	// Frequency changes by the same octaves per second(exponential sweep).
+	};
+
+	// Generates sine wave that sweeps from startKey to endKey in milliseconds, and the sweep is repeated by copyTo().
+	// Phase is calculated from the beginning of the sweep analytically, so that any length is synthesized in constant memory.
+	// Use getSampleBufferSize(0) to get the size of whole sweep.
+	// Available in SynthesisMode::Sweep only. Otherwise returns E_NOTIMPL.
+	virtual HRESULT generateSweep(float startKey, float endKey, size_t milliseconds,
+									SweepLaw law = SweepLaw::Logarithmic, float level = 0.2f) = 0;
+
 	// Copies data generated by generate() method to the buffer.
 	// Pass value returned by getSampleBufferSize() method as destSize parameter.
 	virtual HRESULT copyTo(void* destBuffer, size_t destSize) = 0;
 
+	// Copies data generated by generate() method to the buffers of each channel(Planar, non-interleaved).
+	// channelBuffers points to getChannels() buffers, each of them has `frames` samples.
+	// Position is shared with copyTo() method. So the data continues whichever method is called.
+	// Samples are same as copyTo() except for dither noise.
+	virtual HRESULT copyToPlanar(void* const* channelBuffers, size_t frames) = 0;
+
+	// Creates cursor that has it's own position to copy data.
+	// copyTo() method of IPcmData uses default cursor owned by IPcmData object.
+	virtual std::unique_ptr<IPcmDataCursor> createCursor() = 0;
+
+	// Declares byte size of the buffer that will be passed to copyTo() method repeatedly.
+	// If blockSize > 0, 1-cycle data is followed by it's copy of blockSize(Tiled cycle data)
+	// so that copyTo() of blockSize or smaller is performed by single memcpy().
+	// If size of tiled cycle data exceeds maxTiledDataSize, cycle data is not tiled and copyTo() copies each cycle.
+	// Pass value returned by getSampleBufferSize() method as blockSize parameter.
+	virtual HRESULT setBlockSize(size_t blockSize, size_t maxTiledDataSize = DefaultMaxTiledDataSize) = 0;
+
+	static const size_t DefaultMaxTiledDataSize = 0x100000;
+
+	// Enables cycle data that contains whole number of cycles in the smallest sample count(Exact period).
+	// For example, 2205 samples hold exactly 22 cycles of 440Hz at 44100 samples/second.
+	// If byte size of the exact period exceeds maxCycleDataSize, nearest period within maxCycleDataSize is used.
+	// If the period is not more accurate than 1-cycle data, 1-cycle data is used.
+	// maxCycleDataSize == 0 disables exact period.
+	// Takes effect when generate() method is called next time.
+	virtual HRESULT setExactPeriod(size_t maxCycleDataSize = DefaultMaxExactPeriodDataSize) = 0;
+
+	static const size_t DefaultMaxExactPeriodDataSize = 0x100000;
+
+	enum class RetuneMode {
+		Reset,			// copyTo() restarts from the beginning of data generated by generate().
+		Continuous,		// copyTo() continues from the same phase in new data with crossfade.
+	};
+
+	// Sets how copyTo() continues when generate() is called during playback.
+	// In RetuneMode::Continuous, old data fades out and new data fades in during crossfadeFrames.
+	// crossfadeFrames == 0 means that new data starts without crossfade.
+	// Takes effect when generate() method is called next time.
+	virtual HRESULT setRetuneMode(RetuneMode mode, size_t crossfadeFrames = DefaultCrossfadeFrames) = 0;
+
+	static const size_t DefaultCrossfadeFrames = 256;
+
+	// Changes level of data copied by copyTo() without generating data again.
+	// Level changes linearly in rampFrames to avoid click noise. rampFrames == 0 changes level immediately.
+	// generate() method also sets the level immediately.
+	virtual HRESULT setLevel(float level, size_t rampFrames = DefaultLevelRampFrames) = 0;
+
+	static const size_t DefaultLevelRampFrames = 256;
+
+	enum class DitherType {
+		None,
+		TPDF,			// Triangular PDF noise of +-1 LSB added before samples are rounded to integer.
+	};
+
+	// Sets dither applied when float master is converted to integer samples.
+	// Samples at full scale without dither are converted once by generate(), and are copied as they are.
+	// Otherwise copyTo() converts the master with the level and dither every time.
+	// Dither has no effect on IEEE float sample.
+	virtual HRESULT setDither(DitherType dither) = 0;
+
+	virtual SynthesisMode getSynthesisMode() const = 0;
 	virtual SampleDataType getSampleDataType() const = 0;
 	virtual const char* getSampleDataTypeName() const = 0;
 	virtual WORD getFormatTag() const = 0;
 	virtual WaveFormType getWaveFormType() const = 0;
 	virtual const char* getWaveFormTypeName() const = 0;
 	virtual WORD getBlockAlign() const = 0;
-	virtual WORD getBitsPerSample() const = 0;
+	virtual WORD getBitsPerSample() const = 0;			// Bits of sample container.
+	virtual WORD getValidBitsPerSample() const = 0;	// Bits of sample value in the container.
 	virtual DWORD getSamplesPerSec() const = 0;
 	virtual WORD getChannels() const = 0;
+	// Maximum channel count accepted by createPcmData().
+	static const WORD MaxChannels = 256;
 	virtual const char* getSampleTypeName() const = 0;
 	virtual size_t getSamplesPerCycle() const = 0;		// Available after generate() method is called.
+	virtual size_t getCycleDataSize() const = 0;		// Byte size of (tiled) cycle data. Available after generate() method is called.
+	virtual bool isTiled() const = 0;					// Available after generate() method is called.
+	virtual size_t getCycles() const = 0;				// Number of cycles in cycle data. Available after generate() method is called.
+	virtual double getFrequencyError() const = 0;		// Actual frequency - key(Hz). Available after generate() method is called.
+
+	// Returns format of the samples.
+	// If getFormatTag() returns WAVE_FORMAT_EXTENSIBLE, whole WAVEFORMATEXTENSIBLE is set.
+	// Otherwise WAVEFORMATEX(Format member) is set and it's cbSize is 0.
+	// Pass &format.Format and (sizeof(WAVEFORMATEX) + format.Format.cbSize) to APIs that take WAVEFORMATEX.
+	virtual void getWaveFormat(WAVEFORMATEXTENSIBLE& format) const = 0;
 
 	// Returns required buffer size in bytes for given duration(mSec).
 	// If duration == 0:
@@ -65,16 +225,23 @@ public:
 		const char* name;
 		WORD formatTag;
 		WORD bitsPerSample;
+		WORD validBitsPerSample;
 	};
 
 	enum class FactoryParameter {
 		None,
-		Duty,			// SquareWaveGenerator
-		PeakPosition,	// TriangleWaveGenerator
+		Duty,			// SquareWaveForm, including band-limited one.
+		PeakPosition,	// TriangleWaveForm, including band-limited one.
+		Digit,			// DualToneWaveForm: Index of the digit in getDigits().
+		Seed,			// NoiseWaveForm: Seed of the random values, that is converted to UINT32.
+		Order,			// MlsWaveForm: Order of the sequence, whose length is 2^Order - 1.
 	};
 
 	static const float DefaultDuty;
 	static const float DefaultPeakPosition;
+	static const float DefaultDigit;
+	static const float DefaultSeed;
+	static const float DefaultOrder;
 
 	using Factory = IWaveGenerator* (*)(IPcmData::SampleDataType, float);
 
@@ -86,18 +253,40 @@ public:
 		float defaultParameter;
 	};
 
+	struct SynthesisModeProperty {
+		IPcmData::SynthesisMode mode;
+		const char* name;
+	};
+
 	static const std::vector<SampleDataTypeProperty>& getSampleDatatypeProperties();
 	static const std::vector<WaveFormProperty>& getWaveFormProperties();
+	static const std::vector<SynthesisModeProperty>& getSynthesisModeProperties();
 
 	static const SampleDataTypeProperty& getSampleDataTypeProperty(IPcmData::SampleDataType);
 	static const WaveFormProperty& getWaveFormProperty(IPcmData::WaveFormType);
+	static const SynthesisModeProperty& getSynthesisModeProperty(IPcmData::SynthesisMode);
+
+	// Returns characters of digits of WaveFormType::DTMF or WaveFormType::MF, or nullptr for other wave forms.
+	static const char* getDigits(IPcmData::WaveFormType);
 };
 
 // Factory functions.
-std::shared_ptr<IPcmData> createPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator);
+// IPcmData of WaveFormType::DTMF and WaveFormType::MF renders digits from tone tables regardless of synthesisMode.
+// IPcmData of WaveFormType::WhiteNoise and WaveFormType::PinkNoise synthesizes noise stream regardless of synthesisMode.
+// IPcmData of WaveFormType::MLS copies 1 period of the sequence as cycle data regardless of synthesisMode.
+// createPcmData() returns nullptr if channels is 0 or exceeds IPcmData::MaxChannels.
+std::shared_ptr<IPcmData> createPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator,
+											IPcmData::SynthesisMode synthesisMode = IPcmData::SynthesisMode::CycleTable);
 IWaveGenerator* createSquareWaveGenerator(IPcmData::SampleDataType sampleDataType, float duty = PcmDataEnumerator::DefaultDuty);
 IWaveGenerator* createSineWaveGenerator(IPcmData::SampleDataType sampleDataType, float notUsed = 0);
 IWaveGenerator* createTriangleWaveGenerator(IPcmData::SampleDataType sampleDataType, float peakPosition = PcmDataEnumerator::DefaultPeakPosition);
+IWaveGenerator* createBandLimitedSquareWaveGenerator(IPcmData::SampleDataType sampleDataType, float duty = PcmDataEnumerator::DefaultDuty);
+IWaveGenerator* createBandLimitedTriangleWaveGenerator(IPcmData::SampleDataType sampleDataType, float peakPosition = PcmDataEnumerator::DefaultPeakPosition);
+IWaveGenerator* createDtmfWaveGenerator(IPcmData::SampleDataType sampleDataType, float digit = PcmDataEnumerator::DefaultDigit);
+IWaveGenerator* createMfWaveGenerator(IPcmData::SampleDataType sampleDataType, float digit = PcmDataEnumerator::DefaultDigit);
+IWaveGenerator* createWhiteNoiseGenerator(IPcmData::SampleDataType sampleDataType, float seed = PcmDataEnumerator::DefaultSeed);
+IWaveGenerator* createPinkNoiseGenerator(IPcmData::SampleDataType sampleDataType, float seed = PcmDataEnumerator::DefaultSeed);
+IWaveGenerator* createMlsWaveGenerator(IPcmData::SampleDataType sampleDataType, float order = PcmDataEnumerator::DefaultOrder);
 
 
 class DoNotCopy
@@ -1,4 +1,10 @@
 #include "PcmDataImpl.h"
+#include "OscillatorPcmData.h"
+#include "OscillatorBankPcmData.h"
+#include "DualTonePcmData.h"
+#include "SweepPcmData.h"
+#include "NoisePcmData.h"
+#include "MlsPcmData.h"
 #include "INT24.h"
 
 #pragma region Declaration for available T types.
@@ -7,54 +13,118 @@ template<> const IPcmData::SampleDataType WaveGenerator<UINT8>::SampleDataType =
 template<> const IPcmData::SampleDataType WaveGenerator<INT16>::SampleDataType = IPcmData::SampleDataType::PCM_16bits;
 template<> const IPcmData::SampleDataType WaveGenerator<INT24>::SampleDataType = IPcmData::SampleDataType::PCM_24bits;
 template<> const IPcmData::SampleDataType WaveGenerator<float>::SampleDataType = IPcmData::SampleDataType::IEEE_Float;
+template<> const IPcmData::SampleDataType WaveGenerator<INT24in32>::SampleDataType = IPcmData::SampleDataType::PCM_24bits_in_32;
+template<> const IPcmData::SampleDataType WaveGenerator<INT32>::SampleDataType = IPcmData::SampleDataType::PCM_32bits;
+template<> const IPcmData::SampleDataType WaveGenerator<double>::SampleDataType = IPcmData::SampleDataType::IEEE_Double;
 
 template<> const char* WaveGenerator<UINT8>::SampleDataTypeName = "PCM 8bit";
 template<> const char* WaveGenerator<INT16>::SampleDataTypeName = "PCM 16bit";
 template<> const char* WaveGenerator<INT24>::SampleDataTypeName = "PCM 24bit";
 template<> const char* WaveGenerator<float>::SampleDataTypeName = "IEEE float 32bit";
+template<> const char* WaveGenerator<INT24in32>::SampleDataTypeName = "PCM 24bit in 32bit";
+template<> const char* WaveGenerator<INT32>::SampleDataTypeName = "PCM 32bit";
+template<> const char* WaveGenerator<double>::SampleDataTypeName = "IEEE float 64bit";
 
 const char* IWaveGenerator::SquareWaveFormTypeName = "Square Wave";
 const char* IWaveGenerator::SineWaveFormTypeName = "Sine Wave";
 const char* IWaveGenerator::TriangleWaveFormTypeName = "Triangle Wave";
+const char* IWaveGenerator::BandLimitedSquareWaveFormTypeName = "Band Limited Square Wave";
+const char* IWaveGenerator::BandLimitedTriangleWaveFormTypeName = "Band Limited Triangle Wave";
+const char* IWaveGenerator::DtmfWaveFormTypeName = "DTMF";
+const char* IWaveGenerator::MfWaveFormTypeName = "MF R1";
+const char* IWaveGenerator::WhiteNoiseWaveFormTypeName = "White Noise";
+const char* IWaveGenerator::PinkNoiseWaveFormTypeName = "Pink Noise";
+const char* IWaveGenerator::MlsWaveFormTypeName = "MLS";
 
 template<> const WORD PcmData<UINT8>::FormatTag = WAVE_FORMAT_PCM;
+template<> const WORD PcmData<UINT8>::ValidBitsPerSample = 8;
 template<> const UINT8 PcmData<UINT8>::HighValue = 0xc0;
 template<> const UINT8 PcmData<UINT8>::ZeroValue = 0x80;
 template<> const UINT8 PcmData<UINT8>::LowValue = 0x40;
 
 template<> const WORD PcmData<INT16>::FormatTag = WAVE_FORMAT_PCM;
+template<> const WORD PcmData<INT16>::ValidBitsPerSample = 16;
 template<> const INT16 PcmData<INT16>::HighValue = 0x6000;
 template<> const INT16 PcmData<INT16>::ZeroValue = 0;
 template<> const INT16 PcmData<INT16>::LowValue = -0x6000;
 
 template<> const WORD PcmData<INT24>::FormatTag = WAVE_FORMAT_PCM;
+template<> const WORD PcmData<INT24>::ValidBitsPerSample = 24;
 template<> const INT24 PcmData<INT24>::HighValue = 0x600000;
 template<> const INT24 PcmData<INT24>::ZeroValue = 0;
 template<> const INT24 PcmData<INT24>::LowValue = -0x600000;
 
 template<> const WORD PcmData<float>::FormatTag = WAVE_FORMAT_IEEE_FLOAT;
+template<> const WORD PcmData<float>::ValidBitsPerSample = 32;
 template<> const float PcmData<float>::HighValue = 0.8f;
 template<> const float PcmData<float>::ZeroValue = 0.0f;
 template<> const float PcmData<float>::LowValue = -0.8f;
 
+template<> const WORD PcmData<INT24in32>::FormatTag = WAVE_FORMAT_EXTENSIBLE;
+template<> const WORD PcmData<INT24in32>::ValidBitsPerSample = 24;
+template<> const INT24in32 PcmData<INT24in32>::HighValue = 0x600000;
+template<> const INT24in32 PcmData<INT24in32>::ZeroValue = 0;
+template<> const INT24in32 PcmData<INT24in32>::LowValue = -0x600000;
+
+template<> const WORD PcmData<INT32>::FormatTag = WAVE_FORMAT_PCM;
+template<> const WORD PcmData<INT32>::ValidBitsPerSample = 32;
+template<> const INT32 PcmData<INT32>::HighValue = 0x60000000;
+template<> const INT32 PcmData<INT32>::ZeroValue = 0;
+template<> const INT32 PcmData<INT32>::LowValue = -0x60000000;
+
+template<> const WORD PcmData<double>::FormatTag = WAVE_FORMAT_IEEE_FLOAT;
+template<> const WORD PcmData<double>::ValidBitsPerSample = 64;
+template<> const double PcmData<double>::HighValue = 0.8;
+template<> const double PcmData<double>::ZeroValue = 0.0;
+template<> const double PcmData<double>::LowValue = -0.8;
+
+template<> const float PcmData<UINT8>::Height = (float)((double)PcmData<UINT8>::HighValue - (double)PcmData<UINT8>::ZeroValue);
+template<> const float PcmData<INT16>::Height = (float)((double)PcmData<INT16>::HighValue - (double)PcmData<INT16>::ZeroValue);
+template<> const float PcmData<INT24>::Height = (float)((double)PcmData<INT24>::HighValue - (double)PcmData<INT24>::ZeroValue);
+template<> const float PcmData<float>::Height = (float)((double)PcmData<float>::HighValue - (double)PcmData<float>::ZeroValue);
+template<> const float PcmData<INT24in32>::Height = (float)((double)PcmData<INT24in32>::HighValue - (double)PcmData<INT24in32>::ZeroValue);
+template<> const float PcmData<INT32>::Height = (float)((double)PcmData<INT32>::HighValue - (double)PcmData<INT32>::ZeroValue);
+template<> const float PcmData<double>::Height = (float)((double)PcmData<double>::HighValue - (double)PcmData<double>::ZeroValue);
+
 #pragma endregion
 
 #pragma region Implementation of PcmDataEnumerator
 
 /*static*/ const float PcmDataEnumerator::DefaultDuty = 0.5f;
 /*static*/ const float PcmDataEnumerator::DefaultPeakPosition = 0.25f;
+/*static*/ const float PcmDataEnumerator::DefaultDigit = 0;
+/*static*/ const float PcmDataEnumerator::DefaultSeed = 1;
+/*static*/ const float PcmDataEnumerator::DefaultOrder = 16;
 
 static const PcmDataEnumerator::SampleDataTypeProperty sampleDataTypeProperties[] = {
-	{ WaveGenerator<UINT8>::SampleDataType, WaveGenerator<UINT8>::SampleDataTypeName, PcmData<UINT8>::FormatTag, sizeof(UINT8) * 8 },
-	{ WaveGenerator<INT16>::SampleDataType, WaveGenerator<INT16>::SampleDataTypeName, PcmData<INT16>::FormatTag, sizeof(INT16) * 8 },
-	{ WaveGenerator<INT24>::SampleDataType, WaveGenerator<INT24>::SampleDataTypeName, PcmData<INT24>::FormatTag, sizeof(INT24) * 8 },
-	{ WaveGenerator<float>::SampleDataType, WaveGenerator<float>::SampleDataTypeName, PcmData<float>::FormatTag, sizeof(float) * 8 },
+	{ WaveGenerator<UINT8>::SampleDataType, WaveGenerator<UINT8>::SampleDataTypeName, PcmData<UINT8>::FormatTag, sizeof(UINT8) * 8, PcmData<UINT8>::ValidBitsPerSample },
+	{ WaveGenerator<INT16>::SampleDataType, WaveGenerator<INT16>::SampleDataTypeName, PcmData<INT16>::FormatTag, sizeof(INT16) * 8, PcmData<INT16>::ValidBitsPerSample },
+	{ WaveGenerator<INT24>::SampleDataType, WaveGenerator<INT24>::SampleDataTypeName, PcmData<INT24>::FormatTag, sizeof(INT24) * 8, PcmData<INT24>::ValidBitsPerSample },
+	{ WaveGenerator<float>::SampleDataType, WaveGenerator<float>::SampleDataTypeName, PcmData<float>::FormatTag, sizeof(float) * 8, PcmData<float>::ValidBitsPerSample },
+	{ WaveGenerator<INT24in32>::SampleDataType, WaveGenerator<INT24in32>::SampleDataTypeName, PcmData<INT24in32>::FormatTag, sizeof(INT24in32) * 8, PcmData<INT24in32>::ValidBitsPerSample },
+	{ WaveGenerator<INT32>::SampleDataType, WaveGenerator<INT32>::SampleDataTypeName, PcmData<INT32>::FormatTag, sizeof(INT32) * 8, PcmData<INT32>::ValidBitsPerSample },
+	{ WaveGenerator<double>::SampleDataType, WaveGenerator<double>::SampleDataTypeName, PcmData<double>::FormatTag, sizeof(double) * 8, PcmData<double>::ValidBitsPerSample },
 };
 
 static const PcmDataEnumerator::WaveFormProperty waveGeneratorProperties[] = {
 	{ IPcmData::WaveFormType::SquareWave, IWaveGenerator::SquareWaveFormTypeName, createSquareWaveGenerator, PcmDataEnumerator::FactoryParameter::Duty, PcmDataEnumerator::DefaultDuty },
 	{ IPcmData::WaveFormType::SineWave, IWaveGenerator::SineWaveFormTypeName, createSineWaveGenerator, PcmDataEnumerator::FactoryParameter::None },
 	{ IPcmData::WaveFormType::TriangleWave, IWaveGenerator::TriangleWaveFormTypeName, createTriangleWaveGenerator, PcmDataEnumerator::FactoryParameter::PeakPosition, PcmDataEnumerator::DefaultPeakPosition },
+	{ IPcmData::WaveFormType::BandLimitedSquareWave, IWaveGenerator::BandLimitedSquareWaveFormTypeName, createBandLimitedSquareWaveGenerator, PcmDataEnumerator::FactoryParameter::Duty, PcmDataEnumerator::DefaultDuty },
+	{ IPcmData::WaveFormType::BandLimitedTriangleWave, IWaveGenerator::BandLimitedTriangleWaveFormTypeName, createBandLimitedTriangleWaveGenerator, PcmDataEnumerator::FactoryParameter::PeakPosition, PcmDataEnumerator::DefaultPeakPosition },
+	{ IPcmData::WaveFormType::DTMF, IWaveGenerator::DtmfWaveFormTypeName, createDtmfWaveGenerator, PcmDataEnumerator::FactoryParameter::Digit, PcmDataEnumerator::DefaultDigit },
+	{ IPcmData::WaveFormType::MF, IWaveGenerator::MfWaveFormTypeName, createMfWaveGenerator, PcmDataEnumerator::FactoryParameter::Digit, PcmDataEnumerator::DefaultDigit },
+	{ IPcmData::WaveFormType::WhiteNoise, IWaveGenerator::WhiteNoiseWaveFormTypeName, createWhiteNoiseGenerator, PcmDataEnumerator::FactoryParameter::Seed, PcmDataEnumerator::DefaultSeed },
+	{ IPcmData::WaveFormType::PinkNoise, IWaveGenerator::PinkNoiseWaveFormTypeName, createPinkNoiseGenerator, PcmDataEnumerator::FactoryParameter::Seed, PcmDataEnumerator::DefaultSeed },
+	{ IPcmData::WaveFormType::MLS, IWaveGenerator::MlsWaveFormTypeName, createMlsWaveGenerator, PcmDataEnumerator::FactoryParameter::Order, PcmDataEnumerator::DefaultOrder },
+};
+
+static const PcmDataEnumerator::SynthesisModeProperty synthesisModeProperties[] = {
+	{ IPcmData::SynthesisMode::CycleTable, "Cycle Table" },
+	{ IPcmData::SynthesisMode::Oscillator, "Oscillator" },
+	{ IPcmData::SynthesisMode::OscillatorBank, "Oscillator Bank" },
+	{ IPcmData::SynthesisMode::Sweep, "Sweep" },
+	{ IPcmData::SynthesisMode::Stream, "Stream" },
 };
 
 /*static*/ const std::vector<PcmDataEnumerator::SampleDataTypeProperty>& PcmDataEnumerator::getSampleDatatypeProperties()
@@ -71,6 +141,13 @@ static const PcmDataEnumerator::WaveFormProperty waveGeneratorProperties[] = {
 	return ret;
 }
 
+/*static*/ const std::vector<PcmDataEnumerator::SynthesisModeProperty>& PcmDataEnumerator::getSynthesisModeProperties()
+{
+	auto& ar(synthesisModeProperties);
+	static std::vector<SynthesisModeProperty> ret(&ar[0], &ar[ARRAYSIZE(ar)]);
+	return ret;
+}
+
 /*static*/ const PcmDataEnumerator::SampleDataTypeProperty& PcmDataEnumerator::getSampleDataTypeProperty(IPcmData::SampleDataType type)
 {
 	for(auto& sp : getSampleDatatypeProperties()) {
@@ -98,74 +175,402 @@ static const PcmDataEnumerator::WaveFormProperty waveGeneratorProperties[] = {
 	return unknown;
 }
 
+/*static*/ const PcmDataEnumerator::SynthesisModeProperty& PcmDataEnumerator::getSynthesisModeProperty(IPcmData::SynthesisMode mode)
+{
+	for(auto& mp : getSynthesisModeProperties()) {
+		if(mp.mode == mode) return mp;
+	}
+
+	static const SynthesisModeProperty unknown = {
+		(IPcmData::SynthesisMode)-1,
+		"UnknownSynthesisMode"
+	};
+	return unknown;
+}
+
+/*static*/ const char* PcmDataEnumerator::getDigits(IPcmData::WaveFormType type)
+{
+	switch(type) {
+	case IPcmData::WaveFormType::DTMF: return "0123456789*#ABCD";
+	case IPcmData::WaveFormType::MF: return "0123456789KSABC";
+	default: return nullptr;
+	}
+}
+
 #pragma endregion
 
-std::shared_ptr <IPcmData> createPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+// Size of the replica of whole cycles built in the destination buffer.
+// The replica should be small enough to stay in the L1/L2 cache while it is copied repeatedly.
+static const size_t ReplicaSize = 0x4000;
+
+void copyCyclicData(void* destBuffer, size_t destSize, const void* cycleData, size_t cycleSize, size_t& position)
+{
+	auto dest = (BYTE*)destBuffer;
+	auto cycle = (const BYTE*)cycleData;
+
+	// Tail of the current cycle.
+	auto size = min(cycleSize - position, destSize);
+	memcpy(dest, &cycle[position], size);
+	position += size;
+	if(cycleSize <= position) { position = 0; }
+	dest += size;
+	destSize -= size;
+
+	// Whole cycles.
+	// After the first cycle is copied, the destination buffer contains the replica of whole cycles
+	// which is doubled until it reaches ReplicaSize, and then copied repeatedly.
+	// This reduces count of memcpy() calls when the cycle is short.
+	if(cycleSize <= destSize) {
+		memcpy(dest, cycle, cycleSize);
+		const BYTE* replica = dest;
+		size_t replicaSize = cycleSize;
+		dest += cycleSize;
+		destSize -= cycleSize;
+		while(cycleSize <= destSize) {
+			size = min(replicaSize, destSize - (destSize % cycleSize));
+			memcpy(dest, replica, size);
+			dest += size;
+			destSize -= size;
+			if((size_t)(dest - replica) <= ReplicaSize) { replicaSize = dest - replica; }
+		}
+	}
+
+	// Head of the next cycle.
+	if(destSize) {
+		memcpy(dest, cycle, destSize);
+		position = destSize;
+	}
+}
+
+template<typename T>
+static IPcmData* createPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator, IPcmData::SynthesisMode synthesisMode)
+{
+	// Digits are rendered from tone tables in any synthesis mode.
+	switch(waveGenerator->getWaveFormType()) {
+	case IPcmData::WaveFormType::DTMF:
+	case IPcmData::WaveFormType::MF:
+		return new DualTonePcmData<T>(samplesPerSec, channels, waveGenerator);
+	// Noise does not have cycle.
+	case IPcmData::WaveFormType::WhiteNoise:
+	case IPcmData::WaveFormType::PinkNoise:
+		return new NoisePcmData<T>(samplesPerSec, channels, waveGenerator);
+	// Period of the sequence does not depend on the key.
+	case IPcmData::WaveFormType::MLS:
+		return new MlsPcmData<T>(samplesPerSec, channels, waveGenerator);
+	default:
+		break;
+	}
+
+	switch(synthesisMode) {
+	case IPcmData::SynthesisMode::CycleTable:
+		return new PcmData<T>(samplesPerSec, channels, waveGenerator);
+	case IPcmData::SynthesisMode::Oscillator:
+		return new OscillatorPcmData<T>(samplesPerSec, channels, waveGenerator);
+	case IPcmData::SynthesisMode::OscillatorBank:
+		return new OscillatorBankPcmData<T>(samplesPerSec, channels, waveGenerator);
+	case IPcmData::SynthesisMode::Sweep:
+		return new SweepPcmData<T>(samplesPerSec, channels, waveGenerator);
+	default:
+		return nullptr;
+	}
+}
+
+std::shared_ptr <IPcmData> createPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator, IPcmData::SynthesisMode synthesisMode)
 {
 	if(!waveGenerator) { return nullptr; }
+	// Buffer on the stack used by copyTo() holds at least 1 frame of all channels.
+	if(!channels || (IPcmData::MaxChannels < channels)) {
+		delete waveGenerator;
+		return nullptr;
+	}
 
 	IPcmData* p = nullptr;
 	switch(waveGenerator->getSampleDataType()) {
 	case IPcmData::SampleDataType::PCM_8bits:
-		p = new PcmData<UINT8>(samplesPerSec, channels, waveGenerator);
+		p = createPcmData<UINT8>(samplesPerSec, channels, waveGenerator, synthesisMode);
 		break;
 	case IPcmData::SampleDataType::PCM_16bits:
-		p = new PcmData<INT16>(samplesPerSec, channels, waveGenerator);
+		p = createPcmData<INT16>(samplesPerSec, channels, waveGenerator, synthesisMode);
 		break;
 	case IPcmData::SampleDataType::PCM_24bits:
-		p = new PcmData<INT24>(samplesPerSec, channels, waveGenerator);
+		p = createPcmData<INT24>(samplesPerSec, channels, waveGenerator, synthesisMode);
 		break;
 	case IPcmData::SampleDataType::IEEE_Float:
-		p = new PcmData<float>(samplesPerSec, channels, waveGenerator);
+		p = createPcmData<float>(samplesPerSec, channels, waveGenerator, synthesisMode);
+		break;
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		p = createPcmData<INT24in32>(samplesPerSec, channels, waveGenerator, synthesisMode);
+		break;
+	case IPcmData::SampleDataType::PCM_32bits:
+		p = createPcmData<INT32>(samplesPerSec, channels, waveGenerator, synthesisMode);
+		break;
+	case IPcmData::SampleDataType::IEEE_Double:
+		p = createPcmData<double>(samplesPerSec, channels, waveGenerator, synthesisMode);
 		break;
 	}
 	return std::shared_ptr<IPcmData>(p);
 }
 
-IWaveGenerator* createSquareWaveGenerator(IPcmData::SampleDataType sampleDataType, float duty)
+// Creates WaveGenerator of sampleDataType that owns waveForm.
+static IWaveGenerator* createWaveGenerator(IPcmData::SampleDataType sampleDataType, std::unique_ptr<WaveForm>&& waveForm)
 {
 	switch(sampleDataType) {
 	case IPcmData::SampleDataType::PCM_8bits:
-		return new SquareWaveGenerator<UINT8>(duty);
+		return new WaveGenerator<UINT8>(std::move(waveForm));
 	case IPcmData::SampleDataType::PCM_16bits:
-		return new SquareWaveGenerator<INT16>(duty);
+		return new WaveGenerator<INT16>(std::move(waveForm));
 	case IPcmData::SampleDataType::PCM_24bits:
-		return new SquareWaveGenerator<INT24>(duty);
+		return new WaveGenerator<INT24>(std::move(waveForm));
 	case IPcmData::SampleDataType::IEEE_Float:
-		return new SquareWaveGenerator<float>(duty);
+		return new WaveGenerator<float>(std::move(waveForm));
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		return new WaveGenerator<INT24in32>(std::move(waveForm));
+	case IPcmData::SampleDataType::PCM_32bits:
+		return new WaveGenerator<INT32>(std::move(waveForm));
+	case IPcmData::SampleDataType::IEEE_Double:
+		return new WaveGenerator<double>(std::move(waveForm));
 	default:
 		return nullptr;
 	}
 }
 
+IWaveGenerator* createSquareWaveGenerator(IPcmData::SampleDataType sampleDataType, float duty)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<SquareWaveForm>(duty));
+}
+
 IWaveGenerator* createSineWaveGenerator(IPcmData::SampleDataType sampleDataType, float)
 {
-	switch(sampleDataType) {
-	case IPcmData::SampleDataType::PCM_8bits:
-		return new SineWaveGenerator<UINT8>();
-	case IPcmData::SampleDataType::PCM_16bits:
-		return new SineWaveGenerator<INT16>();
-	case IPcmData::SampleDataType::PCM_24bits:
-		return new SineWaveGenerator<INT24>();
-	case IPcmData::SampleDataType::IEEE_Float:
-		return new SineWaveGenerator<float>();
-	default:
-		return nullptr;
-	}
+	return createWaveGenerator(sampleDataType, std::make_unique<SineWaveForm>());
 }
 
 IWaveGenerator* createTriangleWaveGenerator(IPcmData::SampleDataType sampleDataType, float peakPosition)
 {
-	switch(sampleDataType) {
-	case IPcmData::SampleDataType::PCM_8bits:
-		return new TriangleWaveGenerator<UINT8>(peakPosition);
-	case IPcmData::SampleDataType::PCM_16bits:
-		return new TriangleWaveGenerator<INT16>(peakPosition);
-	case IPcmData::SampleDataType::PCM_24bits:
-		return new TriangleWaveGenerator<INT24>(peakPosition);
-	case IPcmData::SampleDataType::IEEE_Float:
-		return new TriangleWaveGenerator<float>(peakPosition);
-	default:
-		return nullptr;
+	return createWaveGenerator(sampleDataType, std::make_unique<TriangleWaveForm>(peakPosition));
+}
+
+IWaveGenerator* createBandLimitedSquareWaveGenerator(IPcmData::SampleDataType sampleDataType, float duty)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<SquareWaveForm>(duty, true));
+}
+
+IWaveGenerator* createBandLimitedTriangleWaveGenerator(IPcmData::SampleDataType sampleDataType, float peakPosition)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<TriangleWaveForm>(peakPosition, true));
+}
+
+IWaveGenerator* createDtmfWaveGenerator(IPcmData::SampleDataType sampleDataType, float digit)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<DualToneWaveForm>(IPcmData::WaveFormType::DTMF, digit));
+}
+
+IWaveGenerator* createMfWaveGenerator(IPcmData::SampleDataType sampleDataType, float digit)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<DualToneWaveForm>(IPcmData::WaveFormType::MF, digit));
+}
+
+IWaveGenerator* createWhiteNoiseGenerator(IPcmData::SampleDataType sampleDataType, float seed)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<NoiseWaveForm>(IPcmData::WaveFormType::WhiteNoise, seed));
+}
+
+IWaveGenerator* createPinkNoiseGenerator(IPcmData::SampleDataType sampleDataType, float seed)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<NoiseWaveForm>(IPcmData::WaveFormType::PinkNoise, seed));
+}
+
+IWaveGenerator* createMlsWaveGenerator(IPcmData::SampleDataType sampleDataType, float order)
+{
+	return createWaveGenerator(sampleDataType, std::make_unique<MlsWaveForm>(order));
+}
+
+#pragma region Implementation of WaveForm classes
+
+IPcmData::WaveFormType SquareWaveForm::getWaveFormType() const
+{
+	return m_bandLimited ? IPcmData::WaveFormType::BandLimitedSquareWave : IPcmData::WaveFormType::SquareWave;
+}
+
+const char* SquareWaveForm::getWaveFormTypeName() const
+{
+	return m_bandLimited ? IWaveGenerator::BandLimitedSquareWaveFormTypeName : IWaveGenerator::SquareWaveFormTypeName;
+}
+
+void SquareWaveForm::generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const
+{
+	// Frames in high level = Frames whose first sample position is less than samplesPerCycle * duty.
+	auto highDuration = (size_t)(samplesPerCycle * m_duty);
+	auto highFrames = (highDuration + channels - 1) / channels;
+	auto frames = samplesPerCycle / channels;
+	SimdKernel::square(master, channels, frames, cycles, highFrames, 1.0f, -1.0f);
+	if(m_bandLimited) {
+		// Rising edge at the beginning of the cycle and falling edge at highFrames.
+		SimdKernel::polyBlep(master, channels, frames, cycles, 0, 2.0f, 0);
+		SimdKernel::polyBlep(master, channels, frames, cycles, (double)highFrames, -2.0f, 0);
+	}
+}
+
+void SineWaveForm::generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const
+{
+	SimdKernel::sine(master, channels, samplesPerCycle / channels, cycles, 0, 1.0f);
+}
+
+IPcmData::WaveFormType TriangleWaveForm::getWaveFormType() const
+{
+	return m_bandLimited ? IPcmData::WaveFormType::BandLimitedTriangleWave : IPcmData::WaveFormType::TriangleWave;
+}
+
+const char* TriangleWaveForm::getWaveFormTypeName() const
+{
+	return m_bandLimited ? IWaveGenerator::BandLimitedTriangleWaveFormTypeName : IWaveGenerator::TriangleWaveFormTypeName;
+}
+
+void TriangleWaveForm::generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const
+{
+	// Value of each sample is calculated from it's position independently.
+	auto frames = samplesPerCycle / channels;
+	SimdKernel::triangle(master, channels, frames, cycles, m_peakPosition, 0, 1.0f, 1.0f);
+	if(!m_bandLimited) { return; }
+
+	// Discontinuities of the shape described in TriangleShape of SimdKernel.
+	double p = m_peakPosition;
+	if(p == 0.0) {
+		// Falling Sawtooth jumps from -1.0 to +1.0 at the beginning of the cycle.
+		SimdKernel::polyBlep(master, channels, frames, cycles, 0, 2.0f, 0);
+	} else if(p == 1.0) {
+		SimdKernel::polyBlep(master, channels, frames, cycles, 0, -2.0f, 0);
+	} else if(p == 0.5) {
+		// Rising Sawtooth starting at 0.0 jumps from +1.0 to -1.0 at the middle of the cycle.
+		SimdKernel::polyBlep(master, channels, frames, cycles, frames * 0.5, -2.0f, 0);
+	} else {
+		// Slope changes at the bottom(position 1 - p) and at the peak(position p).
+		// Bottom and peak are swapped in upside-down wave of (1 - p) if p > 0.5.
+		auto sign = 1.0;
+		if(0.5 < p) {
+			p = 1 - p;
+			sign = -1;
+		}
+		auto slopeChange = sign * ((1 / p) + (2 / (1 - (2 * p))));
+		SimdKernel::polyBlep(master, channels, frames, cycles, frames * (1 - p), 0, (float)slopeChange);
+		SimdKernel::polyBlep(master, channels, frames, cycles, frames * p, 0, (float)-slopeChange);
+	}
+}
+
+// Digits in the order of PcmDataEnumerator::getDigits().
+static const DualToneWaveForm::Digit dtmfDigits[] = {
+	{ '0', 941, 1336 }, { '1', 697, 1209 }, { '2', 697, 1336 }, { '3', 697, 1477 },
+	{ '4', 770, 1209 }, { '5', 770, 1336 }, { '6', 770, 1477 }, { '7', 852, 1209 },
+	{ '8', 852, 1336 }, { '9', 852, 1477 }, { '*', 941, 1209 }, { '#', 941, 1477 },
+	{ 'A', 697, 1633 }, { 'B', 770, 1633 }, { 'C', 852, 1633 }, { 'D', 941, 1633 },
+};
+
+// K: KP(Key Pulse), S: ST(Start), A: ST', B: ST'', C: ST3P.
+static const DualToneWaveForm::Digit mfDigits[] = {
+	{ '0', 1300, 1500 }, { '1', 700, 900 }, { '2', 700, 1100 }, { '3', 900, 1100 },
+	{ '4', 700, 1300 }, { '5', 900, 1300 }, { '6', 1100, 1300 }, { '7', 700, 1500 },
+	{ '8', 900, 1500 }, { '9', 1100, 1500 }, { 'K', 1100, 1700 }, { 'S', 1500, 1700 },
+	{ 'A', 900, 1700 }, { 'B', 1300, 1700 }, { 'C', 700, 1700 },
+};
+
+// Digit out of range is replaced with the first digit.
+DualToneWaveForm::DualToneWaveForm(IPcmData::WaveFormType type, float digit)
+	: m_type(type)
+	, m_digit(getDigits(type).at(((0 <= digit) && ((size_t)digit < getDigits(type).size())) ? (size_t)digit : 0))
+{
+}
+
+const char* DualToneWaveForm::getWaveFormTypeName() const
+{
+	return (m_type == IPcmData::WaveFormType::MF) ? IWaveGenerator::MfWaveFormTypeName : IWaveGenerator::DtmfWaveFormTypeName;
+}
+
+void DualToneWaveForm::generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const
+{
+	auto frames = samplesPerCycle / channels;
+	auto highCycles = (size_t)(((double)cycles * m_digit.highFrequency / m_digit.lowFrequency) + 0.5);
+	SimdKernel::sine(master, channels, frames, cycles, 0, 0.5f);
+	std::unique_ptr<float[]> high(new float[frames]);
+	SimdKernel::sine(high.get(), 1, frames, highCycles, 0, 0.5f);
+	for(size_t frame = 0; frame < frames; frame++) {
+		master[frame * channels] += high[frame];
+	}
+}
+
+/*static*/ const std::vector<DualToneWaveForm::Digit>& DualToneWaveForm::getDigits(IPcmData::WaveFormType type)
+{
+	static const std::vector<Digit> dtmf(&dtmfDigits[0], &dtmfDigits[ARRAYSIZE(dtmfDigits)]);
+	static const std::vector<Digit> mf(&mfDigits[0], &mfDigits[ARRAYSIZE(mfDigits)]);
+	static const std::vector<Digit> none;
+	switch(type) {
+	case IPcmData::WaveFormType::DTMF: return dtmf;
+	case IPcmData::WaveFormType::MF: return mf;
+	default: return none;
 	}
 }
+
+/*static*/ const DualToneWaveForm::Digit* DualToneWaveForm::findDigit(IPcmData::WaveFormType type, char digit)
+{
+	for(auto& d : getDigits(type)) {
+		if(d.digit == toupper(digit)) { return &d; }
+	}
+	return nullptr;
+}
+
+/*static*/ std::vector<WORD> DualToneWaveForm::getFrequencies(IPcmData::WaveFormType type)
+{
+	std::vector<WORD> frequencies;
+	for(auto& d : getDigits(type)) {
+		for(auto frequency : { d.lowFrequency, d.highFrequency }) {
+			if(std::find(frequencies.begin(), frequencies.end(), frequency) == frequencies.end()) {
+				frequencies.push_back(frequency);
+			}
+		}
+	}
+	std::sort(frequencies.begin(), frequencies.end());
+	return frequencies;
+}
+
+// Seed is truncated to UINT32. Negative seed is replaced with 0.
+NoiseWaveForm::NoiseWaveForm(IPcmData::WaveFormType type, float seed)
+	: m_type(type), m_seed((0 < seed) ? (UINT32)(UINT64)min(seed, 1e19f) : 0)
+{
+}
+
+const char* NoiseWaveForm::getWaveFormTypeName() const
+{
+	return (m_type == IPcmData::WaveFormType::PinkNoise) ? IWaveGenerator::PinkNoiseWaveFormTypeName : IWaveGenerator::WhiteNoiseWaveFormTypeName;
+}
+
+void NoiseWaveForm::generate(float* master, size_t samplesPerCycle, WORD channels, size_t) const
+{
+	// Cycles are not repeated in the block of the noise.
+	auto frames = samplesPerCycle / channels;
+	std::unique_ptr<float[]> noise(new float[frames]);
+	generate(noise.get(), frames, m_seed, 0, 1.0f);
+	for(size_t frame = 0; frame < frames; frame++) {
+		master[frame * channels] = noise[frame];
+	}
+}
+
+void MlsWaveForm::generate(float* master, size_t samplesPerCycle, WORD channels, size_t) const
+{
+	auto frames = samplesPerCycle / channels;
+	if(channels == 1) { return m_sequence.generate(master, frames, 0, 1.0f); }
+
+	std::unique_ptr<float[]> sequence(new float[frames]);
+	m_sequence.generate(sequence.get(), frames, 0, 1.0f);
+	for(size_t frame = 0; frame < frames; frame++) {
+		master[frame * channels] = sequence[frame];
+	}
+}
+
+void NoiseWaveForm::generate(float* dest, size_t count, UINT32 seed, UINT32 index, float height) const
+{
+	if(m_type == IPcmData::WaveFormType::PinkNoise) {
+		SimdKernel::pinkNoise(dest, count, seed, index, height);
+	} else {
+		SimdKernel::whiteNoise(dest, count, seed, index, height);
+	}
+}
+
+#pragma endregion
@@ -9,6 +9,12 @@
 #include <math.h>
 #include <Windows.h>
 #include <mmreg.h>
+#include <ksmedia.h>
+
+#include "SimdKernel.h"
+#include "WaveTableCache.h"
+#include "EpochPtr.h"
+#include "MaximumLengthSequence.h"
 
 template<typename T>
 class PcmSampleImpl;
@@ -23,6 +29,37 @@ float limit(float value, float max = 1.0f, float min = 0)
 }
 }
 
+// Copies cyclic data to the buffer as contiguous runs of the cycle:
+//   Tail of the current cycle, N whole cycles and then head of the next cycle.
+// position is byte offset in the cycle to start copying from,
+// and is updated to the offset to start next copying from.
+void copyCyclicData(void* destBuffer, size_t destSize, const void* cycleData, size_t cycleSize, size_t& position);
+
+/*
+ * WaveForm class
+ *
+ * Generates wave as float master normalized to -1.0(LowValue) ~ +1.0(HighValue).
+ * Wave form does not depend on sample data type. So each wave form is available at any sample data type,
+ * and the master is converted to the sample data type by PcmData class when samples are copied.
+ */
+class WaveForm
+{
+public:
+	virtual ~WaveForm() {}
+
+	virtual IPcmData::WaveFormType getWaveFormType() const = 0;
+	virtual const char* getWaveFormTypeName() const = 0;
+	// Returns parameter that identifies the wave form of the type, such as duty of square wave.
+	// Used as a key of WaveTableCache with the type.
+	virtual double getParameter() const { return 0; }
+	// Returns true if wave table of oscillator should be band-limited for the key.
+	virtual bool isBandLimited() const { return false; }
+
+	// Generates samples of first channel in master at interval of channels.
+	// master contains `cycles` cycles in samplesPerCycle samples.
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles = 1) const = 0;
+};
+
 class IWaveGenerator
 {
 public:
@@ -32,34 +69,45 @@ public:
 	virtual const char* getSampleDataTypeName() const = 0;
 	virtual IPcmData::WaveFormType getWaveFormType() const = 0;
 	virtual const char* getWaveFormTypeName() const = 0;
+	virtual const WaveForm& getWaveForm() const = 0;
 
 	static const char* SquareWaveFormTypeName;
 	static const char* SineWaveFormTypeName;
 	static const char* TriangleWaveFormTypeName;
+	static const char* BandLimitedSquareWaveFormTypeName;
+	static const char* BandLimitedTriangleWaveFormTypeName;
+	static const char* DtmfWaveFormTypeName;
+	static const char* MfWaveFormTypeName;
+	static const char* WhiteNoiseWaveFormTypeName;
+	static const char* PinkNoiseWaveFormTypeName;
+	static const char* MlsWaveFormTypeName;
 };
 
+/*
+ * WaveGenerator template class
+ * Combines WaveForm with sample data type T of PcmData<T> to be created.
+ */
 template<typename T>
 class WaveGenerator : public IWaveGenerator
 {
 public:
-	virtual ~WaveGenerator() {}
+	WaveGenerator(std::unique_ptr<WaveForm>&& waveForm) : m_waveForm(std::move(waveForm)) {}
 
 	virtual IPcmData::SampleDataType getSampleDataType() const override { return SampleDataType; }
 	virtual const char* getSampleDataTypeName() const override { return SampleDataTypeName; }
-	virtual IPcmData::WaveFormType getWaveFormType() const override = 0;
-	virtual const char* getWaveFormTypeName() const override = 0;
-
-	virtual void generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level) = 0;
+	virtual IPcmData::WaveFormType getWaveFormType() const override { return m_waveForm->getWaveFormType(); }
+	virtual const char* getWaveFormTypeName() const override { return m_waveForm->getWaveFormTypeName(); }
+	virtual const WaveForm& getWaveForm() const override { return *m_waveForm; }
 
 	static const IPcmData::SampleDataType SampleDataType;
 	static const char* SampleDataTypeName;
 
 protected:
-	void adjustLevel(float level, T* pHighValue = nullptr, T* pLowValue = nullptr, T* pZeroValue = nullptr) const;
+	std::unique_ptr<WaveForm> m_waveForm;
 };
 
 /*
- * WaveGenerator template class
+ * PcmData template class
  * Type parameter T is data type of wave sample data.
  *   Such as T=INT16 for 16 bit per sample per channel.
  *   This case, minimum atomic unit of 2-channel sample is 16 / 8 * 2 byte.
@@ -73,12 +121,36 @@ class PcmData : public IPcmData
 public:
 	PcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
 		: m_samplesPerSec(samplesPerSec), m_channels(channels)
+		, m_samplesPerCycle(0)
 		, m_waveGenerator((WaveGenerator<T>*)waveGenerator)
-		, m_samplesPerCycle(0), m_currentPosition(0) {}
+		, m_defaultPosition(channels)
+		, m_cycleDataSamples(0), m_blockSize(0), m_maxTiledDataSize(0)
+		, m_maxExactPeriodDataSize(0), m_cycles(0), m_frequencyError(0)
+		, m_retuneMode(RetuneMode::Reset), m_crossfadeFrames(0), m_generation(0)
+		, m_dither(DitherType::None) {
+		m_levelState.publish(std::unique_ptr<LevelState>(new LevelState()));
+	}
 
-	virtual HRESULT copyTo(void* destBuffer, size_t destSize) override;
+	virtual HRESULT copyTo(void* destBuffer, size_t destSize) override { return copyTo(m_defaultPosition, destBuffer, destSize); }
+	virtual HRESULT copyToPlanar(void* const* channelBuffers, size_t frames) override {
+		return copyToPlanar(m_defaultPosition, channelBuffers, frames);
+	}
+	virtual std::unique_ptr<IPcmDataCursor> createCursor() override { return std::make_unique<Cursor>(*this); }
+	virtual HRESULT setBlockSize(size_t blockSize, size_t maxTiledDataSize) override;
+	virtual HRESULT setExactPeriod(size_t maxCycleDataSize) override;
+	virtual HRESULT setRetuneMode(RetuneMode mode, size_t crossfadeFrames) override;
+	virtual HRESULT setLevel(float level, size_t rampFrames) override;
+	virtual HRESULT setDither(DitherType dither) override;
 	virtual void generate(float key, float level, float phaseShift) override;
+	virtual HRESULT generateChannels(const ToneParameter* channelParameters) override;
+	// Sum of tones is synthesized by OscillatorBankPcmData class.
+	virtual HRESULT generateTones(const ToneParameter*, size_t) override { return E_NOTIMPL; }
+	// Digits are rendered by DualTonePcmData class.
+	virtual HRESULT generateDigits(const char*, size_t, size_t, float) override { return E_NOTIMPL; }
+	// Sweep is synthesized by SweepPcmData class. Noise is synthesized by NoisePcmData class.
+	virtual HRESULT generateSweep(float, float, size_t, SweepLaw, float) override { return E_NOTIMPL; }
 
+	virtual SynthesisMode getSynthesisMode() const override { return SynthesisMode::CycleTable; }
 	virtual SampleDataType getSampleDataType() const override { return m_waveGenerator->getSampleDataType(); }
 	virtual const char* getSampleDataTypeName() const override { return m_waveGenerator->getSampleDataTypeName(); }
 
@@ -88,45 +160,344 @@ public:
 	// Returns byte size of the minimum atomic unit of data to be generated.
 	virtual WORD getBlockAlign() const override { return m_channels * sizeof(T); }
 	virtual WORD getBitsPerSample() const override { return sizeof(T) * 8; }
+	virtual WORD getValidBitsPerSample() const override { return ValidBitsPerSample; }
 	virtual DWORD getSamplesPerSec() const override { return m_samplesPerSec; }
 	virtual WORD getChannels() const override { return m_channels; }
 	virtual const char* getSampleTypeName() const { return typeid(T).name(); }
 	virtual size_t getSamplesPerCycle() const { return m_samplesPerCycle; }
+	virtual size_t getCycleDataSize() const override { return m_cycleDataSamples * sizeof(T); }
+	virtual bool isTiled() const override { return m_samplesPerCycle < m_cycleDataSamples; }
+	virtual size_t getCycles() const override { return m_cycles; }
+	virtual double getFrequencyError() const override { return m_frequencyError; }
 	virtual size_t getSampleBufferSize(size_t duration) const;
+	virtual void getWaveFormat(WAVEFORMATEXTENSIBLE& format) const override;
 
 	static const WORD FormatTag;
+	static const WORD ValidBitsPerSample;
 	static const T HighValue;
 	static const T ZeroValue;
 	static const T LowValue;
+	// HighValue - ZeroValue, that is sample value of +1.0 in float master.
+	static const float Height;
 
 protected:
 	const DWORD m_samplesPerSec;
 	const WORD m_channels;
 	size_t m_samplesPerCycle;
-	size_t m_currentPosition;
-	std::unique_ptr<T[]> m_cycleData;
 	std::unique_ptr<WaveGenerator<T>> m_waveGenerator;
+
+	// Cycle data generated by generate() method and read by copyTo() method of cursors.
+	// Cycle data is not modified after published, and is shared by all cursors.
+	struct CycleData
+	{
+		CycleData(size_t samplesPerCycle, size_t cycleDataSamples, size_t cycles)
+			: samples(new T[cycleDataSamples]), master(new float[samplesPerCycle]), samplesPerCycle(samplesPerCycle)
+			, cycleDataSamples(cycleDataSamples), cycles(cycles)
+			, generation(0), previous(nullptr), crossfadeFrames(0) {}
+
+		// Samples converted from master at full scale, and copied as they are.
+		std::unique_ptr<T[]> samples;
+		// Float master of 1-cycle data of all channels, that is converted when level or dither is applied.
+		// Master is planar(Structure of Arrays). Channel c consists of frames at master[c * (samplesPerCycle / channels)].
+		std::unique_ptr<float[]> master;
+		const size_t samplesPerCycle;
+		// Sample count of samples including tile.
+		const size_t cycleDataSamples;
+		// Number of cycles in samplesPerCycle.
+		const size_t cycles;
+		// Incremented by generate(). Cycle data re-tiled by setBlockSize() has the same generation.
+		size_t generation;
+
+		// Cycle data replaced by this one in RetuneMode::Continuous, or nullptr.
+		// Cursor continues from the phase in previous data and crossfades from it.
+		// Previous data is owned by previousHolder and is deleted when this data is replaced.
+		CycleData* previous;
+		std::unique_ptr<CycleData> previousHolder;
+		size_t crossfadeFrames;
+	};
+
+	// Read position of a cursor.
+	// Fields are atomic so that cursor shared by threads does not break cycle data, though samples might be.
+	struct Position
+	{
+		Position(WORD channels) : generation(0), position(0), previousPosition(0), crossfadedFrames(0), phases(new std::atomic<UINT64>[channels]())
+			, gain(-1), rampLevel(0), rampStep(0), rampFrames(0), ditherIndex(0) {}
+
+		// Generation of cycle data that position refers to. 0 means that no data has been copied.
+		std::atomic<size_t> generation;
+		std::atomic<size_t> position;
+		// Position in the previous data and number of frames crossfaded.
+		std::atomic<size_t> previousPosition;
+		std::atomic<size_t> crossfadedFrames;
+		// Phase of each channel used by OscillatorPcmData. 2^64 = 1 cycle.
+		std::unique_ptr<std::atomic<UINT64>[]> phases;
+		// Gain applied to the last sample copied. Negative value means that no sample has been copied.
+		std::atomic<float> gain;
+		// Level that gain ramps toward, step of gain per frame and remaining frames of the ramp.
+		std::atomic<float> rampLevel;
+		std::atomic<float> rampStep;
+		std::atomic<size_t> rampFrames;
+		// Index of the next sample to be dithered.
+		std::atomic<UINT32> ditherIndex;
+	};
+
+	/*
+	 * Cursor class
+	 * Lightweight object that has it's own Position and reads cycle data of PcmData.
+	 */
+	class Cursor : public IPcmDataCursor
+	{
+	public:
+		Cursor(PcmData& pcmData) : m_pcmData(pcmData), m_position(pcmData.m_channels) {}
+
+		virtual HRESULT copyTo(void* destBuffer, size_t destSize) override {
+			return m_pcmData.copyTo(m_position, destBuffer, destSize);
+		}
+		virtual HRESULT copyToPlanar(void* const* channelBuffers, size_t frames) override {
+			return m_pcmData.copyToPlanar(m_position, channelBuffers, frames);
+		}
+
+	protected:
+		PcmData& m_pcmData;
+		Position m_position;
+	};
+
+	// Position of copyTo() method of IPcmData.
+	Position m_defaultPosition;
+
+	// Buffer passed to copyTo() or copyToPlanar() method.
+	struct Destination
+	{
+		T* interleaved;				// Interleaved samples, or nullptr for planar samples.
+		T* const* channels;			// Buffers of each channel, used if interleaved is nullptr.
+		size_t frames;
+	};
+
+	HRESULT copyTo(Position& position, void* destBuffer, size_t destSize);
+	HRESULT copyToPlanar(Position& position, void* const* channelBuffers, size_t frames);
+	// Copies samples to the destination validated by copyTo() or copyToPlanar().
+	virtual HRESULT copy(Position& position, const Destination& dest);
+
+	// copyTo() reads cycle data without lock.
+	// generate() and setBlockSize() build new cycle data and replace current one.
+	EpochPtr<CycleData> m_cycleData;
+	// Serializes generate() and setBlockSize().
 	CriticalSection::Object m_cycleDataLock;
 
+	// Sample count of cycle data including tile.
+	size_t m_cycleDataSamples;
+
+	// Parameters passed to setBlockSize() method.
+	size_t m_blockSize;
+	size_t m_maxTiledDataSize;
+
+	// Parameter passed to setExactPeriod() method.
+	size_t m_maxExactPeriodDataSize;
+
+	// Number of cycles in m_samplesPerCycle and it's frequency error.
+	size_t m_cycles;
+	double m_frequencyError;
+
+	// Parameters passed to setRetuneMode() method.
+	RetuneMode m_retuneMode;
+	size_t m_crossfadeFrames;
+
+	// Generation of the latest cycle data.
+	size_t m_generation;
+
+	// Level passed to setLevel() or generate() method, and it's ramp.
+	struct Level
+	{
+		float level;
+		size_t rampFrames;
+	};
+	// Level published to copyTo() without lock.
+	// Level passed to generate() is published before the data of the generation,
+	// and the level of the previous generation is kept for copyTo() that still reads the previous data.
+	// So that copyTo() never applies the level to the data of another generation.
+	struct LevelState
+	{
+		LevelState() : current{ 0, 0 }, previous{ 0, 0 }, generation(0) {}
+
+		Level current;
+		Level previous;
+		// Generation of the data that current level is applied to.
+		size_t generation;
+	};
+	EpochPtr<LevelState> m_levelState;
+
+	// Returns level applied to the data of the generation.
+	// copy() calls this once and uses the level for all frames to be copied.
+	Level getLevel(size_t generation);
+	// Publishes level applied to the data of the generation and later.
+	// Call in m_cycleDataLock before the data of the generation is published.
+	void publishLevel(float level, size_t rampFrames, size_t generation);
+
+	// Parameter passed to setDither() method. Read by copyTo() without lock.
+	std::atomic<DitherType> m_dither;
+
+	// Sample count of float buffer on the stack, used to convert samples synthesized by copyTo().
+	static const size_t ConvertBufferSamples = 2048;
+	static_assert(IPcmData::MaxChannels <= ConvertBufferSamples, "Buffer should hold 1 frame at least.");
+
+	// Returns true if samples to be copied are same as cycle data converted at full scale.
+	bool isFullScale(const Position& position, const Level& level) const;
+
+	// Gain applied to frames to be converted.
+	// Gain of frame f changes from `gain` by `step` per frame while f < frames, and is endGain after that.
+	struct Ramp
+	{
+		float gain;
+		float step;
+		size_t frames;
+		float endGain;
+	};
+	// Returns ramp of gain that moves toward the level, and advances the ramp of the position by frames.
+	Ramp ramp(Position& position, const Level& level, size_t frames) const;
+
+	// Converts float master to samples with gain that moves toward the level, and dither.
+	void convert(Position& position, const Level& level, T* dest, const float* master, size_t samples) const;
+	// Converts planar float master to buffers of each channel at destFrame. See convert().
+	// Channel c of the master consists of frames at master[c * masterStride].
+	void convertPlanar(Position& position, const Level& level, T* const* dest, size_t destFrame,
+						const float* master, size_t masterStride, size_t frames) const;
+	// Converts planar float master to the destination at destFrame, interleaving it if necessary.
+	void put(Position& position, const Level& level, const Destination& dest, size_t destFrame,
+			const float* master, size_t masterStride, size_t frames) const;
+
+	// Moves position to new cycle data.
+	// Continues from the phase in the previous data, if the position refers to it.
+	void start(const CycleData* cycleData, Position& position) const;
+	// Converts crossfade of previous data to new data and returns frame count copied.
+	size_t crossfade(const CycleData* cycleData, Position& position, const Level& level, const Destination& dest) const;
+
+	// Interleaves and converts the master at full scale, and publishes the cycle data to copyTo().
+	void publish(std::unique_ptr<CycleData>&& newCycleData, float key, float level);
+
+	// Returns wave form of the channel.
+	// Wave form of another WaveFormType is created by the factory and is owned by holder.
+	// Returns nullptr if the WaveFormType is unknown.
+	const WaveForm* getWaveForm(const ToneParameter& parameter, std::unique_ptr<IWaveGenerator>& holder) const;
+
+	// Returns frame count and number of cycles in it for the key.
+	size_t getPeriod(float key, size_t* pCycles) const;
+
+	// Returns sample count of cycle data to be allocated for samplesPerCycle.
+	size_t getCycleDataSamples(size_t samplesPerCycle) const;
+	// Fills tile following 1-cycle data.
+	void tile(T* cycleData, size_t samplesPerCycle, size_t cycleDataSamples) const;
+
 	// Returns number rounded up to the nearest multiple of significance value.
 	size_t ceiling(size_t number, size_t significance) const;
 };
 
 template<typename T>
-HRESULT PcmData<T>::copyTo(void* destBuffer, size_t destSize)
+HRESULT PcmData<T>::copyTo(Position& position, void* destBuffer, size_t destSize)
 {
-	CriticalSection lock(m_cycleDataLock);
-
-	// Assert that data has been generated.
-	HR_ASSERT(m_cycleData, E_ILLEGAL_METHOD_CALL);
-
 	HR_ASSERT(destBuffer, E_POINTER);
 	HR_ASSERT(0 < destSize, ERROR_INCORRECT_SIZE);
 	HR_ASSERT((destSize % getBlockAlign()) == 0, E_BOUNDS);
 
-	for(DWORD destPosition = 0; destPosition < destSize; destPosition += sizeof(T)) {
-		*(T*)&((BYTE*)destBuffer)[destPosition] = m_cycleData[m_currentPosition++];
-		if(m_samplesPerCycle <= m_currentPosition) { m_currentPosition = 0; }
+	return copy(position, Destination{ (T*)destBuffer, nullptr, destSize / getBlockAlign() });
+}
+
+template<typename T>
+HRESULT PcmData<T>::copyToPlanar(Position& position, void* const* channelBuffers, size_t frames)
+{
+	HR_ASSERT(channelBuffers, E_POINTER);
+	for(WORD channel = 0; channel < m_channels; channel++) {
+		HR_ASSERT(channelBuffers[channel], E_POINTER);
+	}
+	HR_ASSERT(0 < frames, ERROR_INCORRECT_SIZE);
+
+	return copy(position, Destination{ nullptr, (T* const*)channelBuffers, frames });
+}
+
+template<typename T>
+HRESULT PcmData<T>::copy(Position& position, const Destination& dest)
+{
+	// Cycle data is not deleted by generate() while reader exists.
+	typename EpochPtr<CycleData>::Reader cycleData(m_cycleData);
+
+	// Assert that data has been generated.
+	HR_ASSERT(cycleData.get(), E_ILLEGAL_METHOD_CALL);
+
+	if(position.generation.load() != cycleData->generation) {
+		start(cycleData.get(), position);
+	}
+	const auto level = getLevel(cycleData->generation);
+	size_t frame = 0;
+	if(cycleData->previous && (position.crossfadedFrames.load() < cycleData->crossfadeFrames)) {
+		frame = crossfade(cycleData.get(), position, level, dest);
+	}
+
+	if(frame < dest.frames) {
+		auto currentPosition = position.position.load();
+		if(cycleData->samplesPerCycle <= currentPosition) {
+			// Position has been moved to another cycle data by another thread.
+			currentPosition = 0;
+		}
+		if(!dest.interleaved || !isFullScale(position, level)) {
+			// Convert master for each run of the cycle.
+			auto framesPerCycle = cycleData->samplesPerCycle / m_channels;
+			auto currentFrame = currentPosition / m_channels;
+			while(frame < dest.frames) {
+				auto run = min(framesPerCycle - currentFrame, dest.frames - frame);
+				put(position, level, dest, frame, &cycleData->master[currentFrame], framesPerCycle, run);
+				frame += run;
+				currentFrame = (currentFrame + run) % framesPerCycle;
+			}
+			position.position = currentFrame * m_channels;
+		} else {
+			// Level ramp starts from full scale when the level is changed next time.
+			position.gain = 1.0f;
+			position.rampLevel = 1.0f;
+			auto buffer = &dest.interleaved[frame * m_channels];
+			auto samples = (dest.frames - frame) * m_channels;
+			auto size = samples * sizeof(T);
+			if(samples <= (cycleData->cycleDataSamples - currentPosition)) {
+				// Cycle data(including tile) from current position contains all samples to be copied.
+				memcpy(buffer, &cycleData->samples[currentPosition], size);
+				position.position = (currentPosition + samples) % cycleData->samplesPerCycle;
+			} else {
+				// Copy by byte, because cycle data consists of whole T samples and size is boundary of T.
+				size_t bytePosition = currentPosition * sizeof(T);
+				copyCyclicData(buffer, size, cycleData->samples.get(), cycleData->samplesPerCycle * sizeof(T), bytePosition);
+				position.position = bytePosition / sizeof(T);
+			}
+		}
+	}
+
+	return S_OK;
+}
+
+template<typename T>
+HRESULT PcmData<T>::setBlockSize(size_t blockSize, size_t maxTiledDataSize)
+{
+	HR_ASSERT((blockSize % getBlockAlign()) == 0, E_INVALIDARG);
+
+	CriticalSection lock(m_cycleDataLock);
+
+	m_blockSize = blockSize;
+	m_maxTiledDataSize = maxTiledDataSize;
+
+	// Re-create cycle data if generate() has been called.
+	auto current = m_cycleData.get();
+	if(current) {
+		auto samplesPerCycle = current->samplesPerCycle;
+		auto cycleDataSamples = getCycleDataSamples(samplesPerCycle);
+		std::unique_ptr<CycleData> cycleData(new CycleData(samplesPerCycle, cycleDataSamples, current->cycles));
+		memcpy(cycleData->samples.get(), current->samples.get(), samplesPerCycle * sizeof(T));
+		memcpy(cycleData->master.get(), current->master.get(), samplesPerCycle * sizeof(float));
+		tile(cycleData->samples.get(), samplesPerCycle, cycleDataSamples);
+		// Cursors keep their position and crossfade in the re-tiled data.
+		cycleData->generation = current->generation;
+		cycleData->previous = current->previous;
+		cycleData->crossfadeFrames = current->crossfadeFrames;
+		auto newCycleData = cycleData.get();
+		auto old = m_cycleData.publish(std::move(cycleData));
+		newCycleData->previousHolder = std::move(old->previousHolder);
+		m_cycleDataSamples = cycleDataSamples;
 	}
 
 	return S_OK;
@@ -135,31 +506,426 @@ HRESULT PcmData<T>::copyTo(void* destBuffer, size_t destSize)
 template<typename T>
 void PcmData<T>::generate(float key, float level, float phaseShift)
 {
-	// Generate PCM data for first channel using WaveGenerator.
-	auto samplesPerCycle = ceiling((size_t)(m_samplesPerSec * m_channels / key), m_channels);
-	std::unique_ptr<T[]> cycleData(new T[samplesPerCycle]);
-	m_waveGenerator->generate(cycleData.get(), samplesPerCycle, m_channels, limit(level));
+	// Float master for first channel is generated by WaveForm and shared with other objects through WaveTableCache.
+	size_t cycles;
+	auto frames = getPeriod(key, &cycles);
+	auto samplesPerCycle = frames * m_channels;
+	auto cycleDataSamples = getCycleDataSamples(samplesPerCycle);
+	std::unique_ptr<CycleData> newCycleData(new CycleData(samplesPerCycle, cycleDataSamples, cycles));
+	auto master = newCycleData->master.get();
+	auto source = WaveTableCache::getInstance().getMaster(m_waveGenerator->getWaveForm(), frames, cycles);
+	memcpy(master, source->data(), frames * sizeof(float));
 
 	if(1 < m_channels) {
 		// Copy first channel to another channel shifting phase.
-		auto shiftDelta = ceiling(samplesPerCycle - (size_t)(samplesPerCycle * limit(phaseShift)), m_channels);
-		size_t shift = 0;
+		// Each channel is first channel rotated by the shift, that is 2 contiguous runs before and after the wrap point.
+		// Each channel leads the previous channel by (1 - phaseShift) cycle as same as OscillatorPcmData class.
+		// Shift is rounded to frames of 1 cycle, which is frames / cycles and might be fractional,
+		// so that the shift of phaseShift 0 or 1 is 0 for any cycles.
 		for(WORD channel = 1; channel < m_channels; channel++) {
-			shift += shiftDelta;
-			auto posSrc = shift;
-			for(size_t pos = 0; pos < samplesPerCycle; pos += m_channels) {
-				cycleData[pos + channel] = cycleData[posSrc % samplesPerCycle];
-				posSrc += m_channels;
-			}
+			auto phase = fmod(channel * (1.0 - limit(phaseShift)), 1.0);
+			auto shift = (size_t)floor((phase * frames / cycles) + 0.5) % frames;
+			auto channelMaster = &master[channel * frames];
+			memcpy(channelMaster, &master[shift], (frames - shift) * sizeof(float));
+			memcpy(&channelMaster[frames - shift], master, shift * sizeof(float));
 		}
 	}
 
-	// Update member variables in the Critical Section.
+	publish(std::move(newCycleData), key, level);
+}
+
+template<typename T>
+HRESULT PcmData<T>::generateChannels(const ToneParameter* channelParameters)
+{
+	HR_ASSERT(channelParameters, E_POINTER);
+
+	// All channels share cycle data of the key.
+	auto key = channelParameters[0].key;
+	for(WORD channel = 1; channel < m_channels; channel++) {
+		HR_ASSERT(channelParameters[channel].key == key, E_INVALIDARG);
+	}
+
+	size_t cycles;
+	auto frames = getPeriod(key, &cycles);
+	auto samplesPerCycle = frames * m_channels;
+	std::unique_ptr<CycleData> newCycleData(new CycleData(samplesPerCycle, getCycleDataSamples(samplesPerCycle), cycles));
+	auto master = newCycleData->master.get();
+	for(WORD channel = 0; channel < m_channels; channel++) {
+		auto& parameter = channelParameters[channel];
+		std::unique_ptr<IWaveGenerator> holder;
+		auto waveForm = getWaveForm(parameter, holder);
+		HR_ASSERT(waveForm, E_INVALIDARG);
+		auto source = WaveTableCache::getInstance().getMaster(*waveForm, frames, cycles);
+		auto wave = source->data();
+
+		// Channel is the wave rotated by the phase in 1 cycle, which is frames / cycles, and scaled by the level.
+		// Rotated wave consists of 2 contiguous runs before and after the wrap point.
+		auto shift = (size_t)(limit(parameter.phase) * frames / cycles) % frames;
+		auto level = limit(parameter.level);
+		auto channelMaster = &master[channel * frames];
+		for(size_t frame = 0; frame < frames - shift; frame++) {
+			channelMaster[frame] = wave[shift + frame] * level;
+		}
+		for(size_t frame = 0; frame < shift; frame++) {
+			channelMaster[frames - shift + frame] = wave[frame] * level;
+		}
+	}
+
+	publish(std::move(newCycleData), key, 1.0f);
+	return S_OK;
+}
+
+template<typename T>
+void PcmData<T>::publish(std::unique_ptr<CycleData>&& newCycleData, float key, float level)
+{
+	auto samplesPerCycle = newCycleData->samplesPerCycle;
+	auto cycleDataSamples = newCycleData->cycleDataSamples;
+	auto cycles = newCycleData->cycles;
+	auto frames = samplesPerCycle / m_channels;
+	auto master = newCycleData->master.get();
+
+	// Samples at full scale are interleaved and converted once here. Level and dither are applied by copyTo().
+	auto cycleData = newCycleData->samples.get();
+	{
+		float buffer[ConvertBufferSamples];
+		const auto bufferFrames = ConvertBufferSamples / m_channels;
+		for(size_t frame = 0; frame < frames; frame += bufferFrames) {
+			auto count = min(frames - frame, bufferFrames);
+			SimdKernel::interleave(buffer, &master[frame], frames, m_channels, count);
+			SimdKernel::convert(&cycleData[frame * m_channels], buffer, count * m_channels, (float)(double)ZeroValue, Height);
+		}
+	}
+	tile(cycleData, samplesPerCycle, cycleDataSamples);
+
+	// Publish new cycle data to copyTo() without blocking it.
 	{
 		CriticalSection lock(m_cycleDataLock);
-		m_cycleData = std::move(cycleData);
+		auto current = newCycleData.get();
+		current->generation = ++m_generation;
+		publishLevel(level, 0, current->generation);
+		if((m_retuneMode == RetuneMode::Continuous) && m_cycleData.get()) {
+			current->previous = m_cycleData.get();
+			current->crossfadeFrames = m_crossfadeFrames;
+		}
+		auto previous = m_cycleData.publish(std::move(newCycleData));
+		if(current->previous) {
+			// No reader refers to the data older than previous data any more.
+			// Keep previous data for crossfade until new data is replaced.
+			previous->previous = nullptr;
+			previous->previousHolder.reset();
+			current->previousHolder = std::move(previous);
+		}
 		m_samplesPerCycle = samplesPerCycle;
-		m_currentPosition = 0;
+		m_cycleDataSamples = cycleDataSamples;
+		m_cycles = cycles;
+		m_frequencyError = ((double)m_samplesPerSec * cycles * m_channels / samplesPerCycle) - key;
+	}
+}
+
+template<typename T>
+const WaveForm* PcmData<T>::getWaveForm(const ToneParameter& parameter, std::unique_ptr<IWaveGenerator>& holder) const
+{
+	if(parameter.waveFormType == WaveFormType::Unknown) {
+		return &m_waveGenerator->getWaveForm();
+	}
+
+	auto& wp = PcmDataEnumerator::getWaveFormProperty(parameter.waveFormType);
+	holder.reset(wp.factory(getSampleDataType(), parameter.waveFormParameter));
+	return holder ? &holder->getWaveForm() : nullptr;
+}
+
+template<typename T>
+HRESULT PcmData<T>::setExactPeriod(size_t maxCycleDataSize)
+{
+	CriticalSection lock(m_cycleDataLock);
+
+	m_maxExactPeriodDataSize = maxCycleDataSize;
+	return S_OK;
+}
+
+template<typename T>
+HRESULT PcmData<T>::setRetuneMode(RetuneMode mode, size_t crossfadeFrames)
+{
+	CriticalSection lock(m_cycleDataLock);
+
+	m_retuneMode = mode;
+	m_crossfadeFrames = crossfadeFrames;
+	return S_OK;
+}
+
+template<typename T>
+HRESULT PcmData<T>::setLevel(float level, size_t rampFrames)
+{
+	CriticalSection lock(m_cycleDataLock);
+
+	publishLevel(level, rampFrames, m_generation);
+	return S_OK;
+}
+
+template<typename T>
+typename PcmData<T>::Level PcmData<T>::getLevel(size_t generation)
+{
+	typename EpochPtr<LevelState>::Reader state(m_levelState);
+
+	// Data of the previous generation might be read while the level of the next generation has been published.
+	return (generation < state->generation) ? state->previous : state->current;
+}
+
+template<typename T>
+void PcmData<T>::publishLevel(float level, size_t rampFrames, size_t generation)
+{
+	auto current = m_levelState.get();
+	std::unique_ptr<LevelState> state(new LevelState());
+	state->current = { limit(level), rampFrames };
+	state->previous = (current->generation < generation) ? current->current : current->previous;
+	state->generation = generation;
+	m_levelState.publish(std::move(state));
+}
+
+template<typename T>
+HRESULT PcmData<T>::setDither(DitherType dither)
+{
+	m_dither = dither;
+	return S_OK;
+}
+
+template<typename T>
+bool PcmData<T>::isFullScale(const Position& position, const Level& level) const
+{
+	if((m_dither.load() != DitherType::None) || (level.level != 1.0f)) { return false; }
+
+	// Ramp toward full scale should be completed.
+	auto gain = position.gain.load();
+	return (gain < 0) || ((gain == 1.0f) && (position.rampFrames.load() == 0));
+}
+
+template<typename T>
+typename PcmData<T>::Ramp PcmData<T>::ramp(Position& position, const Level& target, size_t frames) const
+{
+	auto level = target.level;
+	auto gain = position.gain.load();
+	if(gain < 0) {
+		// Start at the level without ramp.
+		gain = level;
+		position.rampLevel = level;
+	}
+	if(position.rampLevel.load() != level) {
+		// Level has been changed. Ramp gain linearly from current gain toward the level.
+		auto levelRampFrames = target.rampFrames;
+		position.rampLevel = level;
+		position.rampStep = levelRampFrames ? ((level - gain) / levelRampFrames) : 0.0f;
+		position.rampFrames = levelRampFrames;
+		if(!levelRampFrames) { gain = level; }
+	}
+
+	// If the ramp does not end in these frames, the next call continues the ramp.
+	auto remainingFrames = position.rampFrames.load();
+	Ramp ramp = { gain, position.rampStep.load(), min(remainingFrames, frames), gain };
+	if(ramp.frames) {
+		remainingFrames -= ramp.frames;
+		ramp.endGain = remainingFrames ? (gain + (ramp.step * ramp.frames)) : level;
+		position.rampFrames = remainingFrames;
+	}
+	position.gain = ramp.endGain;
+	return ramp;
+}
+
+template<typename T>
+void PcmData<T>::convert(Position& position, const Level& level, T* dest, const float* master, size_t samples) const
+{
+	auto gainRamp = ramp(position, level, samples / m_channels);
+	auto dither = (m_dither.load() == DitherType::TPDF) ? SimdKernel::Dither::TPDF : SimdKernel::Dither::None;
+	auto ditherIndex = position.ditherIndex.load();
+	const auto zero = (float)(double)ZeroValue;
+
+	if(gainRamp.frames) {
+		SimdKernel::convertRamp(dest, master, gainRamp.frames, m_channels, zero, Height, gainRamp.gain, gainRamp.step, dither, ditherIndex);
+	}
+	auto rampSamples = gainRamp.frames * m_channels;
+	SimdKernel::convert(&dest[rampSamples], &master[rampSamples], samples - rampSamples, zero, Height * gainRamp.endGain,
+						dither, ditherIndex + (UINT32)rampSamples);
+	position.ditherIndex = ditherIndex + (UINT32)samples;
+}
+
+template<typename T>
+void PcmData<T>::convertPlanar(Position& position, const Level& level, T* const* dest, size_t destFrame,
+								const float* master, size_t masterStride, size_t frames) const
+{
+	auto gainRamp = ramp(position, level, frames);
+	auto dither = (m_dither.load() == DitherType::TPDF) ? SimdKernel::Dither::TPDF : SimdKernel::Dither::None;
+	auto ditherIndex = position.ditherIndex.load();
+	const auto zero = (float)(double)ZeroValue;
+
+	// Each channel is converted contiguously with the same ramp.
+	// Dither index of channel c starts at c * frames, so that noise of channels is not correlated.
+	for(WORD channel = 0; channel < m_channels; channel++) {
+		auto channelDest = &dest[channel][destFrame];
+		auto channelMaster = &master[channel * masterStride];
+		auto index = ditherIndex + (UINT32)(channel * frames);
+		if(gainRamp.frames) {
+			SimdKernel::convertRamp(channelDest, channelMaster, gainRamp.frames, 1, zero, Height, gainRamp.gain, gainRamp.step, dither, index);
+		}
+		SimdKernel::convert(&channelDest[gainRamp.frames], &channelMaster[gainRamp.frames], frames - gainRamp.frames, zero, Height * gainRamp.endGain,
+							dither, index + (UINT32)gainRamp.frames);
+	}
+	position.ditherIndex = ditherIndex + (UINT32)(frames * m_channels);
+}
+
+template<typename T>
+void PcmData<T>::put(Position& position, const Level& level, const Destination& dest, size_t destFrame,
+						const float* master, size_t masterStride, size_t frames) const
+{
+	if(!dest.interleaved) {
+		return convertPlanar(position, level, dest.channels, destFrame, master, masterStride, frames);
+	}
+
+	// Master is interleaved in the buffer on the stack and converted to samples.
+	float buffer[ConvertBufferSamples];
+	const auto bufferFrames = ConvertBufferSamples / m_channels;
+	for(size_t frame = 0; frame < frames; frame += bufferFrames) {
+		auto count = min(frames - frame, bufferFrames);
+		SimdKernel::interleave(buffer, &master[frame], masterStride, m_channels, count);
+		convert(position, level, &dest.interleaved[(destFrame + frame) * m_channels], buffer, count * m_channels);
+	}
+}
+
+template<typename T>
+void PcmData<T>::start(const CycleData* cycleData, Position& position) const
+{
+	auto previous = cycleData->previous;
+	if(!previous || (position.generation.load() != previous->generation)) {
+		// Start from the beginning without crossfade.
+		position.position = 0;
+		position.crossfadedFrames = cycleData->crossfadeFrames;
+		position.generation = cycleData->generation;
+		return;
+	}
+
+	auto previousPosition = position.position.load() % previous->samplesPerCycle;
+
+	// Phase of previous data at current position, 0.0 <= phase < 1.0.
+	// Frame count of 1 cycle is samplesPerCycle / channels / cycles.
+	auto previousFrames = (double)(previous->samplesPerCycle / m_channels);
+	auto phase = (double)(previousPosition / m_channels) * previous->cycles / previousFrames;
+	phase -= floor(phase);
+
+	// Position of the same phase in the first cycle of new data.
+	auto frames = cycleData->samplesPerCycle / m_channels;
+	auto frame = (size_t)((phase * frames / cycleData->cycles) + 0.5) % frames;
+	position.position = frame * m_channels;
+	position.previousPosition = previousPosition;
+	position.crossfadedFrames = 0;
+	position.generation = cycleData->generation;
+}
+
+template<typename T>
+size_t PcmData<T>::crossfade(const CycleData* cycleData, Position& position, const Level& level, const Destination& dest) const
+{
+	auto previous = cycleData->previous;
+	auto crossfadedFrames = position.crossfadedFrames.load();
+	auto frames = min(cycleData->crossfadeFrames - crossfadedFrames, dest.frames);
+	auto fromFrames = previous->samplesPerCycle / m_channels;
+	auto toFrames = cycleData->samplesPerCycle / m_channels;
+	auto fromFrame = (position.previousPosition.load() % previous->samplesPerCycle) / m_channels;
+	auto toFrame = (position.position.load() % cycleData->samplesPerCycle) / m_channels;
+
+	// Weight of new data rises linearly and reaches 1.0 at the frame next to the end of crossfade.
+	// Masters of each channel are blended in the buffer on the stack as planar master and converted to samples.
+	auto step = 1.0 / (double)(cycleData->crossfadeFrames + 1);
+	float buffer[ConvertBufferSamples];
+	const auto bufferFrames = ConvertBufferSamples / m_channels;
+	for(size_t frame = 0; frame < frames; frame += bufferFrames) {
+		auto count = min(frames - frame, bufferFrames);
+		for(WORD channel = 0; channel < m_channels; channel++) {
+			auto from = &previous->master[channel * fromFrames];
+			auto to = &cycleData->master[channel * toFrames];
+			auto blend = &buffer[channel * count];
+			auto weight = step * (crossfadedFrames + frame);
+			auto f = fromFrame;
+			auto t = toFrame;
+			for(size_t i = 0; i < count; i++) {
+				weight += step;
+				auto a = (double)from[f];
+				auto b = (double)to[t];
+				blend[i] = (float)(a + ((b - a) * weight));
+				if(fromFrames <= ++f) { f = 0; }
+				if(toFrames <= ++t) { t = 0; }
+			}
+		}
+		put(position, level, dest, frame, buffer, count, count);
+		fromFrame = (fromFrame + count) % fromFrames;
+		toFrame = (toFrame + count) % toFrames;
+	}
+
+	position.previousPosition = fromFrame * m_channels;
+	position.position = toFrame * m_channels;
+	position.crossfadedFrames = crossfadedFrames + frames;
+	return frames;
+}
+
+template<typename T>
+size_t PcmData<T>::getPeriod(float key, size_t* pCycles) const
+{
+	// 1-cycle data rounded to integer frame count.
+	size_t frames = ceiling((size_t)(m_samplesPerSec * m_channels / key), m_channels) / m_channels;
+	size_t cycles = 1;
+
+	auto maxFrames = m_maxExactPeriodDataSize / getBlockAlign();
+	if(frames < maxFrames) {
+		// samplesPerSec/key as fraction of integers numerator/denominator.
+		// float key is binary fraction, so that it becomes integer by multiplying power of 2.
+		UINT64 numerator = m_samplesPerSec;
+		double denominator = key;
+		for(int i = 0; (i < 24) && (denominator != floor(denominator)); i++) {
+			numerator *= 2;
+			denominator *= 2;
+		}
+
+		// Find frames/cycles nearest to samplesPerSec/key within maxFrames, using convergents of continued fraction.
+		// If key is integer, the last convergent is (samplesPerSec / GCD) / (key / GCD).
+		auto error = [this, key](UINT64 f, UINT64 c) { return fabs(((double)m_samplesPerSec * c / f) - key); };
+		UINT64 n = numerator, d = (UINT64)denominator;
+		UINT64 h0 = 1, h1 = 0, k0 = 0, k1 = 1;
+		while(d) {
+			auto a = n / d;
+			auto h2 = (a * h0) + h1;
+			auto k2 = (a * k0) + k1;
+			if(maxFrames < h2) { break; }
+			if(h2 && (error(h2, k2) < error(frames, cycles))) {
+				frames = (size_t)h2;
+				cycles = (size_t)k2;
+			}
+			h1 = h0; h0 = h2;
+			k1 = k0; k0 = k2;
+			auto r = n % d;
+			n = d; d = r;
+		}
+	}
+
+	*pCycles = cycles;
+	return frames;
+}
+
+template<typename T>
+size_t PcmData<T>::getCycleDataSamples(size_t samplesPerCycle) const
+{
+	// Tile of blockSize allows copyTo() to copy blockSize from any position in the cycle by single memcpy().
+	// Note: Tiling to LCM(blockSize, cycle size) would not reduce count of memcpy() any more.
+	auto cycleDataSamples = samplesPerCycle + (m_blockSize / sizeof(T));
+	if(m_maxTiledDataSize < (cycleDataSamples * sizeof(T))) {
+		// Too large to be tiled.
+		cycleDataSamples = samplesPerCycle;
+	}
+	return cycleDataSamples;
+}
+
+template<typename T>
+void PcmData<T>::tile(T* cycleData, size_t samplesPerCycle, size_t cycleDataSamples) const
+{
+	if(samplesPerCycle < cycleDataSamples) {
+		size_t position = 0;
+		copyCyclicData(&cycleData[samplesPerCycle], (cycleDataSamples - samplesPerCycle) * sizeof(T),
+						cycleData, samplesPerCycle * sizeof(T), position);
 	}
 }
 
@@ -174,6 +940,33 @@ size_t PcmData<T>::getSampleBufferSize(size_t duration) const
 	}
 }
 
+template<typename T>
+void PcmData<T>::getWaveFormat(WAVEFORMATEXTENSIBLE& format) const
+{
+	format = {};
+	auto& wf = format.Format;
+	wf.wFormatTag = FormatTag;
+	wf.nChannels = m_channels;
+	wf.nSamplesPerSec = m_samplesPerSec;
+	wf.nBlockAlign = getBlockAlign();
+	wf.nAvgBytesPerSec = m_samplesPerSec * wf.nBlockAlign;
+	wf.wBitsPerSample = getBitsPerSample();
+	if(FormatTag == WAVE_FORMAT_EXTENSIBLE) {
+		wf.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+		format.Samples.wValidBitsPerSample = ValidBitsPerSample;
+		// Speaker positions are assigned to the channel counts that have standard layout.
+		// Other channel counts have no speaker position(dwChannelMask = 0).
+		switch(m_channels) {
+		case 1: format.dwChannelMask = KSAUDIO_SPEAKER_MONO; break;
+		case 2: format.dwChannelMask = KSAUDIO_SPEAKER_STEREO; break;
+		case 4: format.dwChannelMask = KSAUDIO_SPEAKER_QUAD; break;
+		case 6: format.dwChannelMask = KSAUDIO_SPEAKER_5POINT1; break;
+		case 8: format.dwChannelMask = KSAUDIO_SPEAKER_7POINT1_SURROUND; break;
+		}
+		format.SubFormat = KSDATAFORMAT_SUBTYPE_PCM;
+	}
+}
+
 template<typename T>
 size_t PcmData<T>::ceiling(size_t number, size_t significance) const
 {
@@ -185,155 +978,164 @@ size_t PcmData<T>::ceiling(size_t number, size_t significance) const
 }
 
 
-template<typename T>
-void WaveGenerator<T>::adjustLevel(float level, T* pHighValue, T* pLowValue, T* pZeroValue) const
-{
-	if(pHighValue) {
-		*pHighValue = (T)((PcmData<T>::HighValue - PcmData<T>::ZeroValue) * (double)level) + PcmData<T>::ZeroValue;
-	}
-	if(pLowValue) {
-		*pLowValue = PcmData<T>::ZeroValue - (T)((PcmData<T>::ZeroValue - PcmData<T>::LowValue) * (double)level);
-	}
-	if(pZeroValue) {
-		*pZeroValue = PcmData<T>::ZeroValue;
-	}
-}
-
 /*
- * SquareWaveGenerator class derived from WaveGenerator class.
- * 
- * Override of WaveGenerator::generate() method generates Square wave.
+ * SquareWaveForm class derived from WaveForm class.
+ *
+ * Generates Square wave.
  * This class exposes constructor that has duty parameter.
+ * If bandLimited is true, generate() method corrects 2 samples around each edge by PolyBLEP,
+ * that suppresses aliasing of harmonics above Nyquist frequency of the cycle data without oversampling.
+ * Oscillator uses band-limited mip levels of WaveTableCache instead.
  */
-template<typename T>
-class SquareWaveGenerator : public WaveGenerator<T>
+class SquareWaveForm : public WaveForm
 {
 public:
-	SquareWaveGenerator(float duty) : m_duty(limit(duty, 0.9f, 0.1f)) {}
+	SquareWaveForm(float duty, bool bandLimited = false) : m_duty(limit(duty, 0.9f, 0.1f)), m_bandLimited(bandLimited) {}
 
-	virtual IPcmData::WaveFormType getWaveFormType() const override { return IPcmData::WaveFormType::SquareWave; }
-	virtual const char* getWaveFormTypeName() const override { return IWaveGenerator::SquareWaveFormTypeName; }
-	virtual void generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level) override;
+	virtual IPcmData::WaveFormType getWaveFormType() const override;
+	virtual const char* getWaveFormTypeName() const override;
+	virtual double getParameter() const override { return m_duty; }
+	virtual bool isBandLimited() const override { return m_bandLimited; }
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const override;
 
 protected:
 	const float m_duty;
+	const bool m_bandLimited;
 };
 
-template<typename T>
-void SquareWaveGenerator<T>::generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level)
-{
-	T highValue, lowValue;
-	WaveGenerator<T>::adjustLevel(level, &highValue, &lowValue);
-	size_t highDuration = (size_t)(samplesPerCycle * m_duty);
-	size_t pos = 0;
-	for(; pos < highDuration; pos += channels) {
-		cycleData[pos] = highValue;
-	}
-	for(; pos < samplesPerCycle; pos += channels) {
-		cycleData[pos] = lowValue;
-	}
-}
-
 /*
- * SineWaveGenerator class derived from WaveGenerator class.
+ * SineWaveForm class derived from WaveForm class.
  *
- * Override of WaveGenerator::generate() method generates Sine wave.
+ * Generates Sine wave.
  */
-template<typename T>
-class SineWaveGenerator : public WaveGenerator<T>
+class SineWaveForm : public WaveForm
 {
 public:
 	virtual IPcmData::WaveFormType getWaveFormType() const override { return IPcmData::WaveFormType::SineWave; }
 	virtual const char* getWaveFormTypeName() const override { return IWaveGenerator::SineWaveFormTypeName; }
-	virtual void generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level) override;
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const override;
 };
 
-template<typename T>
-void SineWaveGenerator<T>::generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level)
-{
-	static const float pi = 3.141592f;
-	T highValue, zeroValue;
-	WaveGenerator<T>::adjustLevel(level, &highValue, nullptr, &zeroValue);
-	auto height = highValue - zeroValue;
-
-	for(size_t pos = 0; pos < samplesPerCycle; pos += channels) {
-		auto radian = 2 * pi * pos / samplesPerCycle;
-		cycleData[pos] = (T)((sin(radian) * height) + zeroValue);
-	}
-}
 /*
- * TriangleWaveGenerator class derived from WaveGenerator class.
+ * TriangleWaveForm class derived from WaveForm class.
  *
- * Override of WaveGenerator::generate() method generates Triangle wave.
+ * Generates Triangle wave.
  * This class exposes constructor that has peakPosition parameter.
  * If ((peakPosition <= 0.0f) || (1.0f <= peakPosition) || (0.5f == peakPosition)), generate() method generates Sawtooth wave.
+ * If bandLimited is true, generate() method corrects 2 samples around each corner by PolyBLAMP,
+ * or around the edge of Sawtooth wave by PolyBLEP, in the same way as SquareWaveForm class.
  */
-template<typename T>
-class TriangleWaveGenerator : public WaveGenerator<T>
+class TriangleWaveForm : public WaveForm
 {
 public:
-	TriangleWaveGenerator(float peakPosition) : m_peakPosition(limit(peakPosition)) {}
+	TriangleWaveForm(float peakPosition, bool bandLimited = false) : m_peakPosition(limit(peakPosition)), m_bandLimited(bandLimited) {}
 
-	virtual IPcmData::WaveFormType getWaveFormType() const override { return IPcmData::WaveFormType::TriangleWave; }
-	virtual const char* getWaveFormTypeName() const override { return IWaveGenerator::TriangleWaveFormTypeName; }
-	virtual void generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level) override;
+	virtual IPcmData::WaveFormType getWaveFormType() const override;
+	virtual const char* getWaveFormTypeName() const override;
+	virtual double getParameter() const override { return m_peakPosition; }
+	virtual bool isBandLimited() const override { return m_bandLimited; }
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const override;
 
 protected:
 	const float m_peakPosition;
+	const bool m_bandLimited;
 };
 
-template<typename T>
-void TriangleWaveGenerator<T>::generate(T* cycleData, size_t samplesPerCycle, WORD channels, float level)
-{
-	T highValue, lowValue, zeroValue;
-	WaveGenerator<T>::adjustLevel(level, &highValue, &lowValue, &zeroValue);
-	double height = (double)highValue - (double)lowValue;
-	double upDelta, downDelta;
-	upDelta = downDelta = height * channels / samplesPerCycle;
-	bool up;
-	double value;
-	if(m_peakPosition == 0.0f) {
-		upDelta = height;
-		up = false;
-		value = highValue;
-	} else if(m_peakPosition == 1.0f) {
-		downDelta = height;
-		up = true;
-		value = lowValue;
-	} else if(m_peakPosition == 0.5f) {
-		downDelta = height;
-		up = true;
-		value = zeroValue;
-	} else if(m_peakPosition < 0.5f) {
-		upDelta /= (m_peakPosition * 2);
-		downDelta /= (1.0f - (m_peakPosition * 2));
-		up = true;
-		value = zeroValue;
-	} else {
-		upDelta /= (1.0f - ((1 - m_peakPosition) * 2));
-		downDelta /= ((1 - m_peakPosition) * 2);
-		up = false;
-		value = zeroValue;
-	}
+/*
+ * DualToneWaveForm class derived from WaveForm class.
+ *
+ * Generates dual tone of a digit of DTMF or MF(R1) signalling.
+ * Frequencies of the tones are defined by the digit, and DualTonePcmData class renders them
+ * from exact-period tables at the sample rate, ignoring the key.
+ * generate() method is used to make wave table of another IPcmData, in which case the low tone has the key
+ * and the high tone is rounded to the nearest harmonic of the key / cycles.
+ * Each tone has half of the height so that the sum does not exceed +-1.0.
+ */
+class DualToneWaveForm : public WaveForm
+{
+public:
+	// Frequencies of 2 tones of a digit.
+	struct Digit
+	{
+		char digit;
+		WORD lowFrequency;
+		WORD highFrequency;
+	};
 
-	if((lowValue + upDelta) > highValue) { upDelta = height; }
-	if((highValue - downDelta) < lowValue) { downDelta = height; }
+	// digit is index of the digit in PcmDataEnumerator::getDigits(type).
+	DualToneWaveForm(IPcmData::WaveFormType type, float digit);
 
-	for(size_t pos = 0; pos < samplesPerCycle; pos += channels) {
-		cycleData[pos] = (T)value;
-		if(up) {
-			value += upDelta;
-			if(highValue <= value) {
-				value = highValue;
-				up = false;
-			}
-		}
-		else {
-			value -= downDelta;
-			if(value <= lowValue) {
-				value = lowValue;
-				up = true;
-			}
-		}
-	}
-}
+	virtual IPcmData::WaveFormType getWaveFormType() const override { return m_type; }
+	virtual const char* getWaveFormTypeName() const override;
+	// Returns character of the digit.
+	virtual double getParameter() const override { return m_digit.digit; }
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const override;
+
+	// Digit passed to the constructor.
+	const Digit& getDigit() const { return m_digit; }
+
+	// Returns digits of the signalling, or empty vector for other wave forms.
+	static const std::vector<Digit>& getDigits(IPcmData::WaveFormType type);
+	// Returns digit of the character(case insensitive), or nullptr if the signalling does not have it.
+	static const Digit* findDigit(IPcmData::WaveFormType type, char digit);
+	// Returns all frequencies used by digits of the signalling.
+	static std::vector<WORD> getFrequencies(IPcmData::WaveFormType type);
+
+protected:
+	const IPcmData::WaveFormType m_type;
+	const Digit m_digit;
+};
+
+/*
+ * NoiseWaveForm class derived from WaveForm class.
+ *
+ * Generates white or pink noise from the seed by SimdKernel::whiteNoise() or SimdKernel::pinkNoise().
+ * NoisePcmData class synthesizes the stream of the noise that does not repeat, ignoring the key.
+ * generate() method is used to make wave table of another IPcmData, in which case the cycle is a block of the noise.
+ */
+class NoiseWaveForm : public WaveForm
+{
+public:
+	// seed is converted to UINT32.
+	NoiseWaveForm(IPcmData::WaveFormType type, float seed);
+
+	virtual IPcmData::WaveFormType getWaveFormType() const override { return m_type; }
+	virtual const char* getWaveFormTypeName() const override;
+	virtual double getParameter() const override { return m_seed; }
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const override;
+
+	// Seed passed to the constructor.
+	UINT32 getSeed() const { return m_seed; }
+
+	// Generates count samples of the noise from the index of the stream of the seed.
+	void generate(float* dest, size_t count, UINT32 seed, UINT32 index, float height) const;
+
+protected:
+	const IPcmData::WaveFormType m_type;
+	const UINT32 m_seed;
+};
+
+/*
+ * MlsWaveForm class derived from WaveForm class.
+ *
+ * Generates maximum length sequence of the order.
+ * MlsPcmData class copies 1 period of the sequence as cycle data, ignoring the key.
+ * generate() method is used to make wave table of another IPcmData, in which case the sequence is truncated or repeated.
+ */
+class MlsWaveForm : public WaveForm
+{
+public:
+	// order is limited to MaximumLengthSequence::MinOrder ~ MaximumLengthSequence::MaxOrder.
+	MlsWaveForm(float order)
+		: m_sequence((int)limit(order, (float)MaximumLengthSequence::MaxOrder, (float)MaximumLengthSequence::MinOrder)) {}
+
+	virtual IPcmData::WaveFormType getWaveFormType() const override { return IPcmData::WaveFormType::MLS; }
+	virtual const char* getWaveFormTypeName() const override { return IWaveGenerator::MlsWaveFormTypeName; }
+	virtual double getParameter() const override { return m_sequence.getOrder(); }
+	virtual void generate(float* master, size_t samplesPerCycle, WORD channels, size_t cycles) const override;
+
+	const MaximumLengthSequence& getSequence() const { return m_sequence; }
+
+protected:
+	const MaximumLengthSequence m_sequence;
+};
@@ -90,6 +90,7 @@ public:
 //   Note:
 //		This function should be called after IPcmData::generate() that creates internal buffer.
 //		After IPcmData::generate() is called again, re-create IPcmSample object because the method re-creates the internal buffer.
+//		Returns nullptr if IPcmData::getSynthesisMode() is not SynthesisMode::CycleTable.
 IPcmSample* createPcmSample(std::shared_ptr<IPcmData>& pcmData);
 
 // Creates IPcmSample object to access buffer specified as arguments.
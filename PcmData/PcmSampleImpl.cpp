@@ -4,6 +4,7 @@ IPcmSample* createPcmSample(std::shared_ptr<IPcmData>& pcmData)
 {
 	if(!pcmData) return nullptr;
 	if(!pcmData->getSamplesPerCycle()) return nullptr;	// pcmData->generate() has not been called.
+	if(pcmData->getSynthesisMode() != IPcmData::SynthesisMode::CycleTable) return nullptr;	// pcmData does not have 1-cycle data.
 
 	switch(pcmData->getSampleDataType()) {
 	case IPcmData::SampleDataType::PCM_8bits:
@@ -14,6 +15,12 @@ IPcmSample* createPcmSample(std::shared_ptr<IPcmData>& pcmData)
 		return new PcmSampleImpl<INT24>(pcmData);
 	case IPcmData::SampleDataType::IEEE_Float:
 		return new PcmSampleImpl<float>(pcmData);
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		return new PcmSampleImpl<INT24in32>(pcmData);
+	case IPcmData::SampleDataType::PCM_32bits:
+		return new PcmSampleImpl<INT32>(pcmData);
+	case IPcmData::SampleDataType::IEEE_Double:
+		return new PcmSampleImpl<double>(pcmData);
 	default:
 		return nullptr;
 	}
@@ -30,6 +37,12 @@ IPcmSample* createPcmSample(IPcmData::SampleDataType sampleDataType, void* buffe
 		return createPcmSample<INT24>(buffer, size);
 	case IPcmData::SampleDataType::IEEE_Float:
 		return createPcmSample<float>(buffer, size);
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		return createPcmSample<INT24in32>(buffer, size);
+	case IPcmData::SampleDataType::PCM_32bits:
+		return createPcmSample<INT32>(buffer, size);
+	case IPcmData::SampleDataType::IEEE_Double:
+		return createPcmSample<double>(buffer, size);
 	default:
 		return nullptr;
 	}
@@ -55,6 +68,12 @@ template<typename T>
 		return HighValue<INT24>;
 	case IPcmData::SampleDataType::IEEE_Float:
 		return HighValue<float>;
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		return HighValue<INT24in32>;
+	case IPcmData::SampleDataType::PCM_32bits:
+		return HighValue<INT32>;
+	case IPcmData::SampleDataType::IEEE_Double:
+		return HighValue<double>;
 	default:
 		{
 			static Value value;
@@ -74,6 +93,12 @@ template<typename T>
 		return ZeroValue<INT24>;
 	case IPcmData::SampleDataType::IEEE_Float:
 		return ZeroValue<float>;
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		return ZeroValue<INT24in32>;
+	case IPcmData::SampleDataType::PCM_32bits:
+		return ZeroValue<INT32>;
+	case IPcmData::SampleDataType::IEEE_Double:
+		return ZeroValue<double>;
 	default:
 		{
 			static Value value;
@@ -93,6 +118,12 @@ template<typename T>
 		return LowValue<INT24>;
 	case IPcmData::SampleDataType::IEEE_Float:
 		return LowValue<float>;
+	case IPcmData::SampleDataType::PCM_24bits_in_32:
+		return LowValue<INT24in32>;
+	case IPcmData::SampleDataType::PCM_32bits:
+		return LowValue<INT32>;
+	case IPcmData::SampleDataType::IEEE_Double:
+		return LowValue<double>;
 	default:
 		{
 			static Value value;
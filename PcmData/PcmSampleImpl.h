@@ -111,6 +111,14 @@ std::string ValueHelper<float>::toString(const Handle& handle) const
 	return s;
 }
 
+template<>
+std::string ValueHelper<double>::toString(const Handle& handle) const
+{
+	char s[30] = "";
+	_gcvt_s(s, getSample(handle), 17);
+	return s;
+}
+
 template<typename T>
 void ValueHelper<T>::setInt32(const Handle& to, INT32 value)
 {
@@ -144,6 +152,12 @@ bool ValueHelper<float>::isFloat() const
 	return true;
 }
 
+template<>
+bool ValueHelper<double>::isFloat() const
+{
+	return true;
+}
+
 }
 
 // Default Value constructor using NullValueHelper.
@@ -245,8 +259,12 @@ PcmSampleImpl<T>::PcmSampleImpl(std::shared_ptr <IPcmData>& pcmData)
 	, m_buffer(nullptr), m_sampleCount(0)
 {
 	if(m_pcmData) {
-		m_buffer = m_pcmData->m_cycleData.get();
-		m_sampleCount = m_pcmData->getSamplesPerCycle();
+		// Note: Cycle data is valid until generate() method is called next time.
+		auto cycleData = m_pcmData->m_cycleData.get();
+		if(cycleData) {
+			m_buffer = cycleData->samples.get();
+			m_sampleCount = cycleData->samplesPerCycle;
+		}
 	}
 }
 
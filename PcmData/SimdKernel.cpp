@@ -0,0 +1,1122 @@
+#include "SimdKernelImpl.h"
+
+#include <intrin.h>
+#include <emmintrin.h>
+#include <type_traits>
+
+#pragma region Instruction set selection.
+
+static SimdKernel::InstructionSet detectInstructionSet()
+{
+	int info[4];
+	__cpuid(info, 0);
+	auto maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	auto instructionSet = SimdKernel::InstructionSet::Scalar;
+	if(info[3] & (1 << 26)) { instructionSet = SimdKernel::InstructionSet::SSE2; }
+	if((info[3] & (1 << 26)) && (info[2] & (1 << 9))) { instructionSet = SimdKernel::InstructionSet::SSSE3; }
+
+	// AVX2 requires that the OS saves YMM registers(OSXSAVE and XCR0 bit 1, 2).
+	auto osxsave = (info[2] & (1 << 27)) != 0;
+	auto avx = (info[2] & (1 << 28)) != 0;
+	if((7 <= maxLeaf) && osxsave && avx && ((_xgetbv(0) & 6) == 6)) {
+		__cpuidex(info, 7, 0);
+		if(info[1] & (1 << 5)) { instructionSet = SimdKernel::InstructionSet::AVX2; }
+	}
+	return instructionSet;
+}
+
+static SimdKernel::InstructionSet currentInstructionSet = SimdKernel::getSupportedInstructionSet();
+
+SimdKernel::InstructionSet SimdKernel::getInstructionSet()
+{
+	return currentInstructionSet;
+}
+
+SimdKernel::InstructionSet SimdKernel::getSupportedInstructionSet()
+{
+	static const auto supportedInstructionSet = detectInstructionSet();
+	return supportedInstructionSet;
+}
+
+void SimdKernel::setInstructionSet(InstructionSet instructionSet)
+{
+	currentInstructionSet = min(instructionSet, getSupportedInstructionSet());
+}
+
+const char* SimdKernel::getInstructionSetName(InstructionSet instructionSet)
+{
+	switch(instructionSet) {
+	case InstructionSet::Scalar: return "Scalar";
+	case InstructionSet::SSE2: return "SSE2";
+	case InstructionSet::SSSE3: return "SSSE3";
+	case InstructionSet::AVX2: return "AVX2";
+	default: return "Unknown";
+	}
+}
+
+#pragma endregion
+
+#pragma region Kernels.
+
+// SSSE3 implementation exists for INT24 only, and other types use SSE2 implementation.
+template<typename T>
+static void convertSSSE3(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex)
+{
+	SSE2Kernel::convert(dest, src, count, zero, height, dither, ditherIndex);
+}
+
+static void convertSSSE3(INT24* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex)
+{
+	SSSE3Kernel::convert(dest, src, count, zero, height, dither, ditherIndex);
+}
+
+// Measured by SimdKernelUnitTest.sineAccuracy for all instruction sets.
+// Most of the error comes from float precision of the position in the cycle.
+const float SimdKernel::SineMaxError = 5e-7f;
+
+void SimdKernel::sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height)
+{
+	// Position in the cycle is calculated by 32-bit signed integer in SIMD kernels.
+	if(frames < 0x40000000) {
+		switch(currentInstructionSet) {
+		case InstructionSet::AVX2:
+			return AVX2Kernel::sine(dest, stride, frames, cycles, zero, height);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return SSE2Kernel::sine(dest, stride, frames, cycles, zero, height);
+		default:
+			break;
+		}
+	}
+	ScalarKernel::sine(dest, stride, frames, cycles, zero, height);
+}
+
+void SimdKernel::square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low)
+{
+	if(frames < 0x40000000) {
+		switch(currentInstructionSet) {
+		case InstructionSet::AVX2:
+			return AVX2Kernel::square(dest, stride, frames, cycles, highFrames, high, low);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return SSE2Kernel::square(dest, stride, frames, cycles, highFrames, high, low);
+		default:
+			break;
+		}
+	}
+	ScalarKernel::square(dest, stride, frames, cycles, highFrames, high, low);
+}
+
+void SimdKernel::triangle(float* dest, size_t stride, size_t frames, size_t cycles, float peakPosition,
+							float zero, float positiveHeight, float negativeHeight)
+{
+	TriangleShape shape(peakPosition);
+	if(frames < 0x40000000) {
+		switch(currentInstructionSet) {
+		case InstructionSet::AVX2:
+			return AVX2Kernel::triangle(dest, stride, frames, cycles, shape, zero, positiveHeight, negativeHeight);
+		case InstructionSet::SSSE3:
+		case InstructionSet::SSE2:
+			return SSE2Kernel::triangle(dest, stride, frames, cycles, shape, zero, positiveHeight, negativeHeight);
+		default:
+			break;
+		}
+	}
+	ScalarKernel::triangle(dest, stride, frames, cycles, shape, zero, positiveHeight, negativeHeight);
+}
+
+template<typename T>
+void SimdKernel::convert(T* dest, const float* src, size_t count, float zero, float height, Dither dither, UINT32 ditherIndex)
+{
+	// Float samples have enough resolution without dither.
+	auto useDither = (dither == Dither::TPDF) && !std::is_floating_point<T>::value;
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::convert(dest, src, count, zero, height, useDither, ditherIndex);
+	case InstructionSet::SSSE3:
+		return convertSSSE3(dest, src, count, zero, height, useDither, ditherIndex);
+	case InstructionSet::SSE2:
+		return SSE2Kernel::convert(dest, src, count, zero, height, useDither, ditherIndex);
+	default:
+		break;
+	}
+	ScalarKernel::convert(dest, src, count, zero, height, useDither, ditherIndex);
+}
+
+void SimdKernel::packInt24(INT24* dest, const INT32* src, size_t count)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::packInt24(dest, src, count);
+	case InstructionSet::SSSE3:
+		return SSSE3Kernel::packInt24(dest, src, count);
+	default:
+		break;
+	}
+	ScalarKernel::packInt24(dest, src, count);
+}
+
+void SimdKernel::unpackInt24(INT32* dest, const INT24* src, size_t count)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::unpackInt24(dest, src, count);
+	case InstructionSet::SSSE3:
+		return SSSE3Kernel::unpackInt24(dest, src, count);
+	default:
+		break;
+	}
+	ScalarKernel::unpackInt24(dest, src, count);
+}
+
+void SimdKernel::unpackInt24(float* dest, const INT24* src, size_t count, float scale)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::unpackInt24(dest, src, count, scale);
+	case InstructionSet::SSSE3:
+		return SSSE3Kernel::unpackInt24(dest, src, count, scale);
+	default:
+		break;
+	}
+	ScalarKernel::unpackInt24(dest, src, count, scale);
+}
+
+void SimdKernel::interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::interleave(dest, src, srcStride, channels, frames);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::interleave(dest, src, srcStride, channels, frames);
+	default:
+		break;
+	}
+	ScalarKernel::interleave(dest, src, srcStride, channels, frames);
+}
+
+void SimdKernel::add(float* dest, const float* src1, const float* src2, size_t count)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::add(dest, src1, src2, count);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::add(dest, src1, src2, count);
+	default:
+		break;
+	}
+	ScalarKernel::add(dest, src1, src2, count);
+}
+
+void SimdKernel::whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::whiteNoise(dest, count, seed, index, height);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::whiteNoise(dest, count, seed, index, height);
+	default:
+		break;
+	}
+	ScalarKernel::whiteNoise(dest, count, seed, index, height);
+}
+
+void SimdKernel::pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::pinkNoise(dest, count, seed, index, height);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::pinkNoise(dest, count, seed, index, height);
+	default:
+		break;
+	}
+	ScalarKernel::pinkNoise(dest, count, seed, index, height);
+}
+
+void SimdKernel::expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::expandBits(dest, bits, index, count, one, zero);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::expandBits(dest, bits, index, count, one, zero);
+	default:
+		break;
+	}
+	ScalarKernel::expandBits(dest, bits, index, count, one, zero);
+}
+
+void SimdKernel::hadamard(float* data, size_t size)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::hadamard(data, size);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::hadamard(data, size);
+	default:
+		break;
+	}
+	ScalarKernel::hadamard(data, size);
+}
+
+void SimdKernel::chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::chirp(dest, frames, phase, rate, shape, curve, height);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::chirp(dest, frames, phase, rate, shape, curve, height);
+	default:
+		break;
+	}
+	ScalarKernel::chirp(dest, frames, phase, rate, shape, curve, height);
+}
+
+void SimdKernel::oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::oscillatorBank(dest, frames, tables, tableOffsets, phases, deltas, levels, oscillators);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::oscillatorBank(dest, frames, tables, tableOffsets, phases, deltas, levels, oscillators);
+	default:
+		break;
+	}
+	ScalarKernel::oscillatorBank(dest, frames, tables, tableOffsets, phases, deltas, levels, oscillators);
+}
+
+void SimdKernel::oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level)
+{
+	switch(currentInstructionSet) {
+	case InstructionSet::AVX2:
+		return AVX2Kernel::oscillator(dest, frames, table, phase, delta, level);
+	case InstructionSet::SSSE3:
+	case InstructionSet::SSE2:
+		return SSE2Kernel::oscillator(dest, frames, table, phase, delta, level);
+	default:
+		break;
+	}
+	ScalarKernel::oscillator(dest, frames, table, phase, delta, level);
+}
+
+template<typename T>
+void SimdKernel::convertRamp(T* dest, const float* src, size_t frames, size_t channels, float zero, float height,
+							float startGain, float step, Dither dither, UINT32 ditherIndex)
+{
+	auto useDither = (dither == Dither::TPDF) && !std::is_floating_point<T>::value;
+	for(size_t frame = 0; frame < frames; frame++) {
+		auto frameHeight = height * (startGain + (step * (frame + 1)));
+		for(size_t channel = 0; channel < channels; channel++) {
+			auto noise = useDither ? ditherNoise(ditherIndex) : 0.0f;
+			*(dest++) = convertSample<T>(*(src++), zero, frameHeight, noise);
+			ditherIndex++;
+		}
+	}
+}
+
+void SimdKernel::polyBlep(float* dest, size_t stride, size_t frames, size_t cycles, double edge, float jump, float slopeChange)
+{
+	if((frames == 0) || (cycles == 0)) { return; }
+
+	// Slope in value per frame.
+	auto slope = (double)slopeChange * cycles / frames;
+	auto residual = [jump, slope](double d) {
+		auto x = (d < 0) ? (1 + d) : (1 - d);
+		return (float)((((d < 0) ? jump : -jump) * x * x / 2) + (slope * x * x * x / 6));
+	};
+
+	// Position of the discontinuity ((cycle * frames) + edge) / cycles is frame + ((remainder + fraction) / cycles).
+	// frame and remainder are advanced by integer for each cycle without division,
+	// so that the frame at the edge has d == 0 exactly.
+	auto integer = (size_t)edge;
+	auto fraction = edge - integer;
+	auto frame = integer / cycles;
+	auto remainder = integer % cycles;
+	auto step = frames / cycles;
+	auto stepRemainder = frames % cycles;
+	auto scale = 1.0 / cycles;
+	for(size_t cycle = 0; cycle < cycles; cycle++) {
+		auto d = -(remainder + fraction) * scale;
+		// Position is less than frames, and the next frame wraps around to the first frame.
+		auto next = (frame + 1 < frames) ? (frame + 1) : 0;
+		dest[frame * stride] += residual(d);
+		dest[next * stride] += residual(d + 1);
+
+		frame += step;
+		remainder += stepRemainder;
+		if(cycles <= remainder) {
+			remainder -= cycles;
+			frame++;
+		}
+	}
+}
+
+TriangleShape::TriangleShape(float peakPosition)
+	: shift(0), slope1(2), intercept1(-1), slope2(0), intercept2(2), sign(1)
+{
+	// Default is Sawtooth wave rising from -1.0 to +1.0(peakPosition == 1.0).
+	// Line 2 is constant +2.0 and never selected by min().
+	double p = peakPosition;
+	if(p == 0.0) {
+		// Sawtooth wave falling from +1.0 to -1.0.
+		slope1 = -2;
+		intercept1 = 1;
+	} else if(p == 0.5) {
+		// Sawtooth wave starting at 0.0.
+		shift = 0.5f;
+	} else if(p != 1.0) {
+		// Triangle wave starting at 0.0.
+		// peakPosition > 0.5 is upside-down wave of (1 - peakPosition).
+		if(0.5 < p) {
+			p = 1 - p;
+			sign = -1;
+		}
+		// u = 0 at -1.0, u = 2p at peak(+1.0).
+		shift = (float)p;
+		slope1 = (float)(1 / p);
+		slope2 = (float)(-2 / (1 - (2 * p)));
+		intercept2 = (float)(1 + (4 * p / (1 - (2 * p))));
+	}
+}
+
+// Returns sin(pi / 2 * q), 0.0 <= q <= 4.0, using quarter-wave symmetry.
+//   Quadrant 0: sin(pi / 2 * t), t = q
+//   Quadrant 1: sin(pi / 2 * (1 - t))
+//   Quadrant 2: -sin(pi / 2 * t)
+//   Quadrant 3: -sin(pi / 2 * (1 - t))
+// SIMD kernels perform same operations in same order, so that results are identical.
+static float sineQuarter(float q)
+{
+	auto quadrant = (INT32)q;
+	auto r = q - (float)quadrant;
+	auto t = (quadrant & 1) ? (1.0f - r) : r;
+	auto t2 = t * t;
+	auto p = SineC11;
+	p = (p * t2) + SineC9;
+	p = (p * t2) + SineC7;
+	p = (p * t2) + SineC5;
+	p = (p * t2) + SineC3;
+	p = (p * t2) + SineC1;
+	auto s = p * t;
+	return (quadrant & 2) ? -s : s;
+}
+
+namespace
+{
+
+// Position in the cycle, (frame * cycles) % frames.
+// Calculated by integer without accumulating error.
+class Position
+{
+public:
+	Position(size_t frames, size_t cycles) : value(0), m_frames(frames), m_cycles(cycles % frames) {}
+
+	size_t value;
+
+	void next() {
+		value += m_cycles;
+		if(m_frames <= value) { value -= m_frames; }
+	}
+
+protected:
+	const size_t m_frames;
+	const size_t m_cycles;
+};
+
+// Position in the cycle of each lane, advanced by 4 frames.
+class PositionSSE2
+{
+public:
+	static const size_t Lanes = 4;
+
+	PositionSSE2(size_t frames, size_t cycles)
+		: m_step(_mm_set1_epi32((INT32)(((cycles % frames) * Lanes) % frames)))
+		, m_lastPosition(_mm_set1_epi32((INT32)(frames - 1)))
+		, m_frames(_mm_set1_epi32((INT32)frames))
+	{
+		alignas(16) INT32 initialValue[Lanes];
+		for(size_t i = 0; i < Lanes; i++) {
+			initialValue[i] = (INT32)(((cycles % frames) * i) % frames);
+		}
+		value = _mm_load_si128((const __m128i*)initialValue);
+	}
+
+	__m128i value;
+
+	void next() {
+		// Wrap around if the position exceeds the last position.
+		value = _mm_add_epi32(value, m_step);
+		auto wrap = _mm_cmpgt_epi32(value, m_lastPosition);
+		value = _mm_sub_epi32(value, _mm_and_si128(wrap, m_frames));
+	}
+
+protected:
+	const __m128i m_step;
+	const __m128i m_lastPosition;
+	const __m128i m_frames;
+};
+
+// Returns a if mask is set, otherwise b.
+inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Stores 4 float values as samples, rounding and saturating integer.
+// Values passed to store() should be clamped to SampleLimit<T> already.
+template<typename T>
+struct SampleVectorSSE2
+{
+	static void store(T* dest, __m128 values) {
+		alignas(16) INT32 v[4];
+		_mm_store_si128((__m128i*)v, _mm_cvtps_epi32(values));
+		for(int i = 0; i < 4; i++) { dest[i] = (T)v[i]; }
+	}
+};
+
+template<>
+struct SampleVectorSSE2<UINT8>
+{
+	static void store(UINT8* dest, __m128 values) {
+		auto v = _mm_packs_epi32(_mm_cvtps_epi32(values), _mm_setzero_si128());
+		*(int*)dest = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+	}
+};
+
+template<>
+struct SampleVectorSSE2<INT16>
+{
+	static void store(INT16* dest, __m128 values) {
+		auto v = _mm_cvtps_epi32(values);
+		_mm_storel_epi64((__m128i*)dest, _mm_packs_epi32(v, v));
+	}
+};
+
+template<>
+struct SampleVectorSSE2<INT24>
+{
+	static void store(INT24* dest, __m128 values) {
+		auto p = (BYTE*)dest;
+		alignas(16) INT32 v[4];
+		_mm_store_si128((__m128i*)v, _mm_cvtps_epi32(values));
+		// Each 32-bit store overwrites the 4th byte, that is written by the next store.
+		for(int i = 0; i < 3; i++, p += 3) {
+			memcpy(p, &v[i], 4);
+		}
+		p[0] = (BYTE)v[3];
+		p[1] = (BYTE)(v[3] >> 8);
+		p[2] = (BYTE)(v[3] >> 16);
+	}
+};
+
+// Value is shifted to the high 24 bits of the container.
+template<>
+struct SampleVectorSSE2<INT24in32>
+{
+	static void store(INT24in32* dest, __m128 values) {
+		_mm_storeu_si128((__m128i*)dest, _mm_slli_epi32(_mm_cvtps_epi32(values), 8));
+	}
+};
+
+template<>
+struct SampleVectorSSE2<float>
+{
+	static void store(float* dest, __m128 values) { _mm_storeu_ps(dest, values); }
+};
+
+template<>
+struct SampleVectorSSE2<INT32>
+{
+	static void store(INT32* dest, __m128 values) { _mm_storeu_si128((__m128i*)dest, _mm_cvtps_epi32(values)); }
+};
+
+template<>
+struct SampleVectorSSE2<double>
+{
+	static void store(double* dest, __m128 values) {
+		_mm_storeu_pd(dest, _mm_cvtps_pd(values));
+		_mm_storeu_pd(&dest[2], _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+	}
+};
+
+}
+
+void ScalarKernel::sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height)
+{
+	if(frames == 0) { return; }
+
+	const float scale = 4.0f / (float)frames;
+	Position position(frames, cycles);
+	for(size_t frame = 0; frame < frames; frame++) {
+		dest[frame * stride] = (sineQuarter((float)position.value * scale) * height) + zero;
+		position.next();
+	}
+}
+
+void ScalarKernel::square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low)
+{
+	if(frames == 0) { return; }
+
+	Position position(frames, cycles);
+	for(size_t frame = 0; frame < frames; frame++) {
+		dest[frame * stride] = (position.value < highFrames) ? high : low;
+		position.next();
+	}
+}
+
+void ScalarKernel::triangle(float* dest, size_t stride, size_t frames, size_t cycles, const TriangleShape& shape,
+							float zero, float positiveHeight, float negativeHeight)
+{
+	if(frames == 0) { return; }
+
+	const float scale = 1.0f / (float)frames;
+	Position position(frames, cycles);
+	for(size_t frame = 0; frame < frames; frame++) {
+		auto u = ((float)position.value * scale) + shape.shift;
+		if(1.0f <= u) { u -= 1.0f; }
+		auto line1 = (shape.slope1 * u) + shape.intercept1;
+		auto line2 = (shape.slope2 * u) + shape.intercept2;
+		auto value = ((line1 < line2) ? line1 : line2) * shape.sign;
+		dest[frame * stride] = (value * ((0.0f <= value) ? positiveHeight : negativeHeight)) + zero;
+		position.next();
+	}
+}
+
+void SSE2Kernel::sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height)
+{
+	static const size_t Lanes = PositionSSE2::Lanes;
+	if(frames == 0) { return; }
+
+	// Each lane processes every 4th frame.
+	PositionSSE2 position(frames, cycles);
+	const auto scale = _mm_set1_ps(4.0f / (float)frames);
+	const auto oneInt = _mm_set1_epi32(1);
+	const auto twoInt = _mm_set1_epi32(2);
+	const auto one = _mm_set1_ps(1.0f);
+	const auto heightVector = _mm_set1_ps(height);
+	const auto zeroVector = _mm_set1_ps(zero);
+
+	alignas(16) float values[Lanes];
+	for(size_t frame = 0; frame < frames; frame += Lanes) {
+		auto q = _mm_mul_ps(_mm_cvtepi32_ps(position.value), scale);
+		auto quadrant = _mm_cvttps_epi32(q);
+		auto r = _mm_sub_ps(q, _mm_cvtepi32_ps(quadrant));
+		auto odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, oneInt), oneInt));
+		auto t = select(odd, _mm_sub_ps(one, r), r);
+		auto t2 = _mm_mul_ps(t, t);
+		auto p = _mm_set1_ps(SineC11);
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC9));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC7));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC5));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC3));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC1));
+		auto s = _mm_mul_ps(p, t);
+		// Negate in quadrant 2 and 3 by flipping sign bit.
+		s = _mm_xor_ps(s, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, twoInt), 30)));
+
+		_mm_store_ps(values, _mm_add_ps(_mm_mul_ps(s, heightVector), zeroVector));
+		storeValues(&dest[frame * stride], stride, values, min(frames - frame, Lanes));
+		position.next();
+	}
+}
+
+void SSE2Kernel::square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low)
+{
+	static const size_t Lanes = PositionSSE2::Lanes;
+	if(frames == 0) { return; }
+
+	PositionSSE2 position(frames, cycles);
+	const auto highFramesVector = _mm_set1_epi32((INT32)min(highFrames, frames));
+	const auto highVector = _mm_set1_ps(high);
+	const auto lowVector = _mm_set1_ps(low);
+
+	alignas(16) float values[Lanes];
+	for(size_t frame = 0; frame < frames; frame += Lanes) {
+		auto isHigh = _mm_castsi128_ps(_mm_cmplt_epi32(position.value, highFramesVector));
+		_mm_store_ps(values, select(isHigh, highVector, lowVector));
+		storeValues(&dest[frame * stride], stride, values, min(frames - frame, Lanes));
+		position.next();
+	}
+}
+
+void SSE2Kernel::triangle(float* dest, size_t stride, size_t frames, size_t cycles, const TriangleShape& shape,
+							float zero, float positiveHeight, float negativeHeight)
+{
+	static const size_t Lanes = PositionSSE2::Lanes;
+	if(frames == 0) { return; }
+
+	PositionSSE2 position(frames, cycles);
+	const auto scale = _mm_set1_ps(1.0f / (float)frames);
+	const auto one = _mm_set1_ps(1.0f);
+	const auto zeroFloat = _mm_setzero_ps();
+	const auto shift = _mm_set1_ps(shape.shift);
+	const auto slope1 = _mm_set1_ps(shape.slope1);
+	const auto intercept1 = _mm_set1_ps(shape.intercept1);
+	const auto slope2 = _mm_set1_ps(shape.slope2);
+	const auto intercept2 = _mm_set1_ps(shape.intercept2);
+	const auto sign = _mm_set1_ps(shape.sign);
+	const auto positiveHeightVector = _mm_set1_ps(positiveHeight);
+	const auto negativeHeightVector = _mm_set1_ps(negativeHeight);
+	const auto zeroVector = _mm_set1_ps(zero);
+
+	alignas(16) float values[Lanes];
+	for(size_t frame = 0; frame < frames; frame += Lanes) {
+		auto u = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(position.value), scale), shift);
+		u = _mm_sub_ps(u, _mm_and_ps(_mm_cmple_ps(one, u), one));
+		auto line1 = _mm_add_ps(_mm_mul_ps(slope1, u), intercept1);
+		auto line2 = _mm_add_ps(_mm_mul_ps(slope2, u), intercept2);
+		auto value = _mm_mul_ps(_mm_min_ps(line1, line2), sign);
+		auto height = select(_mm_cmple_ps(zeroFloat, value), positiveHeightVector, negativeHeightVector);
+
+		_mm_store_ps(values, _mm_add_ps(_mm_mul_ps(value, height), zeroVector));
+		storeValues(&dest[frame * stride], stride, values, min(frames - frame, Lanes));
+		position.next();
+	}
+}
+
+template<typename T>
+void ScalarKernel::convert(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex)
+{
+	for(size_t i = 0; i < count; i++) {
+		auto noise = dither ? ditherNoise(ditherIndex + (UINT32)i) : 0.0f;
+		dest[i] = convertSample<T>(src[i], zero, height, noise);
+	}
+}
+
+void ScalarKernel::packInt24(INT24* dest, const INT32* src, size_t count)
+{
+	auto p = (BYTE*)dest;
+	for(size_t i = 0; i < count; i++, p += 3) {
+		auto value = src[i];
+		if(value < -0x800000) { value = -0x800000; }
+		if(0x7fffff < value) { value = 0x7fffff; }
+		storeInt24(p, value);
+	}
+}
+
+void ScalarKernel::unpackInt24(INT32* dest, const INT24* src, size_t count)
+{
+	auto p = (const BYTE*)src;
+	for(size_t i = 0; i < count; i++, p += 3) {
+		dest[i] = loadInt24(p);
+	}
+}
+
+void ScalarKernel::unpackInt24(float* dest, const INT24* src, size_t count, float scale)
+{
+	auto p = (const BYTE*)src;
+	for(size_t i = 0; i < count; i++, p += 3) {
+		dest[i] = (float)loadInt24(p) * scale;
+	}
+}
+
+void ScalarKernel::interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames)
+{
+	for(size_t frame = 0; frame < frames; frame++) {
+		for(size_t channel = 0; channel < channels; channel++) {
+			*(dest++) = src[(channel * srcStride) + frame];
+		}
+	}
+}
+
+// Stereo is interleaved by unpack of 4 frames to 2 full vectors.
+// Other channel counts are interleaved by interleave4Frames().
+void SSE2Kernel::interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames)
+{
+	static const size_t Lanes = 4;
+
+	size_t frame = 0;
+	switch(channels) {
+	case 1:
+		memcpy(dest, src, frames * sizeof(float));
+		return;
+	case 2:
+		for(; frame + Lanes <= frames; frame += Lanes) {
+			auto l = _mm_loadu_ps(&src[frame]);
+			auto r = _mm_loadu_ps(&src[srcStride + frame]);
+			_mm_storeu_ps(&dest[frame * 2], _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(&dest[(frame * 2) + 4], _mm_unpackhi_ps(l, r));
+		}
+		break;
+	default:
+		for(; frame + Lanes <= frames; frame += Lanes) {
+			interleave4Frames(&dest[frame * channels], &src[frame], srcStride, channels, 0);
+		}
+		break;
+	}
+	ScalarKernel::interleave(&dest[frame * channels], &src[frame], srcStride, channels, frames - frame);
+}
+
+void ScalarKernel::add(float* dest, const float* src1, const float* src2, size_t count)
+{
+	for(size_t i = 0; i < count; i++) {
+		dest[i] = src1[i] + src2[i];
+	}
+}
+
+void SSE2Kernel::add(float* dest, const float* src1, const float* src2, size_t count)
+{
+	static const size_t Lanes = 4;
+
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		_mm_storeu_ps(&dest[i], _mm_add_ps(_mm_loadu_ps(&src1[i]), _mm_loadu_ps(&src2[i])));
+	}
+	ScalarKernel::add(&dest[i], &src1[i], &src2[i], count - i);
+}
+
+void ScalarKernel::whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	auto key = noiseKey(seed, 0);
+	for(size_t i = 0; i < count; i++) {
+		dest[i] = noiseValue(key, index + (UINT32)i) * height;
+	}
+}
+
+void SSE2Kernel::whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	static const size_t Lanes = 4;
+
+	const auto key = _mm_set1_epi32((int)noiseKey(seed, 0));
+	const auto heightVector = _mm_set1_ps(height);
+	auto n = _mm_add_epi32(_mm_set1_epi32((int)index), _mm_setr_epi32(0, 1, 2, 3));
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		_mm_storeu_ps(&dest[i], _mm_mul_ps(noiseValueSSE2(key, n), heightVector));
+		n = _mm_add_epi32(n, _mm_set1_epi32(Lanes));
+	}
+	ScalarKernel::whiteNoise(&dest[i], count - i, seed, index + (UINT32)i, height);
+}
+
+void ScalarKernel::pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	UINT32 keys[SimdKernel::PinkNoiseRows + 1];
+	for(UINT32 row = 0; row <= SimdKernel::PinkNoiseRows; row++) { keys[row] = noiseKey(seed, row); }
+	auto scale = height / (float)(SimdKernel::PinkNoiseRows + 1);
+
+	for(size_t i = 0; i < count; i++) {
+		auto n = index + (UINT32)i;
+		auto sum = noiseValue(keys[0], n);
+		for(UINT32 r = 0; r < SimdKernel::PinkNoiseRows; r++) {
+			sum += noiseValue(keys[r + 1], (n + (1u << r)) >> (r + 1));
+		}
+		dest[i] = sum * scale;
+	}
+}
+
+void SSE2Kernel::pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	static const size_t Lanes = 4;
+
+	__m128i keys[SimdKernel::PinkNoiseRows + 1];
+	for(UINT32 row = 0; row <= SimdKernel::PinkNoiseRows; row++) { keys[row] = _mm_set1_epi32((int)noiseKey(seed, row)); }
+	const auto scale = _mm_set1_ps(height / (float)(SimdKernel::PinkNoiseRows + 1));
+
+	auto n = _mm_add_epi32(_mm_set1_epi32((int)index), _mm_setr_epi32(0, 1, 2, 3));
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		auto sum = noiseValueSSE2(keys[0], n);
+		for(UINT32 r = 0; r < SimdKernel::PinkNoiseRows; r++) {
+			auto m = _mm_srl_epi32(_mm_add_epi32(n, _mm_set1_epi32(1 << r)), _mm_cvtsi32_si128(r + 1));
+			sum = _mm_add_ps(sum, noiseValueSSE2(keys[r + 1], m));
+		}
+		_mm_storeu_ps(&dest[i], _mm_mul_ps(sum, scale));
+		n = _mm_add_epi32(n, _mm_set1_epi32(Lanes));
+	}
+	ScalarKernel::pinkNoise(&dest[i], count - i, seed, index + (UINT32)i, height);
+}
+
+void ScalarKernel::expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero)
+{
+	for(size_t i = 0; i < count; i++) {
+		auto n = index + i;
+		dest[i] = ((bits[n / 64] >> (n % 64)) & 1) ? one : zero;
+	}
+}
+
+void SSE2Kernel::expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero)
+{
+	// Bits before the byte boundary.
+	auto head = min((8 - (index % 8)) % 8, count);
+	ScalarKernel::expandBits(dest, bits, index, head, one, zero);
+
+	// Each byte is expanded to 2 vectors. Bytes of UINT64 are little endian.
+	auto bytes = (const BYTE*)bits;
+	const auto low = _mm_setr_epi32(1, 2, 4, 8);
+	const auto high = _mm_setr_epi32(16, 32, 64, 128);
+	const auto oneVector = _mm_set1_ps(one);
+	const auto zeroVector = _mm_set1_ps(zero);
+	size_t i = head;
+	for(; i + 8 <= count; i += 8) {
+		auto byte = _mm_set1_epi32(bytes[(index + i) / 8]);
+		auto lowMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(byte, low), low));
+		auto highMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(byte, high), high));
+		_mm_storeu_ps(&dest[i], _mm_or_ps(_mm_and_ps(lowMask, oneVector), _mm_andnot_ps(lowMask, zeroVector)));
+		_mm_storeu_ps(&dest[i + 4], _mm_or_ps(_mm_and_ps(highMask, oneVector), _mm_andnot_ps(highMask, zeroVector)));
+	}
+	ScalarKernel::expandBits(&dest[i], bits, index + i, count - i, one, zero);
+}
+
+void ScalarKernel::hadamard(float* data, size_t size)
+{
+	for(size_t span = 1; span < size; span *= 2) {
+		for(size_t i = 0; i < size; i += span * 2) {
+			for(size_t j = i; j < i + span; j++) {
+				auto a = data[j];
+				auto b = data[j + span];
+				data[j] = a + b;
+				data[j + span] = a - b;
+			}
+		}
+	}
+}
+
+void SSE2Kernel::hadamard(float* data, size_t size)
+{
+	static const size_t Lanes = 4;
+
+	if(size < Lanes) { return ScalarKernel::hadamard(data, size); }
+
+	// Stages of span 1 and 2 are calculated in each vector.
+	// (-b) + a is same as a - b.
+	const auto sign1 = _mm_castsi128_ps(_mm_setr_epi32(0, (int)0x80000000, 0, (int)0x80000000));
+	const auto sign2 = _mm_castsi128_ps(_mm_setr_epi32(0, 0, (int)0x80000000, (int)0x80000000));
+	for(size_t i = 0; i < size; i += Lanes) {
+		auto v = _mm_loadu_ps(&data[i]);
+		v = _mm_add_ps(_mm_xor_ps(v, sign1), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		v = _mm_add_ps(_mm_xor_ps(v, sign2), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		_mm_storeu_ps(&data[i], v);
+	}
+
+	for(size_t span = Lanes; span < size; span *= 2) {
+		for(size_t i = 0; i < size; i += span * 2) {
+			for(size_t j = i; j < i + span; j += Lanes) {
+				auto a = _mm_loadu_ps(&data[j]);
+				auto b = _mm_loadu_ps(&data[j + span]);
+				_mm_storeu_ps(&data[j], _mm_add_ps(a, b));
+				_mm_storeu_ps(&data[j + span], _mm_sub_ps(a, b));
+			}
+		}
+	}
+}
+
+void ScalarKernel::chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height)
+{
+	for(size_t frame = 0; frame < frames; frame++) {
+		// Integer part of the phase is whole cycles.
+		auto x = (phase + (rate * shape[frame])) + curve[frame];
+		auto r = x - (float)(INT32)x;
+		dest[frame] = sineQuarter(r * 4.0f) * height;
+	}
+}
+
+void SSE2Kernel::chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height)
+{
+	static const size_t Lanes = 4;
+
+	const auto phaseVector = _mm_set1_ps(phase);
+	const auto rateVector = _mm_set1_ps(rate);
+	const auto four = _mm_set1_ps(4.0f);
+	const auto oneInt = _mm_set1_epi32(1);
+	const auto twoInt = _mm_set1_epi32(2);
+	const auto one = _mm_set1_ps(1.0f);
+	const auto heightVector = _mm_set1_ps(height);
+
+	size_t frame = 0;
+	for(; frame + Lanes <= frames; frame += Lanes) {
+		auto x = _mm_add_ps(_mm_add_ps(phaseVector, _mm_mul_ps(rateVector, _mm_loadu_ps(&shape[frame]))), _mm_loadu_ps(&curve[frame]));
+		auto r = _mm_sub_ps(x, _mm_cvtepi32_ps(_mm_cvttps_epi32(x)));
+		auto q = _mm_mul_ps(r, four);
+		auto quadrant = _mm_cvttps_epi32(q);
+		r = _mm_sub_ps(q, _mm_cvtepi32_ps(quadrant));
+		auto odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, oneInt), oneInt));
+		auto t = select(odd, _mm_sub_ps(one, r), r);
+		auto t2 = _mm_mul_ps(t, t);
+		auto p = _mm_set1_ps(SineC11);
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC9));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC7));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC5));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC3));
+		p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(SineC1));
+		auto s = _mm_mul_ps(p, t);
+		s = _mm_xor_ps(s, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, twoInt), 30)));
+		_mm_storeu_ps(&dest[frame], _mm_mul_ps(s, heightVector));
+	}
+	ScalarKernel::chirp(&dest[frame], frames - frame, phase, rate, &shape[frame], &curve[frame], height);
+}
+
+void ScalarKernel::oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators)
+{
+	static const size_t Lanes = SimdKernel::OscillatorBankLanes;
+
+	float sums[OscillatorBankBlockFrames][Lanes];
+	for(size_t frame = 0; frame < frames; frame += OscillatorBankBlockFrames) {
+		auto count = min(frames - frame, OscillatorBankBlockFrames);
+		memset(sums, 0, sizeof(sums));
+		for(size_t i = 0; i < oscillators; i++) {
+			auto table = &tables[tableOffsets[i]];
+			auto phase = phases[i];
+			for(size_t f = 0; f < count; f++) {
+				sums[f][i % Lanes] += oscillatorBankValue(table, phase) * levels[i];
+				phase += deltas[i];
+			}
+			phases[i] = phase;
+		}
+		for(size_t f = 0; f < count; f++) {
+			dest[frame + f] = sumOscillatorBankLanes(sums[f]);
+		}
+	}
+}
+
+void ScalarKernel::oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level)
+{
+	for(size_t frame = 0; frame < frames; frame++) {
+		dest[frame] = oscillatorBankValue(table, (UINT32)(phase >> 32)) * level;
+		phase += delta;
+	}
+}
+
+// Each group of 8 oscillators is held by 2 vectors of 4 lanes, so that lanes are summed as AVX2Kernel.
+// SSE2 does not have gather. So wave table is read by each lane.
+void SSE2Kernel::oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators)
+{
+	static const size_t Lanes = 4;
+
+	alignas(16) float sums[OscillatorBankBlockFrames][SimdKernel::OscillatorBankLanes];
+	const auto one = _mm_set1_ps(1.0f);
+	alignas(16) INT32 index[Lanes];
+	for(size_t frame = 0; frame < frames; frame += OscillatorBankBlockFrames) {
+		auto count = min(frames - frame, OscillatorBankBlockFrames);
+		memset(sums, 0, sizeof(sums));
+		for(size_t i = 0; i < oscillators; i += Lanes) {
+			auto half = (i / Lanes) % 2;
+			auto phase = _mm_loadu_si128((const __m128i*)&phases[i]);
+			const auto delta = _mm_loadu_si128((const __m128i*)&deltas[i]);
+			const auto level = _mm_loadu_ps(&levels[i]);
+			const float* table[Lanes];
+			for(size_t lane = 0; lane < Lanes; lane++) { table[lane] = &tables[tableOffsets[i + lane]]; }
+			for(size_t f = 0; f < count; f++) {
+				_mm_store_si128((__m128i*)index, _mm_srli_epi32(phase, 32 - SimdKernel::OscillatorBankTableBits));
+				auto fraction = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(
+					_mm_srli_epi32(_mm_slli_epi32(phase, SimdKernel::OscillatorBankTableBits), 9), _mm_castps_si128(one))), one);
+				auto v0 = _mm_setr_ps(table[0][index[0]], table[1][index[1]], table[2][index[2]], table[3][index[3]]);
+				auto v1 = _mm_setr_ps(table[0][index[0] + 1], table[1][index[1] + 1], table[2][index[2] + 1], table[3][index[3] + 1]);
+				auto v = _mm_mul_ps(_mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), fraction)), level);
+				auto sum = &sums[f][half * Lanes];
+				_mm_store_ps(sum, _mm_add_ps(_mm_load_ps(sum), v));
+				phase = _mm_add_epi32(phase, delta);
+			}
+			_mm_storeu_si128((__m128i*)&phases[i], phase);
+		}
+		for(size_t f = 0; f < count; f++) {
+			dest[frame + f] = sumOscillatorBankLanes(_mm_load_ps(&sums[f][0]), _mm_load_ps(&sums[f][Lanes]));
+		}
+	}
+}
+
+// Each lane processes every 4th frame.
+// 64-bit phase of the lanes are split into high and low 32 bits,
+// because SSE2 does not have 64-bit shift and compare for the lanes.
+void SSE2Kernel::oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level)
+{
+	static const size_t Lanes = 4;
+
+	alignas(16) UINT32 high[Lanes], low[Lanes];
+	for(size_t i = 0; i < Lanes; i++) {
+		auto p = phase + (delta * i);
+		high[i] = (UINT32)(p >> 32);
+		low[i] = (UINT32)p;
+	}
+	auto phaseHigh = _mm_load_si128((const __m128i*)high);
+	auto phaseLow = _mm_load_si128((const __m128i*)low);
+	const UINT64 step = delta * Lanes;
+	const auto stepHigh = _mm_set1_epi32((int)(step >> 32));
+	const auto stepLow = _mm_set1_epi32((int)step);
+	const auto sign = _mm_set1_epi32((int)0x80000000);
+	const auto one = _mm_set1_ps(1.0f);
+	const auto levelVector = _mm_set1_ps(level);
+
+	alignas(16) INT32 index[Lanes];
+	size_t frame = 0;
+	for(; frame + Lanes <= frames; frame += Lanes) {
+		_mm_store_si128((__m128i*)index, _mm_srli_epi32(phaseHigh, 32 - SimdKernel::OscillatorBankTableBits));
+		auto fraction = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(
+			_mm_srli_epi32(_mm_slli_epi32(phaseHigh, SimdKernel::OscillatorBankTableBits), 9), _mm_castps_si128(one))), one);
+		auto v0 = _mm_setr_ps(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+		auto v1 = _mm_setr_ps(table[index[0] + 1], table[index[1] + 1], table[index[2] + 1], table[index[3] + 1]);
+		_mm_storeu_ps(&dest[frame], _mm_mul_ps(_mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), fraction)), levelVector));
+
+		// Carry from low 32 bits occurs if the result is less than the step as unsigned value.
+		auto newLow = _mm_add_epi32(phaseLow, stepLow);
+		auto carry = _mm_cmplt_epi32(_mm_xor_si128(newLow, sign), _mm_xor_si128(stepLow, sign));
+		phaseHigh = _mm_sub_epi32(_mm_add_epi32(phaseHigh, stepHigh), carry);
+		phaseLow = newLow;
+	}
+	ScalarKernel::oscillator(&dest[frame], frames - frame, table, phase + (delta * frame), delta, level);
+}
+
+template<typename T>
+void SSE2Kernel::convert(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex)
+{
+	static const size_t Lanes = 4;
+
+	const auto zeroVector = _mm_set1_ps(zero);
+	const auto heightVector = _mm_set1_ps(height);
+	const SampleRangeSSE2<T> range;
+	DitherSSE2 noise(ditherIndex);
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		auto v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src[i]), heightVector), zeroVector);
+		if(dither) { v = _mm_add_ps(v, noise.next()); }
+		SampleVectorSSE2<T>::store(&dest[i], range.clamp(v));
+	}
+	ScalarKernel::convert(&dest[i], &src[i], count - i, zero, height, dither, ditherIndex + (UINT32)i);
+}
+
+template void SimdKernel::convert(UINT8*, const float*, size_t, float, float, Dither, UINT32);
+template void SimdKernel::convert(INT16*, const float*, size_t, float, float, Dither, UINT32);
+template void SimdKernel::convert(INT24*, const float*, size_t, float, float, Dither, UINT32);
+template void SimdKernel::convert(float*, const float*, size_t, float, float, Dither, UINT32);
+template void SimdKernel::convert(INT24in32*, const float*, size_t, float, float, Dither, UINT32);
+template void SimdKernel::convert(INT32*, const float*, size_t, float, float, Dither, UINT32);
+template void SimdKernel::convert(double*, const float*, size_t, float, float, Dither, UINT32);
+
+template void SimdKernel::convertRamp(UINT8*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+template void SimdKernel::convertRamp(INT16*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+template void SimdKernel::convertRamp(INT24*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+template void SimdKernel::convertRamp(float*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+template void SimdKernel::convertRamp(INT24in32*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+template void SimdKernel::convertRamp(INT32*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+template void SimdKernel::convertRamp(double*, const float*, size_t, size_t, float, float, float, float, Dither, UINT32);
+
+template void ScalarKernel::convert(UINT8*, const float*, size_t, float, float, bool, UINT32);
+template void ScalarKernel::convert(INT16*, const float*, size_t, float, float, bool, UINT32);
+template void ScalarKernel::convert(INT24*, const float*, size_t, float, float, bool, UINT32);
+template void ScalarKernel::convert(float*, const float*, size_t, float, float, bool, UINT32);
+template void ScalarKernel::convert(INT24in32*, const float*, size_t, float, float, bool, UINT32);
+template void ScalarKernel::convert(INT32*, const float*, size_t, float, float, bool, UINT32);
+template void ScalarKernel::convert(double*, const float*, size_t, float, float, bool, UINT32);
+
+template void SSE2Kernel::convert(UINT8*, const float*, size_t, float, float, bool, UINT32);
+template void SSE2Kernel::convert(INT16*, const float*, size_t, float, float, bool, UINT32);
+template void SSE2Kernel::convert(INT24*, const float*, size_t, float, float, bool, UINT32);
+template void SSE2Kernel::convert(float*, const float*, size_t, float, float, bool, UINT32);
+template void SSE2Kernel::convert(INT24in32*, const float*, size_t, float, float, bool, UINT32);
+template void SSE2Kernel::convert(INT32*, const float*, size_t, float, float, bool, UINT32);
+template void SSE2Kernel::convert(double*, const float*, size_t, float, float, bool, UINT32);
+
+#pragma endregion
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <Windows.h>
+
+class INT24;
+class INT24in32;
+
+/*
+ * SimdKernel class
+ *
+ * Provides kernels used by WaveForm classes to generate float master(samples normalized to -1.0 ~ +1.0),
+ * and by PcmData classes to convert the master to the output sample type when samples are copied.
+ * Each kernel has Scalar, SSE2 and AVX2 implementation,
+ * and the implementation is selected at run time depending on instruction set supported by the CPU.
+ * Kernels for packed INT24 samples have SSSE3 implementation that shuffles bytes,
+ * and other kernels use SSE2 implementation on SSSE3.
+ * All implementations of a kernel generate identical samples.
+ *
+ * Generation kernels write samples of a channel to dest at interval of stride(= channels).
+ * Conversion kernels take type parameter T that is one of UINT8, INT16, INT24, float, INT24in32, INT32 and double.
+ * Integer sample is rounded to nearest(even) and saturated to the range of T.
+ */
+class SimdKernel
+{
+public:
+	enum class InstructionSet {
+		Scalar,
+		SSE2,
+		SSSE3,
+		AVX2,
+	};
+
+	// Returns instruction set used by the kernels.
+	static InstructionSet getInstructionSet();
+	// Returns the best instruction set supported by the CPU and the OS.
+	static InstructionSet getSupportedInstructionSet();
+	// Limits instruction set used by the kernels, to test or benchmark each implementation.
+	// Instruction set that is not supported is replaced with supported one.
+	// Note: This method is not thread safe. Call while any kernel is not running.
+	static void setInstructionSet(InstructionSet instructionSet);
+	static const char* getInstructionSetName(InstructionSet instructionSet);
+
+	enum class Dither {
+		None,
+		TPDF,		// Triangular PDF noise of +-1 LSB that decorrelates quantization error from the signal.
+	};
+
+	// Max absolute error of sine() compared with sin() of C runtime library,
+	// when height == 1 and zero == 0.
+	static const float SineMaxError;
+
+	// Generates `cycles` cycles of sine wave in `frames` samples.
+	//   dest[frame * stride] = zero + (height * sin(2 * pi * ((frame * cycles) % frames) / frames))
+	// Position in the cycle is calculated by integer for each frame, so that error is not accumulated.
+	static void sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height);
+
+	// Generates `cycles` cycles of square wave in `frames` samples.
+	//   dest[frame * stride] = (((frame * cycles) % frames) < highFrames) ? high : low
+	static void square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low);
+
+	// Generates `cycles` cycles of triangle wave in `frames` samples.
+	// Shape of the wave depends on peakPosition as described in TriangleWaveForm class.
+	// value(-1.0 ~ +1.0) of each frame is calculated from (frame * cycles) % frames independently, and
+	//   dest[frame * stride] = zero + (value * ((0 <= value) ? positiveHeight : negativeHeight))
+	static void triangle(float* dest, size_t stride, size_t frames, size_t cycles, float peakPosition,
+						float zero, float positiveHeight, float negativeHeight);
+
+	// Adds PolyBLEP and PolyBLAMP residuals of a discontinuity in every cycle generated by square() or triangle(),
+	// to cut aliasing of the edge. The discontinuity is at edge(0.0 <= edge < frames) of (frame * cycles) % frames,
+	// and the frame whose position is equal to the edge has the value after the discontinuity.
+	//   jump: Value after the discontinuity - value before it.
+	//   slopeChange: Slope after the discontinuity - slope before it, in value per cycle.
+	// Residual of a frame at distance d(-1 < d < +1 frame) from the discontinuity is polynomial of d:
+	//   d < 0:  (jump * (1 + d)^2 / 2) + (slope * (1 + d)^3 / 6)
+	//   0 <= d: (-jump * (1 - d)^2 / 2) + (slope * (1 - d)^3 / 6)
+	//   where slope is slopeChange in value per frame.
+	// Only 2 frames around each discontinuity are changed, so that the cost is constant for each edge.
+	// Edges are so sparse that they are not vectorized.
+	static void polyBlep(float* dest, size_t stride, size_t frames, size_t cycles, double edge, float jump, float slopeChange);
+
+	// Converts count values of float master to samples.
+	//   dest[i] = zero + (src[i] * height) + noise(ditherIndex + i)
+	// noise() is TPDF noise(-1.0 < noise < +1.0) of Dither::TPDF that depends on the index only,
+	// so that the result does not depend on instruction set or how samples are split into calls.
+	// Float and double samples are not dithered. Double sample is calculated by float and widened.
+	template<typename T>
+	static void convert(T* dest, const float* src, size_t count, float zero, float height,
+						Dither dither = Dither::None, UINT32 ditherIndex = 0);
+
+	// Converts frames with height that changes linearly, to avoid click noise.
+	//   Height of frame f is height * (startGain + (step * (f + 1))) for all channels.
+	// Ramp is so short that it is not vectorized.
+	template<typename T>
+	static void convertRamp(T* dest, const float* src, size_t frames, size_t channels, float zero, float height,
+							float startGain, float step, Dither dither = Dither::None, UINT32 ditherIndex = 0);
+
+	// Interleaves planar float master of channels.
+	//   dest[(frame * channels) + channel] = src[(channel * srcStride) + frame]
+	// Used to copy samples of planar master to interleaved buffer.
+	static void interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames);
+
+	// Adds 2 arrays of float master.
+	//   dest[i] = src1[i] + src2[i]
+	// Used to mix 2 tones read from tables.
+	static void add(float* dest, const float* src1, const float* src2, size_t count);
+
+	// Generates sine wave whose phase(1.0 = 1 cycle) is given as polynomial or table of the frame, used by sweep.
+	//   dest[frame] = height * sin(2 * pi * (phase + (rate * shape[frame]) + curve[frame]))
+	// Sum of the phase should be 0 or positive, and small enough for float precision.
+	// Caller calculates exact phase at the first frame, and shape and curve of a short block.
+	static void chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height);
+
+	// Generates white noise of uniform distribution(-1.0 <= value < +1.0) from counter-based random values.
+	//   dest[i] = height * uniform(hash(key(seed, 0) ^ (index + i)))
+	// Value depends on the seed and the index only, so that the stream is reproduced from any index,
+	// regardless of instruction set or how samples are split into calls.
+	static void whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+
+	// Number of rows of pinkNoise() that are summed with white noise.
+	static const size_t PinkNoiseRows = 16;
+
+	// Generates pink noise(-3dB/octave) by Voss-McCartney algorithm.
+	// Row r holds random value that changes every 2^(r + 1) samples at index 2^r + (m * 2^(r + 1)),
+	// so that at most 1 row changes at each index. Value of each row is calculated from the index without state.
+	//   dest[i] = height / (PinkNoiseRows + 1) * (uniform(hash(key(seed, 0) ^ n)) + sum of uniform(hash(key(seed, r + 1) ^ ((n + 2^r) >> (r + 1)))))
+	//   where n = index + i.
+	// Sum does not exceed height.
+	static void pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+
+	// Expands bits to float master, used to play maximum length sequence.
+	//   dest[i] = (bit (index + i) of bits) ? one : zero
+	// Bit n is bit (n % 64) of bits[n / 64].
+	static void expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero);
+
+	// Transforms size(power of 2) values by Walsh-Hadamard matrix of Sylvester's order in place, without normalization.
+	//   data[a] = sum of data[b] * (-1)^popcount(a & b)
+	// Butterflies of each stage are calculated in fixed order, so that the result does not depend on instruction set.
+	static void hadamard(float* data, size_t size);
+
+	// Number of oscillators that oscillatorBank() sums in parallel. Oscillator count should be a multiple of this.
+	static const size_t OscillatorBankLanes = 8;
+	// Wave table of oscillatorBank() has 2^OscillatorBankTableBits + 1 samples.
+	// Last sample is same as the first one to interpolate between the last sample and the first.
+	static const int OscillatorBankTableBits = 11;
+
+	// Sums oscillators that read wave tables with 32-bit phase accumulator(2^32 = 1 cycle).
+	//   dest[frame] = sum of levels[i] * wave(&tables[tableOffsets[i]], phases[i] + (deltas[i] * frame))
+	// wave(table, phase) interpolates table[index] and table[index + 1] linearly by the fraction,
+	// where index is high OscillatorBankTableBits bits of the phase and the fraction is the following bits.
+	// phases are advanced by frames.
+	// Oscillators are Structure of Arrays, and lane (i % OscillatorBankLanes) sums oscillator i.
+	// Then the lanes are summed in fixed order, so that the result does not depend on instruction set.
+	// Unused oscillators should have level 0.
+	static void oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators);
+
+	// Reads a wave table with 64-bit phase accumulator(2^64 = 1 cycle), used to synthesize a channel of the oscillator.
+	//   dest[frame] = level * wave(table, high 32 bits of (phase + (delta * frame)))
+	// wave() and the wave table are same as oscillatorBank(), so that the result does not depend on instruction set.
+	static void oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level);
+
+	// Packs count INT32 values to INT24 samples, saturating to the range of INT24.
+	static void packInt24(INT24* dest, const INT32* src, size_t count);
+	// Unpacks count INT24 samples to INT32 values with sign extension.
+	static void unpackInt24(INT32* dest, const INT24* src, size_t count);
+	// Converts count INT24 samples to float values.
+	//   dest[i] = src[i] * scale
+	static void unpackInt24(float* dest, const INT24* src, size_t count, float scale);
+};
@@ -0,0 +1,635 @@
+#include "SimdKernelImpl.h"
+
+#include <immintrin.h>
+
+// AVX2 implementations of SimdKernel.
+// These functions are called only if the CPU supports AVX2(See SimdKernel::getSupportedInstructionSet()).
+// Operations are same as SSE2Kernel in SimdKernel.cpp except for the number of lanes.
+// FMA is not used so that the results are identical to SSE2Kernel and ScalarKernel.
+
+namespace
+{
+
+// Position in the cycle of each lane, (frame * cycles) % frames, advanced by 8 frames.
+class PositionAVX2
+{
+public:
+	static const size_t Lanes = 8;
+
+	PositionAVX2(size_t frames, size_t cycles)
+		: m_step(_mm256_set1_epi32((INT32)(((cycles % frames) * Lanes) % frames)))
+		, m_lastPosition(_mm256_set1_epi32((INT32)(frames - 1)))
+		, m_frames(_mm256_set1_epi32((INT32)frames))
+	{
+		alignas(32) INT32 initialValue[Lanes];
+		for(size_t i = 0; i < Lanes; i++) {
+			initialValue[i] = (INT32)(((cycles % frames) * i) % frames);
+		}
+		value = _mm256_load_si256((const __m256i*)initialValue);
+	}
+
+	__m256i value;
+
+	void next() {
+		// Wrap around if the position exceeds the last position.
+		value = _mm256_add_epi32(value, m_step);
+		auto wrap = _mm256_cmpgt_epi32(value, m_lastPosition);
+		value = _mm256_sub_epi32(value, _mm256_and_si256(wrap, m_frames));
+	}
+
+protected:
+	const __m256i m_step;
+	const __m256i m_lastPosition;
+	const __m256i m_frames;
+};
+
+// ditherHash() of 8 lanes.
+inline __m256i ditherHashAVX2(__m256i a)
+{
+	a = _mm256_add_epi32(_mm256_add_epi32(a, _mm256_set1_epi32(0x7ed55d16)), _mm256_slli_epi32(a, 12));
+	a = _mm256_xor_si256(_mm256_xor_si256(a, _mm256_set1_epi32((int)0xc761c23c)), _mm256_srli_epi32(a, 19));
+	a = _mm256_add_epi32(_mm256_add_epi32(a, _mm256_set1_epi32(0x165667b1)), _mm256_slli_epi32(a, 5));
+	a = _mm256_xor_si256(_mm256_add_epi32(a, _mm256_set1_epi32((int)0xd3a2646c)), _mm256_slli_epi32(a, 9));
+	a = _mm256_add_epi32(_mm256_add_epi32(a, _mm256_set1_epi32((int)0xfd7046c5)), _mm256_slli_epi32(a, 3));
+	a = _mm256_xor_si256(_mm256_xor_si256(a, _mm256_set1_epi32((int)0xb55a4f09)), _mm256_srli_epi32(a, 16));
+	return a;
+}
+
+// noiseValue() of 8 lanes.
+inline __m256 noiseValueAVX2(__m256i key, __m256i index)
+{
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(ditherHashAVX2(_mm256_xor_si256(key, index))), _mm256_set1_ps(NoiseScale));
+}
+
+// TPDF noise of 8 lanes for consecutive dither indexes. See ditherNoise().
+class DitherAVX2
+{
+public:
+	DitherAVX2(UINT32 index) : m_index(_mm256_add_epi32(_mm256_set1_epi32((int)index), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))) {}
+
+	__m256 next() {
+		auto a = ditherHashAVX2(m_index);
+		auto noise = _mm256_sub_epi32(_mm256_srli_epi32(a, 16), _mm256_and_si256(a, _mm256_set1_epi32(0xffff)));
+		m_index = _mm256_add_epi32(m_index, _mm256_set1_epi32(8));
+		return _mm256_mul_ps(_mm256_cvtepi32_ps(noise), _mm256_set1_ps(DitherScale));
+	}
+
+protected:
+	__m256i m_index;
+};
+
+// Stores 8 float values as samples, rounding and saturating integer.
+// Values passed to store() should be clamped to SampleLimit<T> already.
+template<typename T>
+struct SampleVectorAVX2
+{
+	static void store(T* dest, __m256 values) {
+		alignas(32) INT32 v[8];
+		_mm256_store_si256((__m256i*)v, _mm256_cvtps_epi32(values));
+		for(int i = 0; i < 8; i++) { dest[i] = (T)v[i]; }
+	}
+};
+
+template<>
+struct SampleVectorAVX2<UINT8>
+{
+	static void store(UINT8* dest, __m256 values) {
+		auto v = _mm256_cvtps_epi32(values);
+		auto v16 = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		_mm_storel_epi64((__m128i*)dest, _mm_packus_epi16(v16, v16));
+	}
+};
+
+template<>
+struct SampleVectorAVX2<INT16>
+{
+	static void store(INT16* dest, __m256 values) {
+		auto v = _mm256_cvtps_epi32(values);
+		_mm_storeu_si128((__m128i*)dest, _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+	}
+};
+
+// Stores 8 INT32 values in the range of INT24 to p as 24 bytes.
+// VPSHUFB packs 4 samples to the low 12 bytes of each 128-bit lane,
+// and VPERMD moves them to the low 24 bytes.
+inline void storeInt24AVX2(BYTE* p, __m256i values)
+{
+	const auto mask = _mm256_setr_epi8(
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	auto v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, mask), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+	_mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+	_mm_storel_epi64((__m128i*)(p + 16), _mm256_extracti128_si256(v, 1));
+}
+
+// Loads 8 samples at p as INT32 values.
+// Reads 32 bytes, 8 bytes beyond the samples.
+inline __m256i loadInt24AVX2(const BYTE* p)
+{
+	const auto mask = _mm256_setr_epi8(
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	auto v = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)p), _mm256_setr_epi32(0, 1, 2, 2, 3, 4, 5, 5));
+	return _mm256_srai_epi32(_mm256_shuffle_epi8(v, mask), 8);
+}
+
+template<>
+struct SampleVectorAVX2<INT24>
+{
+	static void store(INT24* dest, __m256 values) { storeInt24AVX2((BYTE*)dest, _mm256_cvtps_epi32(values)); }
+};
+
+template<>
+struct SampleVectorAVX2<INT24in32>
+{
+	static void store(INT24in32* dest, __m256 values) {
+		_mm256_storeu_si256((__m256i*)dest, _mm256_slli_epi32(_mm256_cvtps_epi32(values), 8));
+	}
+};
+
+template<>
+struct SampleVectorAVX2<float>
+{
+	static void store(float* dest, __m256 values) { _mm256_storeu_ps(dest, values); }
+};
+
+template<>
+struct SampleVectorAVX2<INT32>
+{
+	static void store(INT32* dest, __m256 values) { _mm256_storeu_si256((__m256i*)dest, _mm256_cvtps_epi32(values)); }
+};
+
+template<>
+struct SampleVectorAVX2<double>
+{
+	static void store(double* dest, __m256 values) {
+		_mm256_storeu_pd(dest, _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+		_mm256_storeu_pd(&dest[4], _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+	}
+};
+
+// Range to clamp values before stored by SampleVectorAVX2<T>::store().
+// Float sample is not clamped.
+template<typename T>
+struct SampleRangeAVX2
+{
+	SampleRangeAVX2() : low(_mm256_set1_ps(SampleLimit<T>::Min)), high(_mm256_set1_ps(SampleLimit<T>::Max)) {}
+	__m256 clamp(__m256 values) const { return _mm256_min_ps(_mm256_max_ps(values, low), high); }
+	const __m256 low, high;
+};
+
+template<>
+struct SampleRangeAVX2<float>
+{
+	__m256 clamp(__m256 values) const { return values; }
+};
+
+template<>
+struct SampleRangeAVX2<double> : SampleRangeAVX2<float> {};
+
+// Transposes 8 frames of 8 channels to 8 vectors of frames.
+inline void transpose8(__m256 (&v)[8])
+{
+	auto t0 = _mm256_unpacklo_ps(v[0], v[1]);
+	auto t1 = _mm256_unpackhi_ps(v[0], v[1]);
+	auto t2 = _mm256_unpacklo_ps(v[2], v[3]);
+	auto t3 = _mm256_unpackhi_ps(v[2], v[3]);
+	auto t4 = _mm256_unpacklo_ps(v[4], v[5]);
+	auto t5 = _mm256_unpackhi_ps(v[4], v[5]);
+	auto t6 = _mm256_unpacklo_ps(v[6], v[7]);
+	auto t7 = _mm256_unpackhi_ps(v[6], v[7]);
+	auto s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	auto s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	auto s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	auto s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	auto s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	auto s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	auto s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	auto s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+	v[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+	v[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+	v[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+	v[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+	v[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+	v[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+	v[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+	v[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+}
+
+void AVX2Kernel::sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height)
+{
+	static const size_t Lanes = PositionAVX2::Lanes;
+	if(frames == 0) { return; }
+
+	PositionAVX2 position(frames, cycles);
+	const auto scale = _mm256_set1_ps(4.0f / (float)frames);
+	const auto oneInt = _mm256_set1_epi32(1);
+	const auto twoInt = _mm256_set1_epi32(2);
+	const auto one = _mm256_set1_ps(1.0f);
+	const auto heightVector = _mm256_set1_ps(height);
+	const auto zeroVector = _mm256_set1_ps(zero);
+
+	alignas(32) float values[Lanes];
+	for(size_t frame = 0; frame < frames; frame += Lanes) {
+		auto q = _mm256_mul_ps(_mm256_cvtepi32_ps(position.value), scale);
+		auto quadrant = _mm256_cvttps_epi32(q);
+		auto r = _mm256_sub_ps(q, _mm256_cvtepi32_ps(quadrant));
+		auto odd = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, oneInt), oneInt));
+		auto t = _mm256_blendv_ps(r, _mm256_sub_ps(one, r), odd);
+		auto t2 = _mm256_mul_ps(t, t);
+		auto p = _mm256_set1_ps(SineC11);
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC9));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC7));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC5));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC3));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC1));
+		auto s = _mm256_mul_ps(p, t);
+		s = _mm256_xor_ps(s, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, twoInt), 30)));
+
+		_mm256_store_ps(values, _mm256_add_ps(_mm256_mul_ps(s, heightVector), zeroVector));
+		storeValues(&dest[frame * stride], stride, values, min(frames - frame, Lanes));
+		position.next();
+	}
+}
+
+void AVX2Kernel::square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low)
+{
+	static const size_t Lanes = PositionAVX2::Lanes;
+	if(frames == 0) { return; }
+
+	PositionAVX2 position(frames, cycles);
+	const auto highFramesVector = _mm256_set1_epi32((INT32)min(highFrames, frames));
+	const auto highVector = _mm256_set1_ps(high);
+	const auto lowVector = _mm256_set1_ps(low);
+
+	alignas(32) float values[Lanes];
+	for(size_t frame = 0; frame < frames; frame += Lanes) {
+		auto isHigh = _mm256_castsi256_ps(_mm256_cmpgt_epi32(highFramesVector, position.value));
+		_mm256_store_ps(values, _mm256_blendv_ps(lowVector, highVector, isHigh));
+		storeValues(&dest[frame * stride], stride, values, min(frames - frame, Lanes));
+		position.next();
+	}
+}
+
+void AVX2Kernel::triangle(float* dest, size_t stride, size_t frames, size_t cycles, const TriangleShape& shape,
+							float zero, float positiveHeight, float negativeHeight)
+{
+	static const size_t Lanes = PositionAVX2::Lanes;
+	if(frames == 0) { return; }
+
+	PositionAVX2 position(frames, cycles);
+	const auto scale = _mm256_set1_ps(1.0f / (float)frames);
+	const auto one = _mm256_set1_ps(1.0f);
+	const auto zeroFloat = _mm256_setzero_ps();
+	const auto shift = _mm256_set1_ps(shape.shift);
+	const auto slope1 = _mm256_set1_ps(shape.slope1);
+	const auto intercept1 = _mm256_set1_ps(shape.intercept1);
+	const auto slope2 = _mm256_set1_ps(shape.slope2);
+	const auto intercept2 = _mm256_set1_ps(shape.intercept2);
+	const auto sign = _mm256_set1_ps(shape.sign);
+	const auto positiveHeightVector = _mm256_set1_ps(positiveHeight);
+	const auto negativeHeightVector = _mm256_set1_ps(negativeHeight);
+	const auto zeroVector = _mm256_set1_ps(zero);
+
+	alignas(32) float values[Lanes];
+	for(size_t frame = 0; frame < frames; frame += Lanes) {
+		auto u = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(position.value), scale), shift);
+		u = _mm256_sub_ps(u, _mm256_and_ps(_mm256_cmp_ps(one, u, _CMP_LE_OQ), one));
+		auto line1 = _mm256_add_ps(_mm256_mul_ps(slope1, u), intercept1);
+		auto line2 = _mm256_add_ps(_mm256_mul_ps(slope2, u), intercept2);
+		auto value = _mm256_mul_ps(_mm256_min_ps(line1, line2), sign);
+		auto height = _mm256_blendv_ps(negativeHeightVector, positiveHeightVector, _mm256_cmp_ps(zeroFloat, value, _CMP_LE_OQ));
+
+		_mm256_store_ps(values, _mm256_add_ps(_mm256_mul_ps(value, height), zeroVector));
+		storeValues(&dest[frame * stride], stride, values, min(frames - frame, Lanes));
+		position.next();
+	}
+}
+
+// Each 8 channels of 8 frames are transposed as 8x8 matrix.
+// Rest of channels are interleaved by interleave4Frames() for each half of 8 frames.
+void AVX2Kernel::interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames)
+{
+	static const size_t Lanes = 8;
+
+	if(channels < 4) {
+		return SSE2Kernel::interleave(dest, src, srcStride, channels, frames);
+	}
+
+	size_t frame = 0;
+	for(; frame + Lanes <= frames; frame += Lanes) {
+		auto d = &dest[frame * channels];
+		size_t channel = 0;
+		for(; channel + 8 <= channels; channel += 8) {
+			__m256 v[8];
+			for(size_t i = 0; i < 8; i++) {
+				v[i] = _mm256_loadu_ps(&src[((channel + i) * srcStride) + frame]);
+			}
+			transpose8(v);
+			for(size_t i = 0; i < 8; i++) {
+				_mm256_storeu_ps(&d[(i * channels) + channel], v[i]);
+			}
+		}
+		if(channel < channels) {
+			interleave4Frames(d, &src[frame], srcStride, channels, channel);
+			interleave4Frames(&d[channels * 4], &src[frame + 4], srcStride, channels, channel);
+		}
+	}
+	SSE2Kernel::interleave(&dest[frame * channels], &src[frame], srcStride, channels, frames - frame);
+}
+
+template<typename T>
+void AVX2Kernel::convert(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex)
+{
+	static const size_t Lanes = 8;
+
+	const auto zeroVector = _mm256_set1_ps(zero);
+	const auto heightVector = _mm256_set1_ps(height);
+	const SampleRangeAVX2<T> range;
+	DitherAVX2 noise(ditherIndex);
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		auto v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&src[i]), heightVector), zeroVector);
+		if(dither) { v = _mm256_add_ps(v, noise.next()); }
+		SampleVectorAVX2<T>::store(&dest[i], range.clamp(v));
+	}
+	ScalarKernel::convert(&dest[i], &src[i], count - i, zero, height, dither, ditherIndex + (UINT32)i);
+}
+
+template void AVX2Kernel::convert(UINT8*, const float*, size_t, float, float, bool, UINT32);
+template void AVX2Kernel::convert(INT16*, const float*, size_t, float, float, bool, UINT32);
+template void AVX2Kernel::convert(INT24*, const float*, size_t, float, float, bool, UINT32);
+template void AVX2Kernel::convert(float*, const float*, size_t, float, float, bool, UINT32);
+template void AVX2Kernel::convert(INT24in32*, const float*, size_t, float, float, bool, UINT32);
+template void AVX2Kernel::convert(INT32*, const float*, size_t, float, float, bool, UINT32);
+template void AVX2Kernel::convert(double*, const float*, size_t, float, float, bool, UINT32);
+
+void AVX2Kernel::packInt24(INT24* dest, const INT32* src, size_t count)
+{
+	static const size_t Lanes = 8;
+
+	const auto min = _mm256_set1_epi32(-0x800000);
+	const auto max = _mm256_set1_epi32(0x7fffff);
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		auto v = _mm256_loadu_si256((const __m256i*)&src[i]);
+		storeInt24AVX2((BYTE*)&dest[i], _mm256_min_epi32(_mm256_max_epi32(v, min), max));
+	}
+	ScalarKernel::packInt24(&dest[i], &src[i], count - i);
+}
+
+// loadInt24AVX2() reads 8 bytes beyond the last sample.
+// The loop stops before the bytes are out of src, and the rest is processed by ScalarKernel.
+void AVX2Kernel::unpackInt24(INT32* dest, const INT24* src, size_t count)
+{
+	static const size_t Lanes = 8;
+
+	size_t i = 0;
+	for(; (i + Lanes) * 3 + 8 <= count * 3; i += Lanes) {
+		_mm256_storeu_si256((__m256i*)&dest[i], loadInt24AVX2((const BYTE*)&src[i]));
+	}
+	ScalarKernel::unpackInt24(&dest[i], &src[i], count - i);
+}
+
+void AVX2Kernel::unpackInt24(float* dest, const INT24* src, size_t count, float scale)
+{
+	static const size_t Lanes = 8;
+
+	const auto scaleVector = _mm256_set1_ps(scale);
+	size_t i = 0;
+	for(; (i + Lanes) * 3 + 8 <= count * 3; i += Lanes) {
+		auto v = _mm256_cvtepi32_ps(loadInt24AVX2((const BYTE*)&src[i]));
+		_mm256_storeu_ps(&dest[i], _mm256_mul_ps(v, scaleVector));
+	}
+	ScalarKernel::unpackInt24(&dest[i], &src[i], count - i, scale);
+}
+
+void AVX2Kernel::add(float* dest, const float* src1, const float* src2, size_t count)
+{
+	static const size_t Lanes = 8;
+
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		_mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_loadu_ps(&src1[i]), _mm256_loadu_ps(&src2[i])));
+	}
+	SSE2Kernel::add(&dest[i], &src1[i], &src2[i], count - i);
+}
+
+void AVX2Kernel::whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	static const size_t Lanes = 8;
+
+	const auto key = _mm256_set1_epi32((int)noiseKey(seed, 0));
+	const auto heightVector = _mm256_set1_ps(height);
+	auto n = _mm256_add_epi32(_mm256_set1_epi32((int)index), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		_mm256_storeu_ps(&dest[i], _mm256_mul_ps(noiseValueAVX2(key, n), heightVector));
+		n = _mm256_add_epi32(n, _mm256_set1_epi32(Lanes));
+	}
+	SSE2Kernel::whiteNoise(&dest[i], count - i, seed, index + (UINT32)i, height);
+}
+
+void AVX2Kernel::pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height)
+{
+	static const size_t Lanes = 8;
+
+	__m256i keys[SimdKernel::PinkNoiseRows + 1];
+	for(UINT32 row = 0; row <= SimdKernel::PinkNoiseRows; row++) { keys[row] = _mm256_set1_epi32((int)noiseKey(seed, row)); }
+	const auto scale = _mm256_set1_ps(height / (float)(SimdKernel::PinkNoiseRows + 1));
+
+	auto n = _mm256_add_epi32(_mm256_set1_epi32((int)index), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		auto sum = noiseValueAVX2(keys[0], n);
+		for(UINT32 r = 0; r < SimdKernel::PinkNoiseRows; r++) {
+			auto m = _mm256_srl_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(1 << r)), _mm_cvtsi32_si128(r + 1));
+			sum = _mm256_add_ps(sum, noiseValueAVX2(keys[r + 1], m));
+		}
+		_mm256_storeu_ps(&dest[i], _mm256_mul_ps(sum, scale));
+		n = _mm256_add_epi32(n, _mm256_set1_epi32(Lanes));
+	}
+	SSE2Kernel::pinkNoise(&dest[i], count - i, seed, index + (UINT32)i, height);
+}
+
+void AVX2Kernel::expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero)
+{
+	// Bits before the byte boundary.
+	auto head = min((8 - (index % 8)) % 8, count);
+	ScalarKernel::expandBits(dest, bits, index, head, one, zero);
+
+	// Each byte is expanded to a vector. Bytes of UINT64 are little endian.
+	auto bytes = (const BYTE*)bits;
+	const auto mask = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	const auto oneVector = _mm256_set1_ps(one);
+	const auto zeroVector = _mm256_set1_ps(zero);
+	size_t i = head;
+	for(; i + 8 <= count; i += 8) {
+		auto byte = _mm256_set1_epi32(bytes[(index + i) / 8]);
+		auto isOne = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(byte, mask), mask));
+		_mm256_storeu_ps(&dest[i], _mm256_blendv_ps(zeroVector, oneVector, isOne));
+	}
+	SSE2Kernel::expandBits(&dest[i], bits, index + i, count - i, one, zero);
+}
+
+void AVX2Kernel::hadamard(float* data, size_t size)
+{
+	static const size_t Lanes = 8;
+
+	if(size < Lanes) { return SSE2Kernel::hadamard(data, size); }
+
+	// Stages of span 1, 2 and 4 are calculated in each vector.
+	// (-b) + a is same as a - b.
+	const auto sign1 = _mm256_castsi256_ps(_mm256_setr_epi32(0, (int)0x80000000, 0, (int)0x80000000, 0, (int)0x80000000, 0, (int)0x80000000));
+	const auto sign2 = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, (int)0x80000000, (int)0x80000000, 0, 0, (int)0x80000000, (int)0x80000000));
+	const auto sign4 = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, 0, (int)0x80000000, (int)0x80000000, (int)0x80000000, (int)0x80000000));
+	for(size_t i = 0; i < size; i += Lanes) {
+		auto v = _mm256_loadu_ps(&data[i]);
+		v = _mm256_add_ps(_mm256_xor_ps(v, sign1), _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1)));
+		v = _mm256_add_ps(_mm256_xor_ps(v, sign2), _mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm256_add_ps(_mm256_xor_ps(v, sign4), _mm256_permute2f128_ps(v, v, 0x01));
+		_mm256_storeu_ps(&data[i], v);
+	}
+
+	for(size_t span = Lanes; span < size; span *= 2) {
+		for(size_t i = 0; i < size; i += span * 2) {
+			for(size_t j = i; j < i + span; j += Lanes) {
+				auto a = _mm256_loadu_ps(&data[j]);
+				auto b = _mm256_loadu_ps(&data[j + span]);
+				_mm256_storeu_ps(&data[j], _mm256_add_ps(a, b));
+				_mm256_storeu_ps(&data[j + span], _mm256_sub_ps(a, b));
+			}
+		}
+	}
+}
+
+void AVX2Kernel::chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height)
+{
+	static const size_t Lanes = 8;
+
+	const auto phaseVector = _mm256_set1_ps(phase);
+	const auto rateVector = _mm256_set1_ps(rate);
+	const auto four = _mm256_set1_ps(4.0f);
+	const auto oneInt = _mm256_set1_epi32(1);
+	const auto twoInt = _mm256_set1_epi32(2);
+	const auto one = _mm256_set1_ps(1.0f);
+	const auto heightVector = _mm256_set1_ps(height);
+
+	size_t frame = 0;
+	for(; frame + Lanes <= frames; frame += Lanes) {
+		auto x = _mm256_add_ps(_mm256_add_ps(phaseVector, _mm256_mul_ps(rateVector, _mm256_loadu_ps(&shape[frame]))), _mm256_loadu_ps(&curve[frame]));
+		auto r = _mm256_sub_ps(x, _mm256_cvtepi32_ps(_mm256_cvttps_epi32(x)));
+		auto q = _mm256_mul_ps(r, four);
+		auto quadrant = _mm256_cvttps_epi32(q);
+		r = _mm256_sub_ps(q, _mm256_cvtepi32_ps(quadrant));
+		auto odd = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, oneInt), oneInt));
+		auto t = _mm256_blendv_ps(r, _mm256_sub_ps(one, r), odd);
+		auto t2 = _mm256_mul_ps(t, t);
+		auto p = _mm256_set1_ps(SineC11);
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC9));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC7));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC5));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC3));
+		p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(SineC1));
+		auto s = _mm256_mul_ps(p, t);
+		s = _mm256_xor_ps(s, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, twoInt), 30)));
+		_mm256_storeu_ps(&dest[frame], _mm256_mul_ps(s, heightVector));
+	}
+	SSE2Kernel::chirp(&dest[frame], frames - frame, phase, rate, &shape[frame], &curve[frame], height);
+}
+
+// Wave table of 8 oscillators is read by gather.
+// 2 groups of 8 oscillators are advanced together to hide latency of the gather,
+// and are added to the sums in the order of the groups as ScalarKernel.
+void AVX2Kernel::oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators)
+{
+	static const size_t Lanes = 8;
+
+	alignas(32) float sums[OscillatorBankBlockFrames][Lanes];
+	const auto one = _mm256_set1_ps(1.0f);
+	for(size_t frame = 0; frame < frames; frame += OscillatorBankBlockFrames) {
+		auto count = min(frames - frame, OscillatorBankBlockFrames);
+		memset(sums, 0, sizeof(sums));
+		for(size_t i = 0; i < oscillators; ) {
+			size_t groups = (i + (Lanes * 2) <= oscillators) ? 2 : 1;
+			__m256i phase[2], delta[2], offset[2];
+			__m256 level[2];
+			for(size_t g = 0; g < groups; g++) {
+				auto o = i + (g * Lanes);
+				phase[g] = _mm256_loadu_si256((const __m256i*)&phases[o]);
+				delta[g] = _mm256_loadu_si256((const __m256i*)&deltas[o]);
+				offset[g] = _mm256_loadu_si256((const __m256i*)&tableOffsets[o]);
+				level[g] = _mm256_loadu_ps(&levels[o]);
+			}
+			for(size_t f = 0; f < count; f++) {
+				auto sum = _mm256_load_ps(sums[f]);
+				for(size_t g = 0; g < groups; g++) {
+					auto index = _mm256_add_epi32(offset[g], _mm256_srli_epi32(phase[g], 32 - SimdKernel::OscillatorBankTableBits));
+					auto fraction = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(
+						_mm256_srli_epi32(_mm256_slli_epi32(phase[g], SimdKernel::OscillatorBankTableBits), 9), _mm256_castps_si256(one))), one);
+					auto v0 = _mm256_i32gather_ps(tables, index, sizeof(float));
+					auto v1 = _mm256_i32gather_ps(&tables[1], index, sizeof(float));
+					auto v = _mm256_mul_ps(_mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), fraction)), level[g]);
+					sum = _mm256_add_ps(sum, v);
+					phase[g] = _mm256_add_epi32(phase[g], delta[g]);
+				}
+				_mm256_store_ps(sums[f], sum);
+			}
+			for(size_t g = 0; g < groups; g++) {
+				_mm256_storeu_si256((__m256i*)&phases[i + (g * Lanes)], phase[g]);
+			}
+			i += Lanes * groups;
+		}
+		for(size_t f = 0; f < count; f++) {
+			auto sum = _mm256_load_ps(sums[f]);
+			dest[frame + f] = sumOscillatorBankLanes(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+		}
+	}
+}
+
+// Wave table of 8 lanes is read by gather. See SSE2Kernel::oscillator() for the phase of the lanes.
+// table[index] and table[index + 1] are adjacent. So they are read as a 64-bit pair by gathers of 4 lanes,
+// and the pairs are shuffled to the values at index and index + 1.
+void AVX2Kernel::oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level)
+{
+	static const size_t Lanes = 8;
+
+	alignas(32) UINT32 high[Lanes], low[Lanes];
+	for(size_t i = 0; i < Lanes; i++) {
+		auto p = phase + (delta * i);
+		high[i] = (UINT32)(p >> 32);
+		low[i] = (UINT32)p;
+	}
+	auto phaseHigh = _mm256_load_si256((const __m256i*)high);
+	auto phaseLow = _mm256_load_si256((const __m256i*)low);
+	const UINT64 step = delta * Lanes;
+	const auto stepHigh = _mm256_set1_epi32((int)(step >> 32));
+	const auto stepLow = _mm256_set1_epi32((int)step);
+	const auto sign = _mm256_set1_epi32((int)0x80000000);
+	const auto one = _mm256_set1_ps(1.0f);
+	const auto levelVector = _mm256_set1_ps(level);
+	// Lanes 0, 1, 4, 5 are gathered first and lanes 2, 3, 6, 7 next,
+	// so that shuffle in each 128-bit half puts the values in the order of the lanes.
+	const auto order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+
+	size_t frame = 0;
+	for(; frame + Lanes <= frames; frame += Lanes) {
+		auto index = _mm256_permutevar8x32_epi32(_mm256_srli_epi32(phaseHigh, 32 - SimdKernel::OscillatorBankTableBits), order);
+		auto fraction = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(
+			_mm256_srli_epi32(_mm256_slli_epi32(phaseHigh, SimdKernel::OscillatorBankTableBits), 9), _mm256_castps_si256(one))), one);
+		auto pairs0 = _mm256_castsi256_ps(_mm256_i32gather_epi64((const long long*)table, _mm256_castsi256_si128(index), sizeof(float)));
+		auto pairs1 = _mm256_castsi256_ps(_mm256_i32gather_epi64((const long long*)table, _mm256_extracti128_si256(index, 1), sizeof(float)));
+		auto v0 = _mm256_shuffle_ps(pairs0, pairs1, _MM_SHUFFLE(2, 0, 2, 0));
+		auto v1 = _mm256_shuffle_ps(pairs0, pairs1, _MM_SHUFFLE(3, 1, 3, 1));
+		_mm256_storeu_ps(&dest[frame], _mm256_mul_ps(_mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), fraction)), levelVector));
+
+		auto newLow = _mm256_add_epi32(phaseLow, stepLow);
+		auto carry = _mm256_cmpgt_epi32(_mm256_xor_si256(stepLow, sign), _mm256_xor_si256(newLow, sign));
+		phaseHigh = _mm256_sub_epi32(_mm256_add_epi32(phaseHigh, stepHigh), carry);
+		phaseLow = newLow;
+	}
+	SSE2Kernel::oscillator(&dest[frame], frames - frame, table, phase + (delta * frame), delta, level);
+}
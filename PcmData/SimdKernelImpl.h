@@ -0,0 +1,340 @@
+#pragma once
+
+#include "SimdKernel.h"
+#include "INT24.h"
+
+#include <math.h>
+#include <emmintrin.h>
+
+/*
+ * Triangle wave as 2 lines.
+ *   u = fraction of ((position / frames) + shift)
+ *   value = sign * min((slope1 * u) + intercept1, (slope2 * u) + intercept2)
+ * Line 1 rises from -1.0 to the peak, and line 2 falls from the peak to -1.0.
+ * Sawtooth wave uses line 1 only. Line 2 is constant value above +1.0 in this case.
+ */
+struct TriangleShape
+{
+	float shift;
+	float slope1, intercept1;
+	float slope2, intercept2;
+	float sign;
+
+	TriangleShape(float peakPosition);
+};
+
+/*
+ * Implementations of SimdKernel for each instruction set.
+ *
+ * ScalarKernel and SSE2Kernel are defined in SimdKernel.cpp.
+ * SSSE3Kernel is defined in SimdKernelSSSE3.cpp, and has kernels for packed INT24 samples only.
+ * AVX2Kernel is defined in SimdKernelAVX2.cpp.
+ * Generation kernels write float master only.
+ * Conversion kernel is explicitly instantiated for UINT8, INT16, INT24, float, INT24in32, INT32 and double.
+ */
+struct ScalarKernel
+{
+	static void sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height);
+	static void square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low);
+	static void triangle(float* dest, size_t stride, size_t frames, size_t cycles, const TriangleShape& shape,
+						float zero, float positiveHeight, float negativeHeight);
+	template<typename T>
+	static void convert(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex);
+	static void packInt24(INT24* dest, const INT32* src, size_t count);
+	static void unpackInt24(INT32* dest, const INT24* src, size_t count);
+	static void unpackInt24(float* dest, const INT24* src, size_t count, float scale);
+	static void interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames);
+	static void add(float* dest, const float* src1, const float* src2, size_t count);
+	static void chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height);
+	static void whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+	static void pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+	static void expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero);
+	static void hadamard(float* data, size_t size);
+	static void oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators);
+	static void oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level);
+};
+
+struct SSE2Kernel
+{
+	static void sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height);
+	static void square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low);
+	static void triangle(float* dest, size_t stride, size_t frames, size_t cycles, const TriangleShape& shape,
+						float zero, float positiveHeight, float negativeHeight);
+	template<typename T>
+	static void convert(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex);
+	static void interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames);
+	static void add(float* dest, const float* src1, const float* src2, size_t count);
+	static void chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height);
+	static void whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+	static void pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+	static void expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero);
+	static void hadamard(float* data, size_t size);
+	static void oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators);
+	static void oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level);
+};
+
+struct SSSE3Kernel
+{
+	static void convert(INT24* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex);
+	static void packInt24(INT24* dest, const INT32* src, size_t count);
+	static void unpackInt24(INT32* dest, const INT24* src, size_t count);
+	static void unpackInt24(float* dest, const INT24* src, size_t count, float scale);
+};
+
+struct AVX2Kernel
+{
+	static void sine(float* dest, size_t stride, size_t frames, size_t cycles, float zero, float height);
+	static void square(float* dest, size_t stride, size_t frames, size_t cycles, size_t highFrames, float high, float low);
+	static void triangle(float* dest, size_t stride, size_t frames, size_t cycles, const TriangleShape& shape,
+						float zero, float positiveHeight, float negativeHeight);
+	template<typename T>
+	static void convert(T* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex);
+	static void packInt24(INT24* dest, const INT32* src, size_t count);
+	static void unpackInt24(INT32* dest, const INT24* src, size_t count);
+	static void unpackInt24(float* dest, const INT24* src, size_t count, float scale);
+	static void interleave(float* dest, const float* src, size_t srcStride, size_t channels, size_t frames);
+	static void add(float* dest, const float* src1, const float* src2, size_t count);
+	static void chirp(float* dest, size_t frames, float phase, float rate, const float* shape, const float* curve, float height);
+	static void whiteNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+	static void pinkNoise(float* dest, size_t count, UINT32 seed, UINT32 index, float height);
+	static void expandBits(float* dest, const UINT64* bits, size_t index, size_t count, float one, float zero);
+	static void hadamard(float* data, size_t size);
+	static void oscillatorBank(float* dest, size_t frames, const float* tables, const UINT32* tableOffsets,
+								UINT32* phases, const UINT32* deltas, const float* levels, size_t oscillators);
+	static void oscillator(float* dest, size_t frames, const float* table, UINT64 phase, UINT64 delta, float level);
+};
+
+// Note: Functions in this namespace are compiled in each file with the instruction set of the file.
+namespace
+{
+
+// Coefficients of polynomial for sin(pi / 2 * t), 0.0 <= t <= 1.0.
+// Taylor series of sin(x) up to x^11. Truncation error is less than 6e-8.
+static const float SineC1 = 1.570796327e+00f;
+static const float SineC3 = -6.459640975e-01f;
+static const float SineC5 = 7.969262625e-02f;
+static const float SineC7 = -4.681754135e-03f;
+static const float SineC9 = 1.604411848e-04f;
+static const float SineC11 = -3.598843235e-06f;
+
+// Writes values to dest at interval of stride.
+inline void storeValues(float* dest, size_t stride, const float* values, size_t count)
+{
+	for(size_t i = 0; i < count; i++) {
+		dest[i * stride] = values[i];
+	}
+}
+
+// Range of integer sample value to saturate.
+template<typename T> struct SampleLimit;
+template<> struct SampleLimit<UINT8> { static constexpr float Min = 0.0f; static constexpr float Max = 255.0f; };
+template<> struct SampleLimit<INT16> { static constexpr float Min = -32768.0f; static constexpr float Max = 32767.0f; };
+template<> struct SampleLimit<INT24> { static constexpr float Min = -8388608.0f; static constexpr float Max = 8388607.0f; };
+template<> struct SampleLimit<INT24in32> : SampleLimit<INT24> {};
+// Max is the largest float below 2^31, because 2^31 overflows _mm_cvtps_epi32().
+template<> struct SampleLimit<INT32> { static constexpr float Min = -2147483648.0f; static constexpr float Max = 2147483520.0f; };
+
+// Returns packed 24-bit value at p by shift, instead of INT24 class that copies each byte.
+inline INT32 loadInt24(const BYTE* p)
+{
+	return (INT32)(((UINT32)p[0] << 8) | ((UINT32)p[1] << 16) | ((UINT32)p[2] << 24)) >> 8;
+}
+
+// Writes low 24 bits of value to p.
+inline void storeInt24(BYTE* p, INT32 value)
+{
+	p[0] = (BYTE)value;
+	p[1] = (BYTE)(value >> 8);
+	p[2] = (BYTE)(value >> 16);
+}
+
+// Hash of the dither index(Integer hash by Bob Jenkins).
+// Consists of add, xor and shift only, so that SSE2 calculates the same value without 32-bit multiply.
+inline UINT32 ditherHash(UINT32 a)
+{
+	a = (a + 0x7ed55d16) + (a << 12);
+	a = (a ^ 0xc761c23c) ^ (a >> 19);
+	a = (a + 0x165667b1) + (a << 5);
+	a = (a + 0xd3a2646c) ^ (a << 9);
+	a = (a + 0xfd7046c5) + (a << 3);
+	a = (a ^ 0xb55a4f09) ^ (a >> 16);
+	return a;
+}
+
+// Scale of 16-bit uniform random value.
+static const float DitherScale = 1.0f / 65536.0f;
+
+// TPDF noise(-1.0 < noise < +1.0) as difference of 2 uniform random values in high and low 16 bits of the hash.
+inline float ditherNoise(UINT32 index)
+{
+	auto hash = ditherHash(index);
+	return (float)((INT32)(hash >> 16) - (INT32)(hash & 0xffff)) * DitherScale;
+}
+
+// Scale of 32-bit signed random value to -1.0 ~ +1.0.
+static const float NoiseScale = 1.0f / 2147483648.0f;
+
+// Returns key of noise row that is xored with the index before hashed.
+// Row 0 is white noise, and row r + 1 is row r of SimdKernel::pinkNoise().
+inline UINT32 noiseKey(UINT32 seed, UINT32 row)
+{
+	return ditherHash(ditherHash(seed) + row);
+}
+
+// Returns uniform random value(-1.0 <= value < +1.0) of the index in the stream of the key.
+inline float noiseValue(UINT32 key, UINT32 index)
+{
+	return (float)(INT32)ditherHash(key ^ index) * NoiseScale;
+}
+
+// Returns value of float master converted to sample.
+// Integer value is rounded to nearest even and saturated, same as SIMD kernels using _mm_cvtps_epi32().
+template<typename T>
+inline T convertSample(float value, float zero, float height, float noise)
+{
+	auto v = ((value * height) + zero) + noise;
+	if(v < SampleLimit<T>::Min) { v = SampleLimit<T>::Min; }
+	if(SampleLimit<T>::Max < v) { v = SampleLimit<T>::Max; }
+	return (T)(INT32)lrintf(v);
+}
+
+template<>
+inline float convertSample<float>(float value, float zero, float height, float)
+{
+	return (value * height) + zero;
+}
+
+// Calculated by float same as float sample, and widened to double.
+template<>
+inline double convertSample<double>(float value, float zero, float height, float)
+{
+	return (double)((value * height) + zero);
+}
+
+// ditherHash() of 4 lanes.
+inline __m128i ditherHashSSE2(__m128i a)
+{
+	a = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x7ed55d16)), _mm_slli_epi32(a, 12));
+	a = _mm_xor_si128(_mm_xor_si128(a, _mm_set1_epi32((int)0xc761c23c)), _mm_srli_epi32(a, 19));
+	a = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x165667b1)), _mm_slli_epi32(a, 5));
+	a = _mm_xor_si128(_mm_add_epi32(a, _mm_set1_epi32((int)0xd3a2646c)), _mm_slli_epi32(a, 9));
+	a = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32((int)0xfd7046c5)), _mm_slli_epi32(a, 3));
+	a = _mm_xor_si128(_mm_xor_si128(a, _mm_set1_epi32((int)0xb55a4f09)), _mm_srli_epi32(a, 16));
+	return a;
+}
+
+// noiseValue() of 4 lanes.
+inline __m128 noiseValueSSE2(__m128i key, __m128i index)
+{
+	return _mm_mul_ps(_mm_cvtepi32_ps(ditherHashSSE2(_mm_xor_si128(key, index))), _mm_set1_ps(NoiseScale));
+}
+
+// TPDF noise of 4 lanes for consecutive dither indexes. See ditherNoise().
+class DitherSSE2
+{
+public:
+	DitherSSE2(UINT32 index) : m_index(_mm_add_epi32(_mm_set1_epi32((int)index), _mm_setr_epi32(0, 1, 2, 3))) {}
+
+	__m128 next() {
+		auto a = ditherHashSSE2(m_index);
+		auto noise = _mm_sub_epi32(_mm_srli_epi32(a, 16), _mm_and_si128(a, _mm_set1_epi32(0xffff)));
+		m_index = _mm_add_epi32(m_index, _mm_set1_epi32(4));
+		return _mm_mul_ps(_mm_cvtepi32_ps(noise), _mm_set1_ps(DitherScale));
+	}
+
+protected:
+	__m128i m_index;
+};
+
+// Range to clamp values before stored as samples.
+// Float sample is not clamped.
+template<typename T>
+struct SampleRangeSSE2
+{
+	SampleRangeSSE2() : low(_mm_set1_ps(SampleLimit<T>::Min)), high(_mm_set1_ps(SampleLimit<T>::Max)) {}
+	__m128 clamp(__m128 values) const { return _mm_min_ps(_mm_max_ps(values, low), high); }
+	const __m128 low, high;
+};
+
+template<>
+struct SampleRangeSSE2<float>
+{
+	__m128 clamp(__m128 values) const { return values; }
+};
+
+template<>
+struct SampleRangeSSE2<double> : SampleRangeSSE2<float> {};
+
+// Interleaves 4 frames of channels from firstChannel to the last channel.
+//   dest[(frame * channels) + channel] = src[(channel * srcStride) + frame], 0 <= frame < 4
+// Each 4 channels are transposed as 4x4 matrix, and rest of 2 channels are unpacked to 64-bit pairs.
+// Every channel is written by it's own lane, so that stores do not overlap another channel.
+inline void interleave4Frames(float* dest, const float* src, size_t srcStride, size_t channels, size_t firstChannel)
+{
+	auto channel = firstChannel;
+	for(; channel + 4 <= channels; channel += 4) {
+		auto c0 = _mm_loadu_ps(&src[channel * srcStride]);
+		auto c1 = _mm_loadu_ps(&src[(channel + 1) * srcStride]);
+		auto c2 = _mm_loadu_ps(&src[(channel + 2) * srcStride]);
+		auto c3 = _mm_loadu_ps(&src[(channel + 3) * srcStride]);
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+		_mm_storeu_ps(&dest[channel], c0);
+		_mm_storeu_ps(&dest[channels + channel], c1);
+		_mm_storeu_ps(&dest[(channels * 2) + channel], c2);
+		_mm_storeu_ps(&dest[(channels * 3) + channel], c3);
+	}
+	for(; channel + 2 <= channels; channel += 2) {
+		auto c0 = _mm_loadu_ps(&src[channel * srcStride]);
+		auto c1 = _mm_loadu_ps(&src[(channel + 1) * srcStride]);
+		auto low = _mm_unpacklo_ps(c0, c1);
+		auto high = _mm_unpackhi_ps(c0, c1);
+		_mm_storel_pi((__m64*)&dest[channel], low);
+		_mm_storeh_pi((__m64*)&dest[channels + channel], low);
+		_mm_storel_pi((__m64*)&dest[(channels * 2) + channel], high);
+		_mm_storeh_pi((__m64*)&dest[(channels * 3) + channel], high);
+	}
+	for(; channel < channels; channel++) {
+		for(size_t frame = 0; frame < 4; frame++) {
+			dest[(frame * channels) + channel] = src[(channel * srcStride) + frame];
+		}
+	}
+}
+
+// Frames summed by oscillatorBank() at once.
+// Sum of the lanes of each frame is held in the buffer on the stack while oscillators are added.
+static const size_t OscillatorBankBlockFrames = 64;
+
+// Returns value of the wave table at 32-bit phase. See SimdKernel::oscillatorBank().
+// Fraction is set to mantissa of 1.0f to get 1.0 ~ 2.0 without int to float conversion, as SIMD kernels.
+inline float oscillatorBankValue(const float* table, UINT32 phase)
+{
+	auto index = phase >> (32 - SimdKernel::OscillatorBankTableBits);
+	auto bits = ((phase << SimdKernel::OscillatorBankTableBits) >> 9) | 0x3f800000;
+	float fraction;
+	memcpy(&fraction, &bits, sizeof(fraction));
+	fraction -= 1.0f;
+	auto v0 = table[index];
+	return v0 + ((table[index + 1] - v0) * fraction);
+}
+
+// Sums 8 lanes of oscillatorBank() in the order of SSE2 horizontal add.
+//   ((lane0 + lane4) + (lane2 + lane6)) + ((lane1 + lane5) + (lane3 + lane7))
+inline float sumOscillatorBankLanes(const float* lanes)
+{
+	float s[4];
+	for(int i = 0; i < 4; i++) { s[i] = lanes[i] + lanes[i + 4]; }
+	return (s[0] + s[2]) + (s[1] + s[3]);
+}
+
+// Sums 8 lanes held by 2 vectors. See sumOscillatorBankLanes().
+inline float sumOscillatorBankLanes(__m128 low, __m128 high)
+{
+	auto s = _mm_add_ps(low, high);
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(s);
+}
+
+}
@@ -0,0 +1,126 @@
+#include "SimdKernelImpl.h"
+
+#include <tmmintrin.h>
+
+// SSSE3 implementations of SimdKernel for packed INT24 samples.
+// These functions are called only if the CPU supports SSSE3(See SimdKernel::getSupportedInstructionSet()).
+// 16 samples(48 bytes) are processed at once as 3 vectors, so that no byte out of the buffer is read or written.
+// PSHUFB moves 3 bytes of each sample to/from 32-bit lane.
+
+namespace
+{
+
+// Moves 3 bytes of 4 samples at the low 12 bytes to high 3 bytes of each 32-bit lane.
+// Then arithmetic shift extends the sign.
+inline __m128i unpack4(__m128i bytes)
+{
+	const auto mask = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	return _mm_srai_epi32(_mm_shuffle_epi8(bytes, mask), 8);
+}
+
+// Moves low 3 bytes of each 32-bit lane to the low 12 bytes.
+inline __m128i pack4(__m128i values)
+{
+	const auto mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	return _mm_shuffle_epi8(values, mask);
+}
+
+// Loads 16 samples from p to 4 vectors of INT32.
+inline void load16(const BYTE* p, __m128i (&values)[4])
+{
+	auto a = _mm_loadu_si128((const __m128i*)p);
+	auto b = _mm_loadu_si128((const __m128i*)(p + 16));
+	auto c = _mm_loadu_si128((const __m128i*)(p + 32));
+	values[0] = unpack4(a);
+	values[1] = unpack4(_mm_alignr_epi8(b, a, 12));
+	values[2] = unpack4(_mm_alignr_epi8(c, b, 8));
+	values[3] = unpack4(_mm_srli_si128(c, 4));
+}
+
+// Stores 4 vectors of INT32 to p as 16 samples.
+// Values should be in the range of INT24 already.
+inline void store16(BYTE* p, const __m128i (&values)[4])
+{
+	auto v0 = pack4(values[0]);
+	auto v1 = pack4(values[1]);
+	auto v2 = pack4(values[2]);
+	auto v3 = pack4(values[3]);
+	_mm_storeu_si128((__m128i*)p, _mm_or_si128(v0, _mm_slli_si128(v1, 12)));
+	_mm_storeu_si128((__m128i*)(p + 16), _mm_or_si128(_mm_srli_si128(v1, 4), _mm_slli_si128(v2, 8)));
+	_mm_storeu_si128((__m128i*)(p + 32), _mm_or_si128(_mm_srli_si128(v2, 8), _mm_slli_si128(v3, 4)));
+}
+
+// Saturates INT32 values to the range of INT24.
+// SSSE3 does not have PMINSD/PMAXSD(SSE4.1).
+inline __m128i saturate(__m128i values)
+{
+	const auto min = _mm_set1_epi32(-0x800000);
+	const auto max = _mm_set1_epi32(0x7fffff);
+	auto over = _mm_cmpgt_epi32(values, max);
+	values = _mm_or_si128(_mm_and_si128(over, max), _mm_andnot_si128(over, values));
+	auto under = _mm_cmpgt_epi32(min, values);
+	return _mm_or_si128(_mm_and_si128(under, min), _mm_andnot_si128(under, values));
+}
+
+static const size_t Lanes = 16;
+
+}
+
+void SSSE3Kernel::convert(INT24* dest, const float* src, size_t count, float zero, float height, bool dither, UINT32 ditherIndex)
+{
+	const auto zeroVector = _mm_set1_ps(zero);
+	const auto heightVector = _mm_set1_ps(height);
+	const SampleRangeSSE2<INT24> range;
+	DitherSSE2 noise(ditherIndex);
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		__m128i values[4];
+		for(size_t j = 0; j < 4; j++) {
+			auto v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src[i + (j * 4)]), heightVector), zeroVector);
+			if(dither) { v = _mm_add_ps(v, noise.next()); }
+			values[j] = _mm_cvtps_epi32(range.clamp(v));
+		}
+		store16((BYTE*)&dest[i], values);
+	}
+	ScalarKernel::convert(&dest[i], &src[i], count - i, zero, height, dither, ditherIndex + (UINT32)i);
+}
+
+void SSSE3Kernel::packInt24(INT24* dest, const INT32* src, size_t count)
+{
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		__m128i values[4];
+		for(size_t j = 0; j < 4; j++) {
+			values[j] = saturate(_mm_loadu_si128((const __m128i*)&src[i + (j * 4)]));
+		}
+		store16((BYTE*)&dest[i], values);
+	}
+	ScalarKernel::packInt24(&dest[i], &src[i], count - i);
+}
+
+void SSSE3Kernel::unpackInt24(INT32* dest, const INT24* src, size_t count)
+{
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		__m128i values[4];
+		load16((const BYTE*)&src[i], values);
+		for(size_t j = 0; j < 4; j++) {
+			_mm_storeu_si128((__m128i*)&dest[i + (j * 4)], values[j]);
+		}
+	}
+	ScalarKernel::unpackInt24(&dest[i], &src[i], count - i);
+}
+
+void SSSE3Kernel::unpackInt24(float* dest, const INT24* src, size_t count, float scale)
+{
+	const auto scaleVector = _mm_set1_ps(scale);
+	size_t i = 0;
+	for(; i + Lanes <= count; i += Lanes) {
+		__m128i values[4];
+		load16((const BYTE*)&src[i], values);
+		for(size_t j = 0; j < 4; j++) {
+			_mm_storeu_ps(&dest[i + (j * 4)], _mm_mul_ps(_mm_cvtepi32_ps(values[j]), scaleVector));
+		}
+	}
+	ScalarKernel::unpackInt24(&dest[i], &src[i], count - i, scale);
+}
@@ -0,0 +1,128 @@
+#include "SineTable.h"
+
+#include <math.h>
+
+namespace
+{
+
+constexpr double Pi = 3.14159265358979323846;
+
+// Returns sin(x) and cos(x), -pi / 2 <= x <= +pi / 2, by Taylor series up to x^25.
+// Truncation error is less than 1e-18.
+constexpr double taylorSin(double x)
+{
+	double term = x;
+	double sum = x;
+	for(int n = 2; n < 26; n += 2) {
+		term *= -x * x / (n * (n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double taylorCos(double x)
+{
+	double term = 1;
+	double sum = 1;
+	for(int n = 1; n < 25; n += 2) {
+		term *= -x * x / (n * (n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+// sin(pi / 2 * i / Size), 0 <= i <= Size.
+// Angle of i is split into coarse part(high bits) and fine part(low FineBits bits),
+// and the value is calculated by angle addition formula from sin and cos of both parts.
+// Taylor series are calculated for the parts only, to keep evaluation steps within the limit of the compiler.
+class QuarterTable
+{
+public:
+	static const int FineBits = SineTable::Bits / 2;
+	static const size_t FineSize = (size_t)1 << FineBits;
+	static const size_t CoarseSize = (SineTable::Size >> FineBits) + 1;
+
+	constexpr QuarterTable() : values()
+	{
+		double fineSin[FineSize] = {};
+		double fineCos[FineSize] = {};
+		for(size_t i = 0; i < FineSize; i++) {
+			auto x = Pi / 2 * i / SineTable::Size;
+			fineSin[i] = taylorSin(x);
+			fineCos[i] = taylorCos(x);
+		}
+		for(size_t c = 0; c < CoarseSize; c++) {
+			// Angle of the coarse part does not exceed pi / 2.
+			auto x = Pi / 2 * (c << FineBits) / SineTable::Size;
+			auto coarseSin = taylorSin(x);
+			auto coarseCos = taylorCos(x);
+			for(size_t f = 0; (f < FineSize) && (((c << FineBits) + f) <= SineTable::Size); f++) {
+				values[(c << FineBits) + f] = (coarseSin * fineCos[f]) + (coarseCos * fineSin[f]);
+			}
+		}
+	}
+
+	double values[SineTable::Size + 1];
+};
+
+// Defined as constexpr, so that the table is calculated by the compiler.
+constexpr QuarterTable quarterTable;
+
+}
+
+// Each value is rounded from sum of products of 2 values, which have rounding error of less than 1 ulp.
+// Includes rounding error of the angle passed to sin().
+const double SineTable::MaxTableError = 1e-15;
+// Error of linear interpolation is less than h^2 / 8 * max(|sin''|), where h = pi / 2 / Size.
+const double SineTable::MaxInterpolationError = ((Pi / 2 / Size) * (Pi / 2 / Size) / 8) + 1e-15;
+
+/*static*/ double SineTable::quarter(size_t index)
+{
+	return quarterTable.values[index];
+}
+
+/*static*/ double SineTable::wave(size_t index)
+{
+	//   Quadrant 0: sin(pi / 2 * t), t = index / Size
+	//   Quadrant 1: sin(pi / 2 * (1 - t))
+	//   Quadrant 2: -sin(pi / 2 * t)
+	//   Quadrant 3: -sin(pi / 2 * (1 - t))
+	auto quadrant = (index >> Bits) & 3;
+	auto t = index & (Size - 1);
+	auto value = quarterTable.values[(quadrant & 1) ? (Size - t) : t];
+	return (quadrant & 2) ? -value : value;
+}
+
+/*static*/ double SineTable::sinAt(size_t index, size_t period)
+{
+	index %= period;
+	if(((4 * Size) % period) == 0) {
+		return wave(index * ((4 * Size) / period));
+	}
+	return sinCycle((double)index / period);
+}
+
+/*static*/ double SineTable::cosAt(size_t index, size_t period)
+{
+	index %= period;
+	if(((4 * Size) % period) == 0) {
+		// cos(x) = sin(x + pi / 2)
+		return wave((index * ((4 * Size) / period)) + Size);
+	}
+	return cosCycle((double)index / period);
+}
+
+/*static*/ double SineTable::sinCycle(double x)
+{
+	// x - floor(x) might be rounded to 1.0, that is same as 0.0 for wave().
+	auto position = (x - floor(x)) * (4 * Size);
+	auto index = (size_t)position;
+	auto fraction = position - (double)index;
+	auto value = wave(index);
+	return value + ((wave(index + 1) - value) * fraction);
+}
+
+/*static*/ double SineTable::cosCycle(double x)
+{
+	return sinCycle(x + 0.25);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Windows.h>
+
+// Number of bits of intervals in quarter-wave of SineTable.
+// Table size is 8 * (2^bits + 1) bytes, and error of linear interpolation is proportional to 1 / 4^bits:
+//   10: 8KB, 3e-7   12: 32KB, 2e-8   14: 128KB, 1.2e-9
+// Large value may require to raise limit of constexpr evaluation of the compiler(/constexpr:steps of MSVC).
+#ifndef PCMDATA_SINE_TABLE_BITS
+#define PCMDATA_SINE_TABLE_BITS 12
+#endif
+
+/*
+ * SineTable class
+ *
+ * Quarter-wave table of sine in double precision, that is calculated by constexpr function at compile time
+ * and embedded in the library, so that no time is spent to initialize it at run time.
+ * Other quadrants are read from the table using quarter-wave symmetry.
+ *
+ * sinAt() and cosAt() read the table without interpolation, when 4 * Size is a multiple of the period.
+ * Otherwise, and in sinCycle() and cosCycle(), adjacent values are interpolated linearly.
+ */
+class SineTable
+{
+public:
+	static const int Bits = PCMDATA_SINE_TABLE_BITS;
+	// Number of intervals in quarter-wave. The table has Size + 1 values.
+	static const size_t Size = (size_t)1 << Bits;
+
+	static_assert((4 <= Bits) && (Bits <= 16), "PCMDATA_SINE_TABLE_BITS should be 4 ~ 16");
+
+	// Max absolute error of values in the table compared with sin() of C runtime library.
+	static const double MaxTableError;
+	// Max absolute error of interpolated value compared with sin() of C runtime library.
+	static const double MaxInterpolationError;
+
+	// Returns sin(pi / 2 * index / Size), 0 <= index <= Size.
+	static double quarter(size_t index);
+
+	// Returns sin(2 * pi * index / period) and cos(2 * pi * index / period).
+	static double sinAt(size_t index, size_t period);
+	static double cosAt(size_t index, size_t period);
+
+	// Returns sin(2 * pi * x) and cos(2 * pi * x), where x is position in cycles.
+	static double sinCycle(double x);
+	static double cosCycle(double x);
+
+protected:
+	// Returns sin(2 * pi * index / (4 * Size)).
+	static double wave(size_t index);
+};
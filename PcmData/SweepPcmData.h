@@ -0,0 +1,207 @@
+#pragma once
+
+#include "PcmDataImpl.h"
+#include "SimdKernel.h"
+
+#include <math.h>
+
+/*
+ * SweepPcmData template class derived from PcmData class.
+ *
+ * Synthesizes sine wave that sweeps frequency from startKey to endKey(chirp) passed to generateSweep() method,
+ * such as swept-sine signal for frequency response measurement.
+ *
+ * Phase of the sweep is a function of the frame:
+ *   Linear:      phase(n) = r0 * n + ((r1 - r0) / (2 * N)) * n^2
+ *   Logarithmic: phase(n) = r0 * L * (exp(n / L) - 1), L = N / ln(r1 / r0)
+ *   where r0 and r1 are start and end frequency per frame(key / samplesPerSec), and N is frames of the sweep.
+ * Phase at the first frame of each block of BlockFrames is calculated by double without accumulating error,
+ * and frames in the block are synthesized by SimdKernel::chirp() from shape and curve that are same for every block.
+ * Nothing depends on the length of the sweep, so that a sweep of any length is synthesized in constant memory.
+ *
+ * Blocks start at multiple of BlockFrames from the beginning of the sweep,
+ * so that samples do not depend on how they are split into copyTo() calls.
+ * This class has no 1-cycle data, so that createPcmSample() returns nullptr.
+ */
+template<typename T>
+class SweepPcmData : public PcmData<T>
+{
+public:
+	SweepPcmData(DWORD samplesPerSec, WORD channels, IWaveGenerator* waveGenerator)
+		: PcmData<T>(samplesPerSec, channels, waveGenerator) {}
+
+	using PcmData<T>::copyTo;
+	// Generates sine wave of the key that does not end. phaseShift is ignored because channels are same.
+	virtual void generate(float key, float level, float phaseShift) override;
+	// Channels are not independent.
+	virtual HRESULT generateChannels(const IPcmData::ToneParameter*) override { return E_NOTIMPL; }
+	virtual HRESULT generateSweep(float startKey, float endKey, size_t milliseconds, IPcmData::SweepLaw law, float level) override;
+
+	// Sweep is not based on cycle data. So blockSize and exact period are ignored.
+	virtual HRESULT setBlockSize(size_t, size_t) override { return S_OK; }
+	virtual HRESULT setExactPeriod(size_t) override { return S_OK; }
+	// Sweep always restarts when it is generated. So retune mode is ignored.
+	virtual HRESULT setRetuneMode(IPcmData::RetuneMode, size_t) override { return S_OK; }
+
+	virtual IPcmData::SynthesisMode getSynthesisMode() const override { return IPcmData::SynthesisMode::Sweep; }
+	virtual size_t getCycleDataSize() const override { return sizeof(Sweep::shape) + sizeof(Sweep::curve); }
+	virtual bool isTiled() const override { return false; }
+
+	// Frame count synthesized from the phase at the first frame of the block.
+	// Float phase in the block is less than (0.5 * BlockFrames) cycles, that keeps error of the phase about 1e-6 cycle.
+	static const size_t BlockFrames = 64;
+
+protected:
+	// Sweep calculated by generate() or generateSweep() method and read by copyTo() method.
+	struct Sweep
+	{
+		Sweep(size_t frames, double startRate, double endRate, IPcmData::SweepLaw law, size_t generation);
+
+		// Frames of the sweep, that is repeated.
+		const size_t frames;
+		// Frequency per frame at the beginning and the end.
+		const double startRate;
+		const double endRate;
+		// True if the sweep is logarithmic, and frames in which the frequency changes by e times.
+		bool isLogarithmic;
+		double length;
+		// Phase of frame i in the block relative to the first frame of the block:
+		//   (rate at the first frame * shape[i]) + curve[i]
+		float shape[BlockFrames];
+		float curve[BlockFrames];
+		// Incremented by generate() and generateSweep(). Position restarts when the generation is changed.
+		const size_t generation;
+
+		// Returns phase(1.0 = 1 cycle) from the beginning of the sweep to the frame.
+		double getPhase(size_t frame) const;
+		// Returns frequency per frame at the frame.
+		double getRate(size_t frame) const;
+	};
+
+	EpochPtr<Sweep> m_sweep;
+
+	// position.position of Position holds frame in the sweep.
+	virtual HRESULT copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest) override;
+
+	// Publishes the sweep to copyTo(), and sets properties.
+	void publish(std::unique_ptr<Sweep>&& sweep, size_t samplesPerCycle, float level);
+};
+
+template<typename T>
+SweepPcmData<T>::Sweep::Sweep(size_t frames, double startRate, double endRate, IPcmData::SweepLaw law, size_t generation)
+	: frames(frames), startRate(startRate), endRate(endRate)
+	, isLogarithmic((law == IPcmData::SweepLaw::Logarithmic) && (startRate != endRate)), length(0)
+	, generation(generation)
+{
+	if(isLogarithmic) {
+		length = frames / log(endRate / startRate);
+	}
+	for(size_t i = 0; i < BlockFrames; i++) {
+		if(isLogarithmic) {
+			shape[i] = (float)(length * expm1(i / length));
+			curve[i] = 0;
+		} else {
+			shape[i] = (float)i;
+			curve[i] = (float)((endRate - startRate) / (2.0 * frames) * i * i);
+		}
+	}
+}
+
+template<typename T>
+double SweepPcmData<T>::Sweep::getPhase(size_t frame) const
+{
+	return isLogarithmic ?
+		startRate * length * expm1(frame / length) :
+		(startRate * frame) + ((endRate - startRate) / (2.0 * frames) * frame * frame);
+}
+
+template<typename T>
+double SweepPcmData<T>::Sweep::getRate(size_t frame) const
+{
+	return isLogarithmic ?
+		startRate * exp(frame / length) :
+		startRate + ((endRate - startRate) * frame / frames);
+}
+
+template<typename T>
+HRESULT SweepPcmData<T>::copy(typename PcmData<T>::Position& position, const typename PcmData<T>::Destination& dest)
+{
+	typename EpochPtr<Sweep>::Reader sweep(m_sweep);
+
+	// Assert that data has been generated.
+	HR_ASSERT(sweep.get(), E_ILLEGAL_METHOD_CALL);
+
+	if(position.generation.load() != sweep->generation) {
+		position.generation = sweep->generation;
+		position.position = 0;
+	}
+
+	auto current = position.position.load();
+	const auto level = this->getLevel(sweep->generation);
+
+	// Sweep is synthesized in the buffer on the stack as master of all channels(stride = 0).
+	float buffer[PcmData<T>::ConvertBufferSamples];
+	for(size_t frame = 0; frame < dest.frames; frame += PcmData<T>::ConvertBufferSamples) {
+		auto count = min(dest.frames - frame, PcmData<T>::ConvertBufferSamples);
+		for(size_t done = 0; done < count;) {
+			auto offset = current % BlockFrames;
+			auto n = min(min(count - done, BlockFrames - offset), sweep->frames - current);
+			auto phase = sweep->getPhase(current - offset);
+			SimdKernel::chirp(&buffer[done], n, (float)(phase - floor(phase)), (float)sweep->getRate(current - offset),
+								&sweep->shape[offset], &sweep->curve[offset], 1.0f);
+			done += n;
+			current += n;
+			if(sweep->frames <= current) { current = 0; }
+		}
+		this->put(position, level, dest, frame, buffer, 0, count);
+	}
+	position.position = current;
+	return S_OK;
+}
+
+template<typename T>
+void SweepPcmData<T>::generate(float key, float level, float)
+{
+	CriticalSection lock(this->m_cycleDataLock);
+
+	// Frequency should be less than or equal to Nyquist frequency.
+	auto rate = (double)key / this->m_samplesPerSec;
+	if(0.5 < rate) { rate = 0.5; }
+	// Frames of continuous tone is the max value, that is never reached by copyTo().
+	std::unique_ptr<Sweep> sweep(new Sweep(SIZE_MAX, rate, rate, IPcmData::SweepLaw::Linear, ++this->m_generation));
+
+	// Samples per cycle is used to calculate buffer size for 1 cycle of the key.
+	publish(std::move(sweep), this->ceiling((size_t)(this->m_samplesPerSec * this->m_channels / key), this->m_channels), level);
+}
+
+template<typename T>
+HRESULT SweepPcmData<T>::generateSweep(float startKey, float endKey, size_t milliseconds, IPcmData::SweepLaw law, float level)
+{
+	auto nyquist = this->m_samplesPerSec / 2.0f;
+	HR_ASSERT((0 < startKey) && (startKey <= nyquist), E_INVALIDARG);
+	HR_ASSERT((0 < endKey) && (endKey <= nyquist), E_INVALIDARG);
+	auto frames = (size_t)this->m_samplesPerSec * milliseconds / 1000;
+	HR_ASSERT(0 < frames, E_INVALIDARG);
+
+	CriticalSection lock(this->m_cycleDataLock);
+
+	std::unique_ptr<Sweep> sweep(new Sweep(frames,
+		(double)startKey / this->m_samplesPerSec, (double)endKey / this->m_samplesPerSec, law, ++this->m_generation));
+
+	// Samples per cycle of the sweep is the whole sweep, so that getSampleBufferSize(0) returns size of the sweep.
+	publish(std::move(sweep), frames * this->m_channels, level);
+	return S_OK;
+}
+
+template<typename T>
+void SweepPcmData<T>::publish(std::unique_ptr<Sweep>&& sweep, size_t samplesPerCycle, float level)
+{
+	// Publish new sweep to copyTo() without blocking it.
+	this->publishLevel(level, 0, sweep->generation);
+	m_sweep.publish(std::move(sweep));
+
+	this->m_samplesPerCycle = samplesPerCycle;
+	this->m_cycles = 1;
+	// Phase is calculated exactly at the beginning of each block.
+	this->m_frequencyError = 0;
+}
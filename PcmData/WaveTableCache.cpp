@@ -0,0 +1,186 @@
+#include "WaveTableCache.h"
+#include "PcmDataImpl.h"
+#include "SineTable.h"
+
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+// Transforms size(power of 2) complex values in place by radix-2 FFT without normalization.
+//   data[k] = sum of data[n] * exp(sign * 2 * pi * i * k * n / size)
+// Twiddle factor of each position in the butterfly is read from SineTable, so that error is not accumulated.
+// Size up to 4 * SineTable::Size reads the table without interpolation.
+static void fft(std::complex<double>* data, size_t size, int sign)
+{
+	// Bit-reversal permutation.
+	for(size_t i = 1, j = 0; i < size; i++) {
+		auto bit = size >> 1;
+		for(; j & bit; bit >>= 1) { j ^= bit; }
+		j ^= bit;
+		if(i < j) { std::swap(data[i], data[j]); }
+	}
+
+	for(size_t length = 2; length <= size; length <<= 1) {
+		auto half = length / 2;
+		for(size_t k = 0; k < half; k++) {
+			std::complex<double> w(SineTable::cosAt(k, length), sign * SineTable::sinAt(k, length));
+			for(size_t start = 0; start < size; start += length) {
+				auto& a = data[start + k];
+				auto& b = data[start + k + half];
+				auto t = b * w;
+				b = a - t;
+				a += t;
+			}
+		}
+	}
+}
+
+/*static*/ WaveTableCache& WaveTableCache::getInstance()
+{
+	static WaveTableCache instance;
+	return instance;
+}
+
+/*static*/ size_t WaveTableCache::getHarmonics(int level)
+{
+	// Nyquist frequency of the table is excluded.
+	return min((TableSize / 2) - 1, (TableSize / 2) >> level);
+}
+
+/*static*/ int WaveTableCache::getLevel(float key, DWORD samplesPerSec)
+{
+	auto nyquist = samplesPerSec / 2.0;
+	int level = 0;
+	while((level < (Levels - 1)) && (nyquist < ((double)key * getHarmonics(level)))) {
+		level++;
+	}
+	return level;
+}
+
+std::shared_ptr<const WaveTableCache::Tables> WaveTableCache::getTables(const WaveForm& waveForm)
+{
+	const Key key(waveForm.getWaveFormType(), waveForm.getParameter(), 0, 0);
+
+	// Tables are generated in the lock, so that the same wave form is not generated twice.
+	// generate() of IPcmData calls this method, while copyTo() does not.
+	CriticalSection lock(m_lock);
+
+	auto entry = find(key);
+	if(entry) { return entry->tables; }
+
+	auto tables = generate(waveForm);
+	add({ key, tables, nullptr, tables->getBytes() });
+	return tables;
+}
+
+std::shared_ptr<const WaveTableCache::Master> WaveTableCache::getMaster(const WaveForm& waveForm, size_t frames, size_t cycles)
+{
+	const Key key(waveForm.getWaveFormType(), waveForm.getParameter(), frames, cycles);
+
+	CriticalSection lock(m_lock);
+
+	auto entry = find(key);
+	if(entry) { return entry->master; }
+
+	auto master = std::make_shared<Master>(frames);
+	waveForm.generate(master->data(), frames, 1, cycles);
+	add({ key, nullptr, master, frames * sizeof(float) });
+	return master;
+}
+
+WaveTableCache::Statistics WaveTableCache::getStatistics() const
+{
+	CriticalSection lock(m_lock);
+
+	Statistics statistics = { m_hits, m_misses, m_evictions, m_entries.size(), m_bytes, m_maxBytes };
+	return statistics;
+}
+
+void WaveTableCache::setMaxBytes(size_t maxBytes)
+{
+	CriticalSection lock(m_lock);
+
+	m_maxBytes = maxBytes;
+	evict();
+}
+
+void WaveTableCache::clear()
+{
+	CriticalSection lock(m_lock);
+
+	m_index.clear();
+	m_entries.clear();
+	m_bytes = 0;
+	m_hits = m_misses = m_evictions = 0;
+}
+
+const WaveTableCache::Entry* WaveTableCache::find(const Key& key)
+{
+	auto it = m_index.find(key);
+	if(it == m_index.end()) {
+		m_misses++;
+		return nullptr;
+	}
+
+	m_hits++;
+	// Move the entry to the front as most recently used.
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	return &*it->second;
+}
+
+void WaveTableCache::add(Entry&& entry)
+{
+	m_bytes += entry.bytes;
+	m_entries.push_front(std::move(entry));
+	m_index[m_entries.front().key] = m_entries.begin();
+	evict();
+}
+
+void WaveTableCache::evict()
+{
+	while(!m_entries.empty() && (m_maxBytes < m_bytes)) {
+		m_bytes -= m_entries.back().bytes;
+		m_index.erase(m_entries.back().key);
+		m_entries.pop_back();
+		m_evictions++;
+	}
+}
+
+/*static*/ std::shared_ptr<const WaveTableCache::Tables> WaveTableCache::generate(const WaveForm& waveForm)
+{
+	if(!waveForm.isBandLimited()) {
+		auto tables = std::make_shared<Tables>(1);
+		auto samples = tables->getLevel(0);
+		waveForm.generate(samples, TableSize, 1);
+		samples[TableSize] = samples[0];
+		return tables;
+	}
+
+	std::vector<std::complex<double>> spectrum(SourceSize);
+	{
+		std::unique_ptr<float[]> source(new float[SourceSize]);
+		waveForm.generate(source.get(), SourceSize, 1);
+		std::copy_n(source.get(), SourceSize, spectrum.begin());
+	}
+	fft(spectrum.data(), SourceSize, -1);
+
+	// Inverse transform of TableSize samples from harmonics of the spectrum of SourceSize samples.
+	auto tables = std::make_shared<Tables>(Levels);
+	std::vector<std::complex<double>> level(TableSize);
+	for(int l = 0; l < Levels; l++) {
+		std::fill(level.begin(), level.end(), 0.0);
+		level[0] = spectrum[0] / (double)SourceSize;
+		for(size_t h = 1; h <= getHarmonics(l); h++) {
+			level[h] = spectrum[h] / (double)SourceSize;
+			level[TableSize - h] = spectrum[SourceSize - h] / (double)SourceSize;
+		}
+		fft(level.data(), TableSize, 1);
+
+		auto samples = tables->getLevel(l);
+		for(size_t n = 0; n < TableSize; n++) {
+			samples[n] = (float)level[n].real();
+		}
+		samples[TableSize] = samples[0];
+	}
+	return tables;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "PcmData.h"
+
+#include <memory>
+#include <vector>
+#include <list>
+#include <map>
+#include <tuple>
+
+class WaveForm;
+
+/*
+ * WaveTableCache class
+ *
+ * Process-wide cache of wave tables shared by oscillators of all IPcmData objects.
+ * Entry of a band-limited wave form(WaveForm::isBandLimited()) holds mip levels of the wave form, that are octave-spaced:
+ * Level l contains harmonics up to getHarmonics(l) = (TableSize / 2) >> l, except for Nyquist frequency of the table.
+ * getLevel() selects the level whose highest harmonic does not exceed Nyquist frequency for the key at the sample rate.
+ *
+ * Levels are made from spectrum of the master of SourceSize samples generated by WaveForm,
+ * that is calculated by FFT once for all levels and truncated to the harmonics of each level.
+ * Content of a level depends on the number of harmonics only, so that the sample rate and the key band
+ * are resolved to the level, and the float master is shared by all sample data types.
+ * Entry of other wave forms holds 1 table generated by WaveForm, that is used for any key.
+ *
+ * Cycle data of PcmData class is generated from 1 channel of float master that contains whole cycles in exact frames.
+ * The master depends on the frame and cycle counts, that resolve the key and the sample rate, but not on the sample data type.
+ * So the master is cached with the frame and cycle counts, and is shared by IPcmData objects of any sample data type.
+ * Each IPcmData object converts the master to it's samples, because channels are rotated by the phase and samples are tiled for the object.
+ *
+ * Tables are read-only and handed out by std::shared_ptr, so that a table evicted from the cache
+ * is alive while IPcmData objects use it.
+ * Entries are evicted in least recently used order when total size exceeds the size bound.
+ */
+class WaveTableCache : DoNotCopy
+{
+public:
+	// Sample count of a level = 2^TableBits.
+	static const int TableBits = 11;
+	static const size_t TableSize = 1 << TableBits;
+	// Number of mip levels. The last level contains the fundamental only.
+	static const int Levels = TableBits;
+	// Sample count of the master to calculate spectrum of the wave form.
+	// Harmonics above SourceSize / 2 that alias into the levels are less than -80dB for square wave.
+	static const size_t SourceSize = TableSize * 8;
+	static const size_t DefaultMaxBytes = 16 * 1024 * 1024;
+
+	// Mip levels of a wave form, or 1 table of the wave form that is not band-limited.
+	class Tables : DoNotCopy
+	{
+	public:
+		Tables(int levels) : m_levels(levels), m_samples(new float[levels * (TableSize + 1)]) {}
+
+		// Returns TableSize + 1 samples of the level, or the last level if the level does not exist.
+		// Last sample is same as the first one to interpolate between the last sample and the first.
+		const float* getLevel(int level) const { return &m_samples[min(level, m_levels - 1) * (TableSize + 1)]; }
+		float* getLevel(int level) { return &m_samples[min(level, m_levels - 1) * (TableSize + 1)]; }
+
+		int getLevels() const { return m_levels; }
+		size_t getBytes() const { return m_levels * (TableSize + 1) * sizeof(float); }
+
+	protected:
+		const int m_levels;
+		std::unique_ptr<float[]> m_samples;
+	};
+
+	// 1 channel of float master generated by WaveForm.
+	using Master = std::vector<float>;
+
+	struct Statistics
+	{
+		size_t hits;
+		size_t misses;
+		size_t evictions;
+		size_t entries;
+		// Size of tables held by the cache.
+		size_t bytes;
+		size_t maxBytes;
+	};
+
+	// Returns the instance shared by the process.
+	static WaveTableCache& getInstance();
+
+	// Returns number of harmonics contained by the level.
+	static size_t getHarmonics(int level);
+	// Returns the lowest level whose harmonics do not exceed Nyquist frequency for the key.
+	// The last level is used for the key whose 2nd harmonic exceeds Nyquist frequency.
+	static int getLevel(float key, DWORD samplesPerSec);
+
+	// Returns tables of the wave form, generating them if they are not cached.
+	// The wave form is identified by WaveForm::getWaveFormType() and WaveForm::getParameter().
+	std::shared_ptr<const Tables> getTables(const WaveForm& waveForm);
+	// Returns master that contains cycles in frames, generating it by WaveForm::generate() if it is not cached.
+	// The wave form is identified as getTables(), and the frame and cycle counts are part of the key.
+	std::shared_ptr<const Master> getMaster(const WaveForm& waveForm, size_t frames, size_t cycles);
+
+	Statistics getStatistics() const;
+	// Sets the size bound, evicting least recently used entries that exceed it.
+	void setMaxBytes(size_t maxBytes);
+	// Evicts all entries and resets statistics.
+	void clear();
+
+protected:
+	WaveTableCache() : m_bytes(0), m_maxBytes(DefaultMaxBytes), m_hits(0), m_misses(0), m_evictions(0) {}
+
+	// Wave form type, parameter of the wave form, and frame and cycle counts of the master(0 for tables).
+	using Key = std::tuple<IPcmData::WaveFormType, double, size_t, size_t>;
+	// Entry holds either tables or master.
+	struct Entry
+	{
+		Key key;
+		std::shared_ptr<const Tables> tables;
+		std::shared_ptr<const Master> master;
+		size_t bytes;
+	};
+
+	// Entries in most recently used order, and index of them.
+	std::list<Entry> m_entries;
+	std::map<Key, std::list<Entry>::iterator> m_index;
+	size_t m_bytes;
+	size_t m_maxBytes;
+	size_t m_hits;
+	size_t m_misses;
+	size_t m_evictions;
+	mutable CriticalSection::Object m_lock;
+
+	// Returns the entry of the key moved to the front as most recently used, or nullptr if it is not cached.
+	// Counts a hit or a miss. Call in m_lock.
+	const Entry* find(const Key& key);
+	// Adds the entry to the front and evicts entries that exceed the size bound. Call in m_lock.
+	void add(Entry&& entry);
+	// Evicts least recently used entries until total size fits in the bound.
+	void evict();
+	// Generates mip levels from spectrum of the band-limited wave form, or 1 table of other wave form.
+	static std::shared_ptr<const Tables> generate(const WaveForm& waveForm);
+};
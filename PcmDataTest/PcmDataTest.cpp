@@ -20,7 +20,19 @@ int main(int argc, char* argv[])
 	bool int32Value = false;
 
 	auto& sampleDataTypeProperties(PcmDataEnumerator::getSampleDatatypeProperties());
-	auto& waveFormProperties(PcmDataEnumerator::getWaveFormProperties());
+	// Digits of DTMF and MF and noise have no 1-cycle data to be shown, and MLS is too long.
+	std::vector<PcmDataEnumerator::WaveFormProperty> waveFormProperties;
+	for(auto& wp : PcmDataEnumerator::getWaveFormProperties()) {
+		switch(wp.parameter) {
+		case PcmDataEnumerator::FactoryParameter::Digit:
+		case PcmDataEnumerator::FactoryParameter::Seed:
+		case PcmDataEnumerator::FactoryParameter::Order:
+			break;
+		default:
+			waveFormProperties.push_back(wp);
+			break;
+		}
+	}
 
 	float fVal;
 	int iVal;
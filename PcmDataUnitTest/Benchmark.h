@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+// Helper to measure speed of the code in benchmark tests.
+//   Benchmark tests print the results to stdout and do not fail by the results,
+//   because the results depend on the machine on which the tests run.
+//   Benchmark tests are disabled(DISABLED_ prefix) not to slow down the unit tests.
+//   Run them with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+class Benchmark
+{
+public:
+	// Calls func repeatedly at least for minDuration(mSec),
+	// and returns average time of one call in micro seconds.
+	template<typename F>
+	static double measure(F func, int minDuration = 20)
+	{
+		using clock = std::chrono::steady_clock;
+
+		// Warm up cache and branch predictor.
+		func();
+
+		size_t count = 0;
+		clock::duration elapsed;
+		auto start = clock::now();
+		do {
+			func();
+			count++;
+			elapsed = clock::now() - start;
+		} while(elapsed < std::chrono::milliseconds(minDuration));
+
+		return std::chrono::duration<double, std::micro>(elapsed).count() / count;
+	}
+
+	// Returns throughput in MByte/Sec for the size(byte) processed in the time(micro seconds).
+	static double mbps(size_t size, double time) { return size / time; }
+};
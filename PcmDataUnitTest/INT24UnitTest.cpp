@@ -1,9 +1,13 @@
 #include <PcmData/INT24.h>
+#include <PcmData/SimdKernel.h>
+#include "Benchmark.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <tuple>
+#include <vector>
+#include <functional>
 
 using namespace ::testing;
 
@@ -135,3 +139,196 @@ INSTANTIATE_TEST_SUITE_P(_, INT24BinaryOperatorUnitTest, Values(
 	std::make_tuple(0, 0x1234),
 	std::make_tuple(0x1234, 0)
 ));
+
+class Int24KernelUnitTest : public Test
+{
+public:
+	void SetUp() override { m_instructionSet = SimdKernel::getInstructionSet(); }
+	void TearDown() override { SimdKernel::setInstructionSet(m_instructionSet); }
+
+	// Instruction sets supported by the CPU on which the test runs.
+	static std::vector<SimdKernel::InstructionSet> getInstructionSets() {
+		std::vector<SimdKernel::InstructionSet> ret;
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::SSSE3, SimdKernel::InstructionSet::AVX2 }) {
+			if(is <= SimdKernel::getSupportedInstructionSet()) { ret.push_back(is); }
+		}
+		return ret;
+	}
+
+	// All values of INT24.
+	static const size_t AllValues = 0x1000000;
+	static const float FloatScale;
+
+protected:
+	SimdKernel::InstructionSet m_instructionSet;
+};
+
+// Full scale of float sample.
+const float Int24KernelUnitTest::FloatScale = 1.0f / 8388608.0f;
+
+// Every INT24 value should be packed and unpacked without change by all instruction sets,
+// and packed bytes should be same as INT24 class.
+TEST_F(Int24KernelUnitTest, exhaustiveInt32)
+{
+	std::vector<INT32> values(AllValues);
+	for(size_t i = 0; i < AllValues; i++) { values[i] = (INT32)i + INT24::MinValue; }
+	std::vector<INT24> expected(AllValues);
+	for(size_t i = 0; i < AllValues; i++) { expected[i] = INT24(values[i]); }
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		auto name = SimdKernel::getInstructionSetName(is);
+
+		std::vector<INT24> array(AllValues);
+		SimdKernel::packInt24(array.data(), values.data(), AllValues);
+		ASSERT_EQ(0, memcmp(expected.data(), array.data(), AllValues * sizeof(INT24))) << name;
+
+		std::vector<INT32> unpacked(AllValues);
+		SimdKernel::unpackInt24(unpacked.data(), array.data(), AllValues);
+		ASSERT_EQ(values, unpacked) << name;
+	}
+}
+
+// Every INT24 value should be converted to float and back without change by all instruction sets.
+TEST_F(Int24KernelUnitTest, exhaustiveFloat)
+{
+	std::vector<INT24> original(AllValues);
+	for(size_t i = 0; i < AllValues; i++) { original[i] = INT24((INT32)i + INT24::MinValue); }
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		auto name = SimdKernel::getInstructionSetName(is);
+
+		std::vector<float> values(AllValues);
+		SimdKernel::unpackInt24(values.data(), original.data(), AllValues, FloatScale);
+		for(size_t i = 0; i < AllValues; i++) {
+			ASSERT_EQ((float)original[i] * FloatScale, values[i]) << name << ": " << i;
+		}
+		ASSERT_EQ(-1.0f, values.front()) << name;
+
+		std::vector<INT24> array(AllValues);
+		SimdKernel::convert(array.data(), values.data(), AllValues, 0.0f, 1.0f / FloatScale);
+		ASSERT_EQ(0, memcmp(original.data(), array.data(), AllValues * sizeof(INT24))) << name;
+	}
+}
+
+// Every count and offset should be converted without touching samples out of the range,
+// to check the remainder of vectorized loop.
+TEST_F(Int24KernelUnitTest, count)
+{
+	static const size_t MaxCount = 40;
+	static const BYTE Guard = 0xa5;
+
+	std::vector<INT32> values(MaxCount);
+	for(size_t i = 0; i < MaxCount; i++) { values[i] = (INT32)((i * 0x12345) ^ ((i & 1) ? 0xff800000 : 0)); }
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		auto name = SimdKernel::getInstructionSetName(is);
+
+		for(size_t offset = 0; offset < 2; offset++) {
+			for(size_t count = 0; count <= MaxCount; count++) {
+				std::vector<INT24> array(MaxCount + 2);
+				memset((void*)array.data(), Guard, array.size() * sizeof(INT24));
+				SimdKernel::packInt24(&array[offset], values.data(), count);
+				for(size_t i = 0; i < array.size(); i++) {
+					if(offset <= i && i < offset + count) {
+						ASSERT_EQ((INT32)INT24(values[i - offset]), (INT32)array[i]) << name << ": count=" << count << ", offset=" << offset;
+					} else {
+						auto p = (const BYTE*)&array[i];
+						ASSERT_TRUE((p[0] == Guard) && (p[1] == Guard) && (p[2] == Guard)) << name << ": count=" << count << ", offset=" << offset;
+					}
+				}
+
+				std::vector<INT32> unpacked(MaxCount + 1, -1);
+				SimdKernel::unpackInt24(unpacked.data(), &array[offset], count);
+				for(size_t i = 0; i < count; i++) { ASSERT_EQ(values[i], unpacked[i]) << name << ": count=" << count; }
+				ASSERT_EQ(-1, unpacked[count]) << name << ": count=" << count;
+			}
+		}
+	}
+}
+
+// Values out of the range of INT24 should be saturated.
+TEST_F(Int24KernelUnitTest, saturation)
+{
+	static const INT32 values[] = {
+		INT32_MIN, -0x800001, INT24::MinValue, INT24::MaxValue, 0x800000, INT32_MAX,
+	};
+	static const INT32 expected[] = {
+		INT24::MinValue, INT24::MinValue, INT24::MinValue, INT24::MaxValue, INT24::MaxValue, INT24::MaxValue,
+	};
+	static const float floatValues[] = { -2.0f, -1.5f, -1.0f, 8388607.0f / 8388608.0f, 1.0f, 2.0f };
+
+	// Repeat values to fill vectors of all instruction sets.
+	static const size_t Count = ARRAYSIZE(values) * 8;
+	std::vector<INT32> src(Count);
+	std::vector<float> floatSrc(Count);
+	for(size_t i = 0; i < Count; i++) {
+		src[i] = values[i % ARRAYSIZE(values)];
+		floatSrc[i] = floatValues[i % ARRAYSIZE(values)];
+	}
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		auto name = SimdKernel::getInstructionSetName(is);
+
+		std::vector<INT24> array(Count);
+		SimdKernel::packInt24(array.data(), src.data(), Count);
+		for(size_t i = 0; i < Count; i++) {
+			ASSERT_EQ(expected[i % ARRAYSIZE(values)], (INT32)array[i]) << name << ": " << i;
+		}
+
+		SimdKernel::convert(array.data(), floatSrc.data(), Count, 0.0f, 1.0f / FloatScale);
+		for(size_t i = 0; i < Count; i++) {
+			ASSERT_EQ(expected[i % ARRAYSIZE(values)], (INT32)array[i]) << name << ": " << i;
+		}
+	}
+}
+
+// Prints throughput of bulk conversion by each instruction set,
+// compared with conversion by INT24 class for each sample.
+TEST(INT24Benchmark, DISABLED_convert)
+{
+	static const size_t samples = 0x10000;
+	std::vector<INT24> array(samples);
+	std::vector<INT32> values(samples);
+	std::vector<float> floatValues(samples);
+	for(size_t i = 0; i < samples; i++) {
+		values[i] = (INT32)(i * 0x123) - 0x400000;
+		floatValues[i] = (float)values[i] / 8388608.0f;
+	}
+
+	std::cout << "Conversion,INT24 class";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::SSSE3, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is);
+	}
+	std::cout << "(MSamples/Sec)\n";
+
+	// Measures bulk conversion by each instruction set.
+	auto instructionSet = SimdKernel::getInstructionSet();
+	auto measure = [&](const char* name, std::function<void()> perSample, std::function<void()> bulk) {
+		std::cout << name << "," << (samples / Benchmark::measure(perSample));
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::SSSE3, SimdKernel::InstructionSet::AVX2 }) {
+			std::cout << ",";
+			if(SimdKernel::getSupportedInstructionSet() < is) { continue; }
+			SimdKernel::setInstructionSet(is);
+			std::cout << (samples / Benchmark::measure(bulk));
+		}
+		std::cout << std::endl;
+	};
+
+	measure("INT32 to INT24",
+		[&]() { for(size_t i = 0; i < samples; i++) { array[i] = INT24(values[i]); } },
+		[&]() { SimdKernel::packInt24(array.data(), values.data(), samples); });
+	measure("INT24 to INT32",
+		[&]() { for(size_t i = 0; i < samples; i++) { values[i] = array[i]; } },
+		[&]() { SimdKernel::unpackInt24(values.data(), array.data(), samples); });
+	measure("float to INT24",
+		[&]() { for(size_t i = 0; i < samples; i++) { array[i] = INT24((double)floatValues[i] * 8388608.0); } },
+		[&]() { SimdKernel::convert(array.data(), floatValues.data(), samples, 0.0f, 8388608.0f); });
+	measure("INT24 to float",
+		[&]() { for(size_t i = 0; i < samples; i++) { floatValues[i] = (float)array[i] / 8388608.0f; } },
+		[&]() { SimdKernel::unpackInt24(floatValues.data(), array.data(), samples, 1.0f / 8388608.0f); });
+	SimdKernel::setInstructionSet(instructionSet);
+}
@@ -0,0 +1,795 @@
+#include <PcmData/PcmData.h>
+#include <PcmData/SimdKernel.h>
+#include <PcmData/INT24.h>
+#include <PcmData/MaximumLengthSequence.h>
+#include <PcmData/WaveTableCache.h>
+#include "Benchmark.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <math.h>
+#include <atlbase.h>
+
+using namespace ::testing;
+
+namespace
+{
+
+// Sample data of size byte.
+template<size_t size>
+struct Sample { BYTE value[size]; };
+
+// Copies samples one by one checking the end of the cycle for every sample,
+// as PcmData<T>::copyTo() did before block copy was introduced.
+template<size_t size>
+void copyPerSample(void* destBuffer, size_t destSize, const void* cycleData, size_t samplesPerCycle, size_t& position)
+{
+	auto cycle = (const Sample<size>*)cycleData;
+	for(size_t destPosition = 0; destPosition < destSize; destPosition += size) {
+		*(Sample<size>*)&((BYTE*)destBuffer)[destPosition] = cycle[position++];
+		if(samplesPerCycle <= position) { position = 0; }
+	}
+}
+
+using CopyPerSample = void (*)(void*, size_t, const void*, size_t, size_t&);
+
+CopyPerSample getCopyPerSample(WORD bitsPerSample)
+{
+	switch(bitsPerSample) {
+	case 8: return copyPerSample<1>;
+	case 16: return copyPerSample<2>;
+	case 24: return copyPerSample<3>;
+	case 32: return copyPerSample<4>;
+	case 64: return copyPerSample<8>;
+	default: return nullptr;
+	}
+}
+
+// Generates sine wave calling sin() for each sample,
+// as SineWaveGenerator<T>::generate() did before SimdKernel was introduced.
+template<typename T>
+void sinePerSample(T* cycleData, size_t samplesPerCycle, WORD channels, float zero, float height)
+{
+	static const float pi = 3.141592f;
+	for(size_t pos = 0; pos < samplesPerCycle; pos += channels) {
+		auto radian = 2 * pi * pos / samplesPerCycle;
+		cycleData[pos] = (T)((sin(radian) * height) + zero);
+	}
+}
+
+// Copies first channel of interleaved master to other channels shifting phase by shift frames for each channel,
+// as PcmData<T>::generate() did before the master became planar.
+void replicatePerSample(float* master, size_t samplesPerCycle, WORD channels, size_t shift)
+{
+	for(WORD channel = 1; channel < channels; channel++) {
+		auto posSrc = shift * channels * channel;
+		for(size_t pos = 0; pos < samplesPerCycle; pos += channels) {
+			master[pos + channel] = master[posSrc % samplesPerCycle];
+			posSrc += channels;
+		}
+	}
+}
+
+// Measures sine kernel and conversion from the float master for all instruction sets supported by the CPU.
+template<typename T>
+void benchmarkSine(const char* name, float zero, float height)
+{
+	static const WORD channels = 2;
+
+	for(size_t frames : { 441, 4410, 48000, 192000 }) {
+		std::unique_ptr<T[]> data(new T[frames * channels]);
+		std::unique_ptr<float[]> master(new float[frames * channels]());
+		auto perSampleTime = Benchmark::measure([&]() { sinePerSample(data.get(), frames * channels, channels, zero, height); });
+		std::cout << name << "," << frames << ",sin()," << perSampleTime << "," << (frames / perSampleTime) << ",1\n";
+
+		auto instructionSet = SimdKernel::getInstructionSet();
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { continue; }
+			SimdKernel::setInstructionSet(is);
+			auto time = Benchmark::measure([&]() {
+				SimdKernel::sine(master.get(), channels, frames, 1, 0, 1.0f);
+				SimdKernel::convert(data.get(), master.get(), frames * channels, zero, height);
+			});
+			std::cout << name << "," << frames << "," << SimdKernel::getInstructionSetName(is)
+				<< "," << time << "," << (frames / time) << "," << (perSampleTime / time) << "\n";
+		}
+		SimdKernel::setInstructionSet(instructionSet);
+	}
+}
+
+}
+
+// Compares IPcmData::copyTo() with copying sample by sample
+// for all SampleDataType and typical channel counts.
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_copyTo)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const float key = 440;
+	static const size_t duration = 200;
+
+	std::cout << "SampleDataType,Channels,Buffer size,Per sample(uSec),Block copy(uSec),Speedup,Block copy(MB/Sec)\n";
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		for(WORD channels : { 1, 2, 6, 8 }) {
+			auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type));
+			ASSERT_THAT(pcmData, NotNull());
+			pcmData->generate(key, 1.0f, 0.5f);
+
+			// Retrieve 1-cycle data to be copied by copyPerSample().
+			auto cycleSize = pcmData->getSampleBufferSize(0);
+			auto cycleData = std::make_unique<BYTE[]>(cycleSize);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(cycleData.get(), cycleSize));
+
+			auto copy = getCopyPerSample(sp.bitsPerSample);
+			ASSERT_THAT(copy, NotNull());
+			auto bufferSize = pcmData->getSampleBufferSize(duration);
+			auto expected = std::make_unique<BYTE[]>(bufferSize);
+			auto actual = std::make_unique<BYTE[]>(bufferSize);
+
+			// Both should copy same samples.
+			size_t position = 0;
+			copy(expected.get(), bufferSize, cycleData.get(), pcmData->getSamplesPerCycle(), position);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(actual.get(), bufferSize));
+			ASSERT_EQ(memcmp(expected.get(), actual.get(), bufferSize), 0) << sp.name << ", " << channels << " channels";
+
+			auto perSample = Benchmark::measure([&]() {
+				copy(expected.get(), bufferSize, cycleData.get(), pcmData->getSamplesPerCycle(), position);
+			});
+			auto blockCopy = Benchmark::measure([&]() { pcmData->copyTo(actual.get(), bufferSize); });
+
+			std::cout << sp.name << "," << channels << "," << bufferSize
+				<< "," << perSample << "," << blockCopy << "," << (perSample / blockCopy)
+				<< "," << Benchmark::mbps(bufferSize, blockCopy) << std::endl;
+		}
+	}
+}
+
+// Compares copyTo() of fixed block size with and without tiled cycle data.
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_tiledCopyTo)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const float key = 440;
+	static const size_t duration = 200;
+
+	std::cout << "SampleDataType,Channels,Buffer size,Cycle data size,Tiled cycle data size,Not tiled(uSec),Tiled(uSec),Speedup\n";
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		for(WORD channels : { 1, 2, 6, 8 }) {
+			std::shared_ptr<IPcmData> pcmData[2];
+			for(auto& p : pcmData) {
+				p = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type));
+				ASSERT_THAT(p, NotNull());
+			}
+			auto& notTiled = pcmData[0];
+			auto& tiled = pcmData[1];
+			auto bufferSize = tiled->getSampleBufferSize(duration);
+			ASSERT_HRESULT_SUCCEEDED(tiled->setBlockSize(bufferSize, bufferSize * 2));
+			for(auto& p : pcmData) { p->generate(key, 1.0f, 0.5f); }
+			ASSERT_TRUE(tiled->isTiled());
+
+			auto buffer = std::make_unique<BYTE[]>(bufferSize);
+			auto notTiledTime = Benchmark::measure([&]() { notTiled->copyTo(buffer.get(), bufferSize); });
+			auto tiledTime = Benchmark::measure([&]() { tiled->copyTo(buffer.get(), bufferSize); });
+
+			std::cout << sp.name << "," << channels << "," << bufferSize
+				<< "," << notTiled->getCycleDataSize() << "," << tiled->getCycleDataSize()
+				<< "," << notTiledTime << "," << tiledTime << "," << (notTiledTime / tiledTime) << std::endl;
+		}
+	}
+}
+
+// Compares copyTo() of 1-cycle data and synthesizing by oscillator, for all instruction sets supported by the CPU.
+// Speedup is the ratio of copying sample by sample to the oscillator.
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_oscillator)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const float key = 440;
+	static const size_t duration = 200;
+
+	std::cout << "SampleDataType,Channels,Buffer size,Per sample(uSec),Cycle table(uSec)";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << "(uSec)," << SimdKernel::getInstructionSetName(is) << "(Speedup)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		for(WORD channels : { 1, 2, 6, 8 }) {
+			auto cycleTable = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type));
+			auto oscillator = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), IPcmData::SynthesisMode::Oscillator);
+			ASSERT_THAT(cycleTable, NotNull());
+			ASSERT_THAT(oscillator, NotNull());
+			cycleTable->generate(key, 1.0f, 0.5f);
+			oscillator->generate(key, 1.0f, 0.5f);
+
+			auto cycleSize = cycleTable->getSampleBufferSize(0);
+			auto cycleData = std::make_unique<BYTE[]>(cycleSize);
+			ASSERT_HRESULT_SUCCEEDED(cycleTable->copyTo(cycleData.get(), cycleSize));
+			auto copy = getCopyPerSample(sp.bitsPerSample);
+			ASSERT_THAT(copy, NotNull());
+
+			auto bufferSize = cycleTable->getSampleBufferSize(duration);
+			auto buffer = std::make_unique<BYTE[]>(bufferSize);
+			size_t position = 0;
+			auto perSampleTime = Benchmark::measure([&]() {
+				copy(buffer.get(), bufferSize, cycleData.get(), cycleTable->getSamplesPerCycle(), position);
+			});
+			auto cycleTableTime = Benchmark::measure([&]() { cycleTable->copyTo(buffer.get(), bufferSize); });
+			std::cout << sp.name << "," << channels << "," << bufferSize << "," << perSampleTime << "," << cycleTableTime;
+
+			for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+				if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ",,"; continue; }
+				SimdKernel::setInstructionSet(is);
+				auto time = Benchmark::measure([&]() { oscillator->copyTo(buffer.get(), bufferSize); });
+				std::cout << "," << time << "," << (perSampleTime / time);
+			}
+			std::cout << std::endl;
+		}
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Compares sine kernel followed by conversion to T with calling sin() for each sample.
+// Low key at high sample rate requires large cycle data.
+TEST(PcmDataBenchmark, DISABLED_sineKernel)
+{
+	std::cout << "SampleDataType,Frames,Implementation,Time(uSec),MSamples/Sec,Speedup\n";
+	benchmarkSine<UINT8>("PCM 8bit", 0x80, 0x40);
+	benchmarkSine<INT16>("PCM 16bit", 0, 0x6000);
+	benchmarkSine<INT24>("PCM 24bit", 0, 0x600000);
+	benchmarkSine<float>("IEEE float 32bit", 0, 0.8f);
+	std::cout << std::flush;
+}
+
+// Measures square and triangle kernels for all instruction sets supported by the CPU.
+TEST(PcmDataBenchmark, DISABLED_squareTriangleKernel)
+{
+	static const WORD channels = 2;
+	static const size_t frames = 48000;
+
+	std::unique_ptr<float[]> data(new float[frames * channels]);
+	auto instructionSet = SimdKernel::getInstructionSet();
+	std::cout << "Kernel,Implementation,Time(uSec),MSamples/Sec\n";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		if(SimdKernel::getSupportedInstructionSet() < is) { continue; }
+		SimdKernel::setInstructionSet(is);
+		auto squareTime = Benchmark::measure([&]() { SimdKernel::square(data.get(), channels, frames, 1, frames / 4, 1.0f, -1.0f); });
+		auto triangleTime = Benchmark::measure([&]() { SimdKernel::triangle(data.get(), channels, frames, 1, 0.25f, 0, 1.0f, 1.0f); });
+		std::cout << "Square," << SimdKernel::getInstructionSetName(is) << "," << squareTime << "," << (frames / squareTime) << "\n";
+		std::cout << "Triangle," << SimdKernel::getInstructionSetName(is) << "," << triangleTime << "," << (frames / triangleTime) << "\n";
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+	std::cout << std::flush;
+}
+
+// Compares generate() of band-limited square and triangle waves with naive ones.
+// Exact period of high key has many cycles, so that PolyBLEP corrects many edges.
+TEST(PcmDataBenchmark, DISABLED_bandLimited)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+
+	std::cout << "WaveForm,Key,Frames,Cycles,Time(uSec),MSamples/Sec\n";
+	for(auto type : { IPcmData::WaveFormType::SquareWave, IPcmData::WaveFormType::BandLimitedSquareWave,
+						IPcmData::WaveFormType::TriangleWave, IPcmData::WaveFormType::BandLimitedTriangleWave }) {
+		auto& wp = PcmDataEnumerator::getWaveFormProperty(type);
+		for(float key : { 440.0f, 3520.5f }) {
+			auto pcmData = createPcmData(samplesPerSec, channels, wp.factory(IPcmData::SampleDataType::PCM_16bits, 0.3f));
+			pcmData->setExactPeriod();
+			auto time = Benchmark::measure([&]() { pcmData->generate(key); });
+			auto frames = pcmData->getSamplesPerCycle() / channels;
+			std::cout << wp.name << "," << key << "," << frames << "," << pcmData->getCycles() << "," << time << "," << (frames / time) << "\n";
+		}
+	}
+	std::cout << std::flush;
+}
+
+// Measures latency of copyTo() while another thread calls generate() in a tight loop,
+// like the audio worker thread and slider moves of CMFToneGeneratorDlg.
+// Each buffer should be copied from one cycle data, that is generated with one level.
+// Lock: generate() and copyTo() are serialized by a mutex, as copyTo() locked cycle data before it was published without lock.
+// Lock-free: copyTo() reads published cycle data without lock.
+TEST(PcmDataBenchmark, DISABLED_concurrentGenerate)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t duration = 10;
+	static const int readers = 3;
+	static const int testDuration = 500;
+	static const float levels[] = { 0.5f, 1.0f };
+
+	std::cout << "Method,generate() count,copyTo() count,p50(uSec),p99(uSec),p99.9(uSec),max(uSec)\n";
+	for(auto locked : { true, false }) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSquareWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+		ASSERT_THAT(pcmData, NotNull());
+		auto bufferSize = pcmData->getSampleBufferSize(duration);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->setBlockSize(bufferSize));
+		pcmData->generate(440, levels[0]);
+
+		std::mutex mutex;
+		std::atomic<bool> stop(false);
+		std::atomic<size_t> generateCount(0);
+		std::thread writer([&]() {
+			for(size_t i = 0; !stop; i++) {
+				std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+				if(locked) { lock.lock(); }
+				pcmData->generate((float)(440 + (i % 10)), levels[i % 2]);
+				generateCount++;
+			}
+		});
+
+		std::vector<std::vector<double>> latencies(readers);
+		std::atomic<size_t> inconsistentCount(0);
+		std::vector<std::thread> readerThreads;
+		for(int r = 0; r < readers; r++) {
+			readerThreads.emplace_back([&, r]() {
+				using clock = std::chrono::steady_clock;
+				auto buffer = std::make_unique<BYTE[]>(bufferSize);
+				auto samples = (const INT16*)buffer.get();
+				while(!stop) {
+					auto start = clock::now();
+					HRESULT hr;
+					{
+						std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+						if(locked) { lock.lock(); }
+						hr = pcmData->copyTo(buffer.get(), bufferSize);
+					}
+					latencies[r].push_back(std::chrono::duration<double, std::micro>(clock::now() - start).count());
+					if(FAILED(hr)) { inconsistentCount++; continue; }
+
+					// All samples should be +-(HighValue * level) of the same level.
+					auto high = abs(samples[0]);
+					for(size_t i = 1; i < bufferSize / sizeof(INT16); i++) {
+						if(abs(samples[i]) != high) {
+							inconsistentCount++;
+							break;
+						}
+					}
+				}
+			});
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(testDuration));
+		stop = true;
+		writer.join();
+		for(auto& t : readerThreads) { t.join(); }
+
+		std::vector<double> all;
+		for(auto& l : latencies) { all.insert(all.end(), l.begin(), l.end()); }
+		ASSERT_FALSE(all.empty());
+		std::sort(all.begin(), all.end());
+		auto percentile = [&all](double p) { return all[min((size_t)(all.size() * p), all.size() - 1)]; };
+		std::cout << (locked ? "Lock" : "Lock-free") << "," << generateCount << "," << all.size()
+			<< "," << percentile(0.5) << "," << percentile(0.99) << "," << percentile(0.999) << "," << all.back() << std::endl;
+
+		EXPECT_EQ(0, inconsistentCount) << (locked ? "Lock" : "Lock-free");
+	}
+}
+
+// Compares copyTo() in RetuneMode::Reset and RetuneMode::Continuous.
+// Steady: copyTo() without generate(), which should be as fast as Reset.
+// Retune: generate() and copyTo() of the buffer that starts with crossfade.
+TEST(PcmDataBenchmark, DISABLED_retune)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t duration = 10;
+
+	std::cout << "SampleDataType,Buffer size,Steady Reset(uSec),Steady Continuous(uSec),Ratio,Retune Reset(uSec),Retune Continuous(uSec),Ratio\n";
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		std::shared_ptr<IPcmData> pcmData[2];
+		for(auto& p : pcmData) {
+			p = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type));
+			ASSERT_THAT(p, NotNull());
+		}
+		auto& reset = pcmData[0];
+		auto& continuous = pcmData[1];
+		ASSERT_HRESULT_SUCCEEDED(continuous->setRetuneMode(IPcmData::RetuneMode::Continuous));
+		auto bufferSize = reset->getSampleBufferSize(duration);
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+		double steady[2], retune[2];
+		for(int i = 0; i < 2; i++) {
+			auto& p = pcmData[i];
+			p->generate(440);
+			steady[i] = Benchmark::measure([&]() { p->copyTo(buffer.get(), bufferSize); });
+			size_t count = 0;
+			retune[i] = Benchmark::measure([&]() {
+				p->generate((float)(440 + (count++ % 10)));
+				p->copyTo(buffer.get(), bufferSize);
+			});
+		}
+
+		std::cout << sp.name << "," << bufferSize
+			<< "," << steady[0] << "," << steady[1] << "," << (steady[1] / steady[0])
+			<< "," << retune[0] << "," << retune[1] << "," << (retune[1] / retune[0]) << std::endl;
+	}
+}
+
+// Measures copyTo() at full level(plain copy), at other level and with dither(conversion from the float master).
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_level)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t duration = 200;
+
+	std::cout << "SampleDataType,Buffer size,Full level(uSec),Level 0.5(uSec),Ratio,Dither(uSec),Ratio\n";
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type));
+		ASSERT_THAT(pcmData, NotNull());
+		auto bufferSize = pcmData->getSampleBufferSize(duration);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->setBlockSize(bufferSize));
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+		pcmData->generate(440, 1.0f);
+		auto fullLevelTime = Benchmark::measure([&]() { pcmData->copyTo(buffer.get(), bufferSize); });
+		pcmData->setLevel(0.5f, 0);
+		auto levelTime = Benchmark::measure([&]() { pcmData->copyTo(buffer.get(), bufferSize); });
+		pcmData->setLevel(1.0f, 0);
+		pcmData->setDither(IPcmData::DitherType::TPDF);
+		auto ditherTime = Benchmark::measure([&]() { pcmData->copyTo(buffer.get(), bufferSize); });
+		std::cout << sp.name << "," << bufferSize << "," << fullLevelTime
+			<< "," << levelTime << "," << (levelTime / fullLevelTime)
+			<< "," << ditherTime << "," << (ditherTime / fullLevelTime) << std::endl;
+	}
+}
+
+// Measures conversion from float master to each sample type, without and with dither,
+// for all instruction sets supported by the CPU.
+TEST(PcmDataBenchmark, DISABLED_convert)
+{
+	static const size_t samples = 48000 * 2;
+
+	std::vector<float> master(samples);
+	for(size_t i = 0; i < samples; i++) { master[i] = (float)sin((double)i * 0.01); }
+	auto buffer = std::make_unique<BYTE[]>(samples * sizeof(double));
+
+	// Measures kernel for T and prints MSamples/Sec.
+	auto measure = [&](auto* dest, float zero, float height, SimdKernel::Dither dither) {
+		auto time = Benchmark::measure([&]() { SimdKernel::convert(dest, master.data(), samples, zero, height, dither); });
+		std::cout << "," << (samples / time);
+	};
+
+	std::cout << "SampleDataType,Dither";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::SSSE3, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << "(MSamples/Sec)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		for(auto dither : { SimdKernel::Dither::None, SimdKernel::Dither::TPDF }) {
+			std::cout << sp.name << "," << ((dither == SimdKernel::Dither::None) ? "None" : "TPDF");
+			for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::SSSE3, SimdKernel::InstructionSet::AVX2 }) {
+				if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ","; continue; }
+				SimdKernel::setInstructionSet(is);
+				switch(sp.type) {
+				case IPcmData::SampleDataType::PCM_8bits:
+					measure((UINT8*)buffer.get(), 0x80, 0x40, dither);
+					break;
+				case IPcmData::SampleDataType::PCM_16bits:
+					measure((INT16*)buffer.get(), 0, 0x6000, dither);
+					break;
+				case IPcmData::SampleDataType::PCM_24bits:
+					measure((INT24*)buffer.get(), 0, 0x600000, dither);
+					break;
+				case IPcmData::SampleDataType::IEEE_Float:
+					measure((float*)buffer.get(), 0, 0.8f, dither);
+					break;
+				case IPcmData::SampleDataType::PCM_24bits_in_32:
+					measure((INT24in32*)buffer.get(), 0, 0x600000, dither);
+					break;
+				case IPcmData::SampleDataType::PCM_32bits:
+					measure((INT32*)buffer.get(), 0, 0x60000000, dither);
+					break;
+				case IPcmData::SampleDataType::IEEE_Double:
+					measure((double*)buffer.get(), 0, 0.8f, dither);
+					break;
+				}
+			}
+			std::cout << std::endl;
+		}
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures generate(), copyTo() and copyToPlanar() at level 0.5(conversion from the planar float master)
+// for channel counts from stereo to 64 channels.
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_planar)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const size_t duration = 200;
+
+	std::cout << "SampleDataType,Channels,Buffer size,generate(uSec),copyTo(uSec),copyToPlanar(uSec),Ratio\n";
+	for(auto type : { IPcmData::SampleDataType::PCM_16bits, IPcmData::SampleDataType::IEEE_Float }) {
+		for(WORD channels : { 2, 6, 8, 16, 64 }) {
+			auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(type));
+			ASSERT_THAT(pcmData, NotNull());
+			auto generateTime = Benchmark::measure([&]() { pcmData->generate(440, 0.5f, 0.3f); });
+
+			auto bufferSize = pcmData->getSampleBufferSize(duration);
+			auto frames = bufferSize / pcmData->getBlockAlign();
+			auto buffer = std::make_unique<BYTE[]>(bufferSize);
+			std::vector<void*> channelBuffers;
+			for(WORD channel = 0; channel < channels; channel++) {
+				channelBuffers.push_back(&buffer[channel * (bufferSize / channels)]);
+			}
+			auto copyToTime = Benchmark::measure([&]() { pcmData->copyTo(buffer.get(), bufferSize); });
+			auto planarTime = Benchmark::measure([&]() { pcmData->copyToPlanar(channelBuffers.data(), frames); });
+			std::cout << PcmDataEnumerator::getSampleDataTypeProperty(type).name << "," << channels << "," << bufferSize
+				<< "," << generateTime << "," << copyToTime << "," << planarTime << "," << (planarTime / copyToTime) << std::endl;
+		}
+	}
+}
+
+// Compares phase shift replication by the modulo loop with generate() that rotates planar channels
+// and interleaves them, for all instruction sets supported by the CPU.
+TEST(PcmDataBenchmark, DISABLED_phaseShift)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const float key = 10;
+
+	std::cout << "Channels,Frames,Modulo loop(uSec)";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << " generate(uSec)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(WORD channels : { 1, 2, 4, 6, 8, 16 }) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+		ASSERT_THAT(pcmData, NotNull());
+		pcmData->generate(key, 1.0f, 0.3f);
+		auto frames = pcmData->getSamplesPerCycle() / channels;
+
+		// Modulo loop replicates channels of master generated by sine kernel.
+		std::vector<float> master(frames * channels);
+		std::vector<INT16> samples(frames * channels);
+		auto moduloTime = Benchmark::measure([&]() {
+			SimdKernel::sine(master.data(), channels, frames, 1, 0, 1.0f);
+			replicatePerSample(master.data(), frames * channels, channels, frames / 3);
+			SimdKernel::convert(samples.data(), master.data(), frames * channels, 0, 0x6000);
+		});
+		std::cout << channels << "," << frames << "," << moduloTime;
+
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ","; continue; }
+			SimdKernel::setInstructionSet(is);
+			std::cout << "," << Benchmark::measure([&]() { pcmData->generate(key, 1.0f, 0.3f); });
+		}
+		std::cout << std::endl;
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures oscillators that oscillator bank sums in real time per core at 48kHz, for all instruction sets supported by the CPU.
+// Oscillators(uSec) is time to sum OscillatorPcmData objects of each tone, for reference.
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_oscillatorBank)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t duration = 200;
+
+	std::cout << "Oscillators,Oscillators(uSec)";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << "(uSec)," << SimdKernel::getInstructionSetName(is) << "(Oscillators/Core)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(size_t oscillators : { 8, 32, 128, 512, 1024 }) {
+		std::vector<IPcmData::ToneParameter> tones;
+		for(size_t i = 0; i < oscillators; i++) {
+			auto waveFormType = (i % 2) ? IPcmData::WaveFormType::TriangleWave : IPcmData::WaveFormType::SineWave;
+			tones.push_back({ 50.0f + (i * 17.3f), 1.0f / oscillators, (float)i / oscillators, waveFormType, 0.5f });
+		}
+		auto bank = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), IPcmData::SynthesisMode::OscillatorBank);
+		ASSERT_THAT(bank, NotNull());
+		ASSERT_HRESULT_SUCCEEDED(bank->generateTones(tones.data(), tones.size()));
+		auto bufferSize = bank->getSampleBufferSize(duration);
+		auto frames = bufferSize / bank->getBlockAlign();
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+		// Each tone is synthesized by OscillatorPcmData of float sample and summed.
+		std::vector<std::shared_ptr<IPcmData>> references;
+		for(auto& tone : tones) {
+			auto reference = createPcmData(samplesPerSec, 1, createSineWaveGenerator(IPcmData::SampleDataType::IEEE_Float), IPcmData::SynthesisMode::Oscillator);
+			ASSERT_THAT(reference, NotNull());
+			ASSERT_HRESULT_SUCCEEDED(reference->generateChannels(&tone));
+			references.push_back(reference);
+		}
+		std::vector<float> sum(frames), wave(frames);
+		auto referenceTime = Benchmark::measure([&]() {
+			std::fill(sum.begin(), sum.end(), 0.0f);
+			for(auto& reference : references) {
+				reference->copyTo(wave.data(), frames * sizeof(float));
+				for(size_t frame = 0; frame < frames; frame++) { sum[frame] += wave[frame]; }
+			}
+		});
+		std::cout << oscillators << "," << referenceTime;
+
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ",,"; continue; }
+			SimdKernel::setInstructionSet(is);
+			auto time = Benchmark::measure([&]() { bank->copyTo(buffer.get(), bufferSize); });
+			// Oscillators that can be summed while 1 second of samples is played.
+			std::cout << "," << time << "," << (size_t)(oscillators * (duration * 1000.0) / time);
+		}
+		std::cout << std::endl;
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures how many times faster than real time a script of DTMF digits is rendered, for all instruction sets supported by the CPU.
+// Sine(uSec) is time of OscillatorPcmData that synthesizes a tone of the same duration, for reference.
+TEST(PcmDataBenchmark, DISABLED_dtmfScript)
+{
+	static const WORD channels = 1;
+	static const size_t duration = 1000;
+	static const char digits[] = "0123456789*#ABCD,";
+
+	std::cout << "Samples/Sec,Sine(uSec)";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << "(uSec)," << SimdKernel::getInstructionSetName(is) << "(x Real time)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(DWORD samplesPerSec : { 8000, 44100, 48000, 192000 }) {
+		auto dtmf = createPcmData(samplesPerSec, channels, createDtmfWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+		ASSERT_THAT(dtmf, NotNull());
+		ASSERT_HRESULT_SUCCEEDED(dtmf->generateDigits(digits));
+		auto bufferSize = dtmf->getSampleBufferSize(duration);
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+		auto sine = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), IPcmData::SynthesisMode::Oscillator);
+		sine->generate(697);
+		auto sineTime = Benchmark::measure([&]() { sine->copyTo(buffer.get(), bufferSize); });
+		std::cout << samplesPerSec << "," << sineTime;
+
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ",,"; continue; }
+			SimdKernel::setInstructionSet(is);
+			auto time = Benchmark::measure([&]() { dtmf->copyTo(buffer.get(), bufferSize); });
+			std::cout << "," << time << "," << (size_t)((duration * 1000.0) / time);
+		}
+		std::cout << std::endl;
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures how many times faster than real time a logarithmic sweep is synthesized, for all instruction sets supported by the CPU.
+// Data for 200mSec is copied like ToneAudioStream::onRequestSample().
+TEST(PcmDataBenchmark, DISABLED_sweep)
+{
+	static const WORD channels = 2;
+	static const size_t duration = 200;
+
+	std::cout << "Samples/Sec";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << "(uSec)," << SimdKernel::getInstructionSetName(is) << "(x Real time)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(DWORD samplesPerSec : { 44100, 48000, 96000, 192000 }) {
+		auto sweep = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_24bits), IPcmData::SynthesisMode::Sweep);
+		ASSERT_THAT(sweep, NotNull());
+		// 10 minutes sweep.
+		ASSERT_HRESULT_SUCCEEDED(sweep->generateSweep(20, 20000, 10 * 60 * 1000));
+		auto bufferSize = sweep->getSampleBufferSize(duration);
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+		std::cout << samplesPerSec;
+
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ",,"; continue; }
+			SimdKernel::setInstructionSet(is);
+			auto time = Benchmark::measure([&]() { sweep->copyTo(buffer.get(), bufferSize); });
+			std::cout << "," << time << "," << (size_t)((duration * 1000.0) / time);
+		}
+		std::cout << std::endl;
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures white and pink noise synthesized by copyTo() in MSamples/Sec, for all instruction sets supported by the CPU.
+TEST(PcmDataBenchmark, DISABLED_noise)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t duration = 200;
+
+	std::cout << "WaveForm";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << "(uSec)," << SimdKernel::getInstructionSetName(is) << "(MSamples/Sec)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(auto type : { IPcmData::WaveFormType::WhiteNoise, IPcmData::WaveFormType::PinkNoise }) {
+		auto& wp = PcmDataEnumerator::getWaveFormProperty(type);
+		auto noise = createPcmData(samplesPerSec, channels, wp.factory(IPcmData::SampleDataType::PCM_16bits, wp.defaultParameter));
+		ASSERT_THAT(noise, NotNull());
+		noise->generate(1000);
+		auto bufferSize = noise->getSampleBufferSize(duration);
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+		std::cout << wp.name;
+
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ",,"; continue; }
+			SimdKernel::setInstructionSet(is);
+			auto time = Benchmark::measure([&]() { noise->copyTo(buffer.get(), bufferSize); });
+			std::cout << "," << time << "," << ((bufferSize / sizeof(INT16)) / time);
+		}
+		std::cout << std::endl;
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures generation and analysis of maximum length sequence of each order, for all instruction sets supported by the CPU.
+// Generate(uSec) is time to generate cycle data of the sequence by IPcmData::generate(),
+// and Analyze(uSec) is time to recover impulse response from 1 period of the response.
+TEST(PcmDataBenchmark, DISABLED_mls)
+{
+	std::cout << "Order,Length";
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+		std::cout << "," << SimdKernel::getInstructionSetName(is) << " Generate(uSec)," << SimdKernel::getInstructionSetName(is) << " Analyze(uSec)";
+	}
+	std::cout << "\n";
+
+	auto instructionSet = SimdKernel::getInstructionSet();
+	for(int order = 12; order <= 20; order++) {
+		MaximumLengthSequence mls(order);
+		std::vector<float> response(mls.getLength()), impulseResponse(mls.getLength());
+		mls.generate(response.data(), response.size(), 0, 0.5f);
+		std::cout << order << "," << mls.getLength();
+
+		for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::AVX2 }) {
+			if(SimdKernel::getSupportedInstructionSet() < is) { std::cout << ",,"; continue; }
+			SimdKernel::setInstructionSet(is);
+			auto pcmData = createPcmData(48000, 1, createMlsWaveGenerator(IPcmData::SampleDataType::PCM_24bits, (float)order));
+			auto generateTime = Benchmark::measure([&]() { pcmData->generate(0); });
+			auto analyzeTime = Benchmark::measure([&]() { mls.analyze(impulseResponse.data(), response.data()); });
+			std::cout << "," << generateTime << "," << analyzeTime;
+		}
+		std::cout << std::endl;
+	}
+	SimdKernel::setInstructionSet(instructionSet);
+}
+
+// Measures the first IPcmData::generate() of oscillator and cycle table that misses and hits WaveTableCache, for each wave form.
+// Miss(uSec) includes generation of the tables(and mip levels of band-limited wave form) or the master of the cycle data,
+// and Hit(uSec) looks up the tables or the master that are shared with another IPcmData object.
+// Both include creation of the IPcmData object.
+// Cycle table is generated with exact period, so that the master holds many cycles.
+TEST(PcmDataBenchmark, DISABLED_waveTableCache)
+{
+	std::cout << "Wave form,Oscillator Miss(uSec),Oscillator Hit(uSec),Cycle table Miss(uSec),Cycle table Hit(uSec)\n";
+
+	auto& cache = WaveTableCache::getInstance();
+	for(auto& wp : PcmDataEnumerator::getWaveFormProperties()) {
+		std::cout << wp.name;
+		for(auto mode : { IPcmData::SynthesisMode::Oscillator, IPcmData::SynthesisMode::CycleTable }) {
+			auto generate = [&]() {
+				auto pcmData = createPcmData(48000, 2, wp.factory(IPcmData::SampleDataType::PCM_16bits, 0.5f), mode);
+				pcmData->setExactPeriod();
+				pcmData->generate(440.1f);
+			};
+			auto missTime = Benchmark::measure([&]() { cache.clear(); generate(); });
+			auto hitTime = Benchmark::measure(generate);
+			std::cout << "," << missTime << "," << hitTime;
+		}
+		std::cout << std::endl;
+	}
+	cache.clear();
+}
@@ -4,20 +4,24 @@
 #include <gmock/gmock.h>
 #include <tuple>
 #include <atlbase.h>
+#include <ksmedia.h>
 
 using namespace ::testing;
 
 TEST(PcmDataEnumeratorUnitTest, SampleDataTypeProperties)
 {
 	auto properties = PcmDataEnumerator::getSampleDatatypeProperties();
-	ASSERT_EQ(properties.size(), 4);
+	ASSERT_EQ(properties.size(), 7);
 
 	for(auto sp : properties) {
 		EXPECT_THAT(sp.type, AnyOf(
 			IPcmData::SampleDataType::PCM_8bits,
 			IPcmData::SampleDataType::PCM_16bits,
 			IPcmData::SampleDataType::PCM_24bits,
-			IPcmData::SampleDataType::IEEE_Float
+			IPcmData::SampleDataType::IEEE_Float,
+			IPcmData::SampleDataType::PCM_24bits_in_32,
+			IPcmData::SampleDataType::PCM_32bits,
+			IPcmData::SampleDataType::IEEE_Double
 		));
 	}
 }
@@ -25,14 +29,74 @@ TEST(PcmDataEnumeratorUnitTest, SampleDataTypeProperties)
 TEST(PcmDataEnumeratorUnitTest, WaveFormProperties)
 {
 	auto properties = PcmDataEnumerator::getWaveFormProperties();
-	ASSERT_EQ(properties.size(), 3);
+	ASSERT_EQ(properties.size(), 10);
 
 	for(auto wp : properties) {
 		EXPECT_THAT(wp.type, AnyOf(
 			IPcmData::WaveFormType::SquareWave,
 			IPcmData::WaveFormType::SineWave,
-			IPcmData::WaveFormType::TriangleWave
+			IPcmData::WaveFormType::TriangleWave,
+			IPcmData::WaveFormType::DTMF,
+			IPcmData::WaveFormType::MF,
+			IPcmData::WaveFormType::WhiteNoise,
+			IPcmData::WaveFormType::PinkNoise,
+			IPcmData::WaveFormType::MLS,
+			IPcmData::WaveFormType::BandLimitedSquareWave,
+			IPcmData::WaveFormType::BandLimitedTriangleWave
 		));
+
+		// Digit parameter is index of the digit.
+		if(wp.parameter == PcmDataEnumerator::FactoryParameter::Digit) {
+			ASSERT_THAT(PcmDataEnumerator::getDigits(wp.type), NotNull());
+			EXPECT_LT(wp.defaultParameter, strlen(PcmDataEnumerator::getDigits(wp.type)));
+		} else {
+			EXPECT_THAT(PcmDataEnumerator::getDigits(wp.type), IsNull());
+		}
+	}
+}
+
+TEST(PcmDataEnumeratorUnitTest, SynthesisModeProperties)
+{
+	auto properties = PcmDataEnumerator::getSynthesisModeProperties();
+	ASSERT_EQ(properties.size(), 5);
+
+	for(auto mp : properties) {
+		EXPECT_EQ(mp.mode, PcmDataEnumerator::getSynthesisModeProperty(mp.mode).mode);
+
+		// createPcmData() should create IPcmData of every synthesis mode.
+		// Stream is selected by the wave form that has no cycle data.
+		auto gen = (mp.mode == IPcmData::SynthesisMode::Stream) ?
+			createDtmfWaveGenerator(IPcmData::SampleDataType::PCM_16bits) : createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits);
+		auto pcmData = createPcmData(48000, 2, gen, mp.mode);
+		ASSERT_TRUE(pcmData) << mp.name;
+		EXPECT_EQ(mp.mode, pcmData->getSynthesisMode());
+	}
+}
+
+// WAVEFORMATEXTENSIBLE should have speaker positions of the standard layout for the channel count.
+TEST(PcmDataEnumeratorUnitTest, ChannelMask)
+{
+	static const DWORD expected[] = {
+		0,
+		KSAUDIO_SPEAKER_MONO,
+		KSAUDIO_SPEAKER_STEREO,
+		0,
+		KSAUDIO_SPEAKER_QUAD,
+		0,
+		KSAUDIO_SPEAKER_5POINT1,
+		0,
+		KSAUDIO_SPEAKER_7POINT1_SURROUND,
+		0,
+	};
+
+	for(WORD channels = 1; channels < ARRAYSIZE(expected); channels++) {
+		auto gen = createSineWaveGenerator(IPcmData::SampleDataType::PCM_24bits_in_32);
+		auto pcmData(createPcmData(48000, channels, gen));
+		ASSERT_THAT(pcmData, NotNull());
+		WAVEFORMATEXTENSIBLE format;
+		pcmData->getWaveFormat(format);
+		EXPECT_EQ(format.Format.wFormatTag, WAVE_FORMAT_EXTENSIBLE);
+		EXPECT_EQ(format.dwChannelMask, expected[channels]) << "channels=" << channels;
 	}
 }
 
@@ -79,8 +143,28 @@ TEST_P(PcmDataEnumeratorUnitTest, WaveGenerator)
 	EXPECT_STREQ(pcmData->getSampleDataTypeName(), sp.name);
 	EXPECT_EQ(pcmData->getBitsPerSample(), sp.bitsPerSample);
 	EXPECT_EQ(pcmData->getFormatTag(), sp.formatTag);
+	EXPECT_EQ(pcmData->getValidBitsPerSample(), sp.validBitsPerSample);
 	EXPECT_EQ(pcmData->getWaveFormType(), wp.type);
 	EXPECT_STREQ(pcmData->getWaveFormTypeName(), wp.name);
+
+	// WAVEFORMATEXTENSIBLE is used only if sample value does not fill the container.
+	WAVEFORMATEXTENSIBLE format;
+	pcmData->getWaveFormat(format);
+	EXPECT_EQ(format.Format.wFormatTag, sp.formatTag);
+	EXPECT_EQ(format.Format.nChannels, channels);
+	EXPECT_EQ(format.Format.nSamplesPerSec, samplesPerSec);
+	EXPECT_EQ(format.Format.nBlockAlign, pcmData->getBlockAlign());
+	EXPECT_EQ(format.Format.nAvgBytesPerSec, samplesPerSec * pcmData->getBlockAlign());
+	EXPECT_EQ(format.Format.wBitsPerSample, sp.bitsPerSample);
+	if(sp.bitsPerSample == sp.validBitsPerSample) {
+		EXPECT_EQ(format.Format.cbSize, 0);
+	} else {
+		EXPECT_EQ(format.Format.wFormatTag, WAVE_FORMAT_EXTENSIBLE);
+		EXPECT_EQ(format.Format.cbSize, sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX));
+		EXPECT_EQ(format.Samples.wValidBitsPerSample, sp.validBitsPerSample);
+		EXPECT_EQ(format.dwChannelMask, SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT);
+		EXPECT_EQ(0, memcmp(&format.SubFormat, &KSDATAFORMAT_SUBTYPE_PCM, sizeof(GUID)));
+	}
 }
 
 INSTANTIATE_TEST_SUITE_P(AllProperties, PcmDataEnumeratorUnitTest,
@@ -1,9 +1,13 @@
 #include <PcmData/PcmData.h>
 #include <PcmData/PcmSample.h>
+#include <PcmData/MaximumLengthSequence.h>
+#include <PcmData/WaveTableCache.h>
+#include <PcmData/SineTable.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <tuple>
+#include <vector>
 #include <atlbase.h>
 
 using namespace ::testing;
@@ -34,9 +38,10 @@ public:
 	INT32 highValue;
 	INT32 zeroValue;
 	INT32 lowValue;
-	INT32 positiveHeight;
-	INT32 negativeHeight;
-	INT32 difference;
+	// Heights of 32-bit sample exceed the range of INT32.
+	double positiveHeight;
+	double negativeHeight;
+	double difference;
 
 	PcmDataUnitTest()
 		: sp(std::get<0>(GetParam())), wp(std::get<1>(GetParam()))
@@ -49,8 +54,8 @@ public:
 		highValue = IPcmSample::getHighValue(sp.type).getInt32();
 		zeroValue = IPcmSample::getZeroValue(sp.type).getInt32();
 		lowValue = IPcmSample::getLowValue(sp.type).getInt32();
-		positiveHeight = highValue - zeroValue;
-		negativeHeight = zeroValue - lowValue;
+		positiveHeight = (double)highValue - zeroValue;
+		negativeHeight = (double)zeroValue - lowValue;
 		difference = positiveHeight + negativeHeight;
 	}
 
@@ -58,6 +63,7 @@ public:
 		double squreTotal = (double)(positiveHeight + negativeHeight) * sampleCount / channels / 2;
 		switch(wp.type) {
 		case IPcmData::WaveFormType::SquareWave:
+		case IPcmData::WaveFormType::BandLimitedSquareWave:
 			// Signed total depends on duby.
 			signedTotal = squreTotal * (waveGeneratorParam - 0.5) * 2;
 			unsignedTotal = squreTotal;
@@ -67,6 +73,7 @@ public:
 			unsignedTotal = (double)squreTotal * 2 / 3.141592;
 			break;
 		case IPcmData::WaveFormType::TriangleWave:
+		case IPcmData::WaveFormType::BandLimitedTriangleWave:
 			signedTotal = 0;
 			unsignedTotal = squreTotal / 2;
 			break;
@@ -150,10 +157,60 @@ TEST_P(PcmDataUnitTest, total)
 	}
 }
 
+TEST_P(PcmDataUnitTest, oscillator)
+{
+	// Create IPcmData object that synthesizes samples by oscillator.
+	auto gen = wp.factory(sp.type, waveGeneratorParam);
+	auto pcmData = createPcmData(samplesPerSec, channels, gen, IPcmData::SynthesisMode::Oscillator);
+	ASSERT_THAT(pcmData, NotNull());
+	ASSERT_EQ(pcmData->getSynthesisMode(), IPcmData::SynthesisMode::Oscillator);
+	pcmData->generate(key, 1.0f, phaseShift);
+
+	// Oscillator does not have 1-cycle data to be accessed by IPcmSample.
+	EXPECT_THAT(createPcmSample(pcmData), IsNull());
+
+	// Copy samples for 1 second that contains exactly `key` cycles.
+	auto bufferSize = pcmData->getSampleBufferSize(1000);
+	auto buffer = std::make_unique<BYTE[]>(bufferSize);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+
+	// Test value of Samples copied to the buffer.
+	// Tolerance is a sample per cycle for interpolation of edges of the wave.
+	std::unique_ptr<IPcmSample> pcmSample(createPcmSample(sp.type, buffer.get(), bufferSize));
+	ASSERT_THAT(pcmSample, NotNull());
+	double expectedUnsignedTotal, expectedSignedTotal, unsignedTotal, signedTotal;
+	getExpectedTotal(pcmSample->getSampleCount(), expectedSignedTotal, expectedUnsignedTotal);
+	auto tolerance = difference * key;
+	for(WORD ch = 0; ch < channels; ch++) {
+		getTotal(pcmSample.get(), ch, unsignedTotal, signedTotal);
+		EXPECT_NEAR(unsignedTotal, expectedUnsignedTotal, tolerance)	<< "Oscillator: Unsigned total: channel=" << (ch + 1);
+		EXPECT_NEAR(signedTotal, expectedSignedTotal, tolerance)		<< "Oscillator: Signed total: channel=" << (ch + 1);
+	}
+}
+
+// Wave forms that generate 1-cycle data of the key.
+// Digits of DTMF and MF are tested by DualToneUnitTest, noise is tested by NoiseUnitTest, and MLS is tested by MlsUnitTest.
+static std::vector<PcmDataEnumerator::WaveFormProperty> getCycleWaveFormProperties()
+{
+	std::vector<PcmDataEnumerator::WaveFormProperty> ret;
+	for(auto& wp : PcmDataEnumerator::getWaveFormProperties()) {
+		switch(wp.parameter) {
+		case PcmDataEnumerator::FactoryParameter::Digit:
+		case PcmDataEnumerator::FactoryParameter::Seed:
+		case PcmDataEnumerator::FactoryParameter::Order:
+			break;
+		default:
+			ret.push_back(wp);
+			break;
+		}
+	}
+	return ret;
+}
+
 INSTANTIATE_TEST_SUITE_P(AllWaveForm, PcmDataUnitTest,
 	Combine(
 		ValuesIn(PcmDataEnumerator::getSampleDatatypeProperties()),
-		ValuesIn(PcmDataEnumerator::getWaveFormProperties()),
+		ValuesIn(getCycleWaveFormProperties()),
 		Values(44100, 32000),										// Samples/Second
 		Values(1, 2, 4),											// Channels
 		Values(440, 600),											// Key
@@ -163,6 +220,19 @@ INSTANTIATE_TEST_SUITE_P(AllWaveForm, PcmDataUnitTest,
 	PcmDataUnitTest::Name()
 );
 
+INSTANTIATE_TEST_SUITE_P(HighSampleRate, PcmDataUnitTest,
+	Combine(
+		ValuesIn(PcmDataEnumerator::getSampleDatatypeProperties()),
+		ValuesIn(getCycleWaveFormProperties()),
+		Values(192000, 384000),										// Samples/Second
+		Values(2),													// Channels
+		Values(440),												// Key
+		Values(0),													// Phase shift
+		Values(DefaultWaveGeneratorParam)
+	),
+	PcmDataUnitTest::Name()
+);
+
 INSTANTIATE_TEST_SUITE_P(SquareWaveForm, PcmDataUnitTest,
 	Combine(
 		ValuesIn(PcmDataEnumerator::getSampleDatatypeProperties()),
@@ -189,6 +259,32 @@ INSTANTIATE_TEST_SUITE_P(TriangleWaveForm, PcmDataUnitTest,
 	PcmDataUnitTest::Name()
 );
 
+INSTANTIATE_TEST_SUITE_P(BandLimitedSquareWaveForm, PcmDataUnitTest,
+	Combine(
+		ValuesIn(PcmDataEnumerator::getSampleDatatypeProperties()),
+		Values(PcmDataEnumerator::getWaveFormProperty(IPcmData::WaveFormType::BandLimitedSquareWave)),
+		Values(44100, 32000),										// Samples/Second
+		Values(1),													// Channels
+		Values(440, 600),											// Key
+		Values(0),													// Phase shift
+		Values(0.1, 0.4, 0.9)										// Duty
+	),
+	PcmDataUnitTest::Name()
+);
+
+INSTANTIATE_TEST_SUITE_P(BandLimitedTriangleWaveForm, PcmDataUnitTest,
+	Combine(
+		ValuesIn(PcmDataEnumerator::getSampleDatatypeProperties()),
+		Values(PcmDataEnumerator::getWaveFormProperty(IPcmData::WaveFormType::BandLimitedTriangleWave)),
+		Values(44100, 32000),										// Samples/Second
+		Values(1),													// Channels
+		Values(440, 600),											// Key
+		Values(0),													// Phase shift
+		Values(0, 0.3, 0.5, 0.8, 1)									// Peak position
+	),
+	PcmDataUnitTest::Name()
+);
+
 
 using PcmDataBufferUnitTestDataType = std::tuple<
 	PcmDataEnumerator::SampleDataTypeProperty,
@@ -269,6 +365,80 @@ TEST_P(PcmDataBufferUnitTest, buffer)
 	}
 }
 
+// Copying successively should continue samples from the position where previous copying ended,
+// even if the buffer size is not multiple of 1-cycle size.
+TEST_P(PcmDataBufferUnitTest, successive)
+{
+	auto gen = createTriangleWaveGenerator(sp.type);
+	auto pcmData = createPcmData(samplesPerSec, channels, gen);
+	ASSERT_THAT(pcmData, NotNull());
+	pcmData->generate(key, 1.0f, 0.0f);
+
+	std::unique_ptr<IPcmSample> pcmSampleSrc(createPcmSample(pcmData));
+	ASSERT_THAT(pcmSampleSrc, NotNull());
+	auto samplesPerCycle = pcmData->getSamplesPerCycle();
+
+	// Buffer sizes: 1 block, shorter than 1 cycle, longer than 1 cycle and given duration.
+	auto blockAlign = pcmData->getBlockAlign();
+	const size_t bufferSizes[] = {
+		blockAlign,
+		pcmData->getSampleBufferSize(0) / 2 / blockAlign * blockAlign + blockAlign,
+		pcmData->getSampleBufferSize(0) * 3 + blockAlign,
+		pcmData->getSampleBufferSize(duration),
+	};
+
+	size_t srcIndex = 0;
+	for(auto bufferSize : bufferSizes) {
+		auto buffer = std::make_unique<BYTE[]>(bufferSize);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+		std::unique_ptr<IPcmSample> pcmSampleDest(createPcmSample(sp.type, buffer.get(), bufferSize));
+		ASSERT_THAT(pcmSampleDest, NotNull());
+		for(size_t i = 0; i < pcmSampleDest->getSampleCount(); i++) {
+			auto ii = srcIndex++ % samplesPerCycle;
+			ASSERT_EQ((*pcmSampleSrc)[ii].getInt32(), (*pcmSampleDest)[i].getInt32())
+				<< "Buffer size=" << bufferSize << ", Source sample[" << ii << "], Dest sample[" << i << "]";
+		}
+	}
+}
+
+// Tiled cycle data should not change samples copied by copyTo() of any size.
+TEST_P(PcmDataBufferUnitTest, tiled)
+{
+	std::shared_ptr<IPcmData> pcmData[2];
+	for(auto& p : pcmData) {
+		p = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(sp.type));
+		ASSERT_THAT(p, NotNull());
+	}
+	auto& tiled = pcmData[0];
+	auto& notTiled = pcmData[1];
+	auto blockSize = tiled->getSampleBufferSize(duration);
+	ASSERT_HRESULT_SUCCEEDED(tiled->setBlockSize(blockSize, blockSize * 2));
+	for(auto& p : pcmData) { p->generate(key, 1.0f, 0.0f); }
+	ASSERT_TRUE(tiled->isTiled());
+	ASSERT_FALSE(notTiled->isTiled());
+	EXPECT_EQ(tiled->getCycleDataSize(), tiled->getSampleBufferSize(0) + blockSize);
+	EXPECT_EQ(notTiled->getCycleDataSize(), notTiled->getSampleBufferSize(0));
+
+	const size_t bufferSizes[] = { blockSize, blockSize, tiled->getBlockAlign(), blockSize, blockSize * 2 + tiled->getBlockAlign(), blockSize };
+	auto expected = std::make_unique<BYTE[]>(blockSize * 3);
+	auto actual = std::make_unique<BYTE[]>(blockSize * 3);
+	for(auto bufferSize : bufferSizes) {
+		ASSERT_HRESULT_SUCCEEDED(notTiled->copyTo(expected.get(), bufferSize));
+		ASSERT_HRESULT_SUCCEEDED(tiled->copyTo(actual.get(), bufferSize));
+		ASSERT_EQ(memcmp(expected.get(), actual.get(), bufferSize), 0) << "Buffer size=" << bufferSize;
+	}
+
+	// Cycle data should not be tiled if it exceeds maxTiledDataSize.
+	ASSERT_HRESULT_SUCCEEDED(tiled->setBlockSize(blockSize, blockSize));
+	EXPECT_FALSE(tiled->isTiled());
+	EXPECT_EQ(tiled->getCycleDataSize(), tiled->getSampleBufferSize(0));
+
+	// Block size should be boundary of block align.
+	if(1 < tiled->getBlockAlign()) {
+		EXPECT_HRESULT_FAILED(tiled->setBlockSize(blockSize + 1));
+	}
+}
+
 INSTANTIATE_TEST_SUITE_P(all, PcmDataBufferUnitTest,
 	Combine(
 		ValuesIn(PcmDataEnumerator::getSampleDatatypeProperties()),
@@ -279,3 +449,1540 @@ INSTANTIATE_TEST_SUITE_P(all, PcmDataBufferUnitTest,
 	),
 	PcmDataBufferUnitTest::Name()
 );
+
+// Oscillator should keep exact frequency:
+//   Samples of the next second should be equal to the first second, if key is integer.
+//   PcmData that rounds 1-cycle to integer sample count can not do it, unless key is a divisor of samples/second.
+TEST(OscillatorUnitTest, frequency)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+	static const float key = 440;
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), IPcmData::SynthesisMode::Oscillator);
+		ASSERT_THAT(pcmData, NotNull());
+		pcmData->generate(key, 1.0f, 0.25f);
+
+		auto bufferSize = pcmData->getSampleBufferSize(1000);
+		auto first = std::make_unique<BYTE[]>(bufferSize);
+		auto next = std::make_unique<BYTE[]>(bufferSize);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(first.get(), bufferSize));
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(next.get(), bufferSize));
+
+		// Float master has 24-bit precision, that is less than 1 LSB of 32-bit sample.
+		auto tolerance = (std::max)(1, IPcmSample::getHighValue(sp.type).getInt32() >> 22);
+		std::unique_ptr<IPcmSample> firstSample(createPcmSample(sp.type, first.get(), bufferSize));
+		std::unique_ptr<IPcmSample> nextSample(createPcmSample(sp.type, next.get(), bufferSize));
+		for(size_t i = 0; i < firstSample->getSampleCount(); i++) {
+			ASSERT_NEAR((*firstSample)[i].getInt32(), (*nextSample)[i].getInt32(), tolerance) << sp.name << ": Sample[" << i << "]";
+		}
+	}
+}
+
+TEST(ExactPeriodUnitTest, integerKey)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type));
+		ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod());
+
+		// 44100 / GCD(44100, 440) = 2205 frames hold 22 cycles.
+		pcmData->generate(440);
+		EXPECT_EQ(2205 * channels, pcmData->getSamplesPerCycle()) << sp.name;
+		EXPECT_EQ(22, pcmData->getCycles()) << sp.name;
+		EXPECT_EQ(0, pcmData->getFrequencyError()) << sp.name;
+
+		// Nearest period is used if exact period exceeds the ceiling.
+		// 902 frames hold 9 cycles of 440.022Hz.
+		ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod(2000 * pcmData->getBlockAlign()));
+		pcmData->generate(440);
+		EXPECT_EQ(902 * channels, pcmData->getSamplesPerCycle()) << sp.name;
+		EXPECT_EQ(9, pcmData->getCycles()) << sp.name;
+		EXPECT_NEAR(0.022, pcmData->getFrequencyError(), 0.001) << sp.name;
+
+		// 1-cycle data is used if 1-cycle data exceeds the ceiling.
+		ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod(100 * pcmData->getBlockAlign()));
+		pcmData->generate(440);
+		EXPECT_EQ(100 * channels, pcmData->getSamplesPerCycle()) << sp.name;
+		EXPECT_EQ(1, pcmData->getCycles()) << sp.name;
+		EXPECT_NEAR(1.0, pcmData->getFrequencyError(), 0.001) << sp.name;
+
+		// Exact period is disabled.
+		ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod(0));
+		pcmData->generate(440);
+		EXPECT_EQ(1, pcmData->getCycles()) << sp.name;
+	}
+}
+
+TEST(ExactPeriodUnitTest, fractionalKey)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 1;
+	static const float key = 261.63f;		// C4
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	pcmData->generate(key);
+	auto singleCycleError = fabs(pcmData->getFrequencyError());
+
+	ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod());
+	pcmData->generate(key);
+	EXPECT_LT(1, pcmData->getCycles());
+	EXPECT_LE(pcmData->getCycleDataSize(), (size_t)IPcmData::DefaultMaxExactPeriodDataSize);
+	EXPECT_GT(singleCycleError / 1000, fabs(pcmData->getFrequencyError()));
+}
+
+TEST(ExactPeriodUnitTest, continuity)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 1;
+	static const float key = 440;
+	static const double pi = 3.14159265358979;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod());
+	pcmData->generate(key, 1.0f);
+
+	// Samples of 1 second should be continuous sine wave of the key without drift.
+	auto bufferSize = pcmData->getSampleBufferSize(1000);
+	auto buffer = std::make_unique<BYTE[]>(bufferSize);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+	std::unique_ptr<IPcmSample> sample(createPcmSample(IPcmData::SampleDataType::PCM_16bits, buffer.get(), bufferSize));
+	ASSERT_EQ(samplesPerSec, sample->getSampleCount());
+	for(size_t i = 0; i < sample->getSampleCount(); i++) {
+		auto expected = sin(2 * pi * key * i / samplesPerSec) * 0x6000;		// PcmData<INT16>::HighValue
+		ASSERT_NEAR(expected, (double)(*sample)[i], 2) << "Sample[" << i << "]";
+	}
+}
+
+// Channels of exact period data should be in phase with phaseShift 0, although 1 cycle is fractional frames.
+TEST(ExactPeriodUnitTest, inPhase)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 4;
+	// 1 cycle is 100.227 frames.
+	static const float key = 440;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::IEEE_Float));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod());
+	for(auto phaseShift : { 0.0f, 1.0f }) {
+		pcmData->generate(key, 1.0f, phaseShift);
+		ASSERT_LT(1, pcmData->getCycles());
+		auto frames = pcmData->getSamplesPerCycle() / channels;
+		std::vector<float> samples(frames * channels);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(float)));
+		for(size_t frame = 0; frame < frames; frame++) {
+			for(WORD channel = 1; channel < channels; channel++) {
+				ASSERT_EQ(samples[frame * channels], samples[(frame * channels) + channel])
+					<< "phaseShift=" << phaseShift << ", frame=" << frame << ", channel=" << channel;
+			}
+		}
+	}
+
+	// Opposite phase of 2 channels is rounded to the nearest frame of the fractional cycle.
+	pcmData->generate(key, 1.0f, 0.5f);
+	auto frames = pcmData->getSamplesPerCycle() / channels;
+	std::vector<float> samples(frames * channels);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(float)));
+	auto shift = (size_t)floor((0.5 * frames / pcmData->getCycles()) + 0.5);
+	for(size_t frame = 0; frame + shift < frames; frame++) {
+		ASSERT_EQ(samples[(frame + shift) * channels], samples[(frame * channels) + 1]) << "frame=" << frame;
+		ASSERT_EQ(samples[frame * channels], samples[(frame * channels) + 2]) << "frame=" << frame;
+	}
+}
+
+// In RetuneMode::Reset, copyTo() should restart from the beginning of cycle data after generate().
+TEST(RetuneUnitTest, reset)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	pcmData->generate(440);
+	auto bufferSize = pcmData->getSampleBufferSize(0);
+	auto first = std::make_unique<BYTE[]>(bufferSize);
+	auto next = std::make_unique<BYTE[]>(bufferSize);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(first.get(), bufferSize));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(next.get(), 100 * pcmData->getBlockAlign()));
+
+	pcmData->generate(440);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(next.get(), bufferSize));
+	EXPECT_EQ(0, memcmp(first.get(), next.get(), bufferSize));
+}
+
+// In RetuneMode::Continuous without crossfade, generate() with the same key should not affect samples.
+TEST(RetuneUnitTest, sameKey)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto expectedData = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(sp.type));
+		auto actualData = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(sp.type));
+		ASSERT_HRESULT_SUCCEEDED(actualData->setRetuneMode(IPcmData::RetuneMode::Continuous, 0));
+		expectedData->generate(440);
+		actualData->generate(440);
+
+		auto bufferSize = expectedData->getSampleBufferSize(10);
+		auto expected = std::make_unique<BYTE[]>(bufferSize);
+		auto actual = std::make_unique<BYTE[]>(bufferSize);
+		for(int i = 0; i < 10; i++) {
+			ASSERT_HRESULT_SUCCEEDED(expectedData->copyTo(expected.get(), bufferSize));
+			ASSERT_HRESULT_SUCCEEDED(actualData->copyTo(actual.get(), bufferSize));
+			ASSERT_EQ(0, memcmp(expected.get(), actual.get(), bufferSize)) << sp.name << ": Buffer[" << i << "]";
+			actualData->generate(440);
+		}
+	}
+}
+
+// In RetuneMode::Continuous, samples should not jump when the key is changed.
+// Samples in crossfade should be between old wave and new wave.
+TEST(RetuneUnitTest, crossfade)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 1;
+	static const size_t crossfadeFrames = 64;
+	static const double pi = 3.14159265358979;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->setRetuneMode(IPcmData::RetuneMode::Continuous, crossfadeFrames));
+	pcmData->generate(440, 1.0f);
+
+	// Copy 3 buffers changing the key for each buffer, so that the buffer size is not a multiple of the cycles.
+	static const size_t frames = 1000;
+	std::vector<INT16> buffer(frames * 3);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&buffer[0], frames * sizeof(INT16)));
+	pcmData->generate(880, 1.0f);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&buffer[frames], frames * sizeof(INT16)));
+	pcmData->generate(330, 1.0f);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&buffer[frames * 2], 10 * sizeof(INT16)));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&buffer[(frames * 2) + 10], (frames - 10) * sizeof(INT16)));
+
+	// Maximum difference between adjacent samples of 880Hz sine wave with margin of rounding.
+	auto maxStep = (2 * pi * 880 / samplesPerSec * 0x6000) + 16;
+	for(size_t i = 1; i < buffer.size(); i++) {
+		ASSERT_GE(maxStep, abs(buffer[i] - buffer[i - 1])) << "Sample[" << i << "]";
+	}
+
+	// Crossfade ends in crossfadeFrames and new wave continues without crossfade.
+	auto cycleSize = pcmData->getSampleBufferSize(0);
+	auto cycleData = std::make_unique<BYTE[]>(cycleSize);
+	auto cycle = (const INT16*)cycleData.get();
+	auto cycleFrames = cycleSize / sizeof(INT16);
+	auto start = frames * 2 + crossfadeFrames;
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(cycleData.get(), cycleSize));
+	auto matches = [&](size_t offset) {
+		for(size_t i = start; i < buffer.size(); i++) {
+			if(cycle[(offset + i - start) % cycleFrames] != buffer[i]) { return false; }
+		}
+		return true;
+	};
+	size_t offset = 0;
+	while((offset < cycleFrames) && !matches(offset)) { offset++; }
+	EXPECT_GT(cycleFrames, offset);
+}
+
+// Each cursor should have it's own position.
+// Copying by a cursor should not affect samples copied by another cursor and IPcmData::copyTo().
+TEST(CursorUnitTest, independent)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+			auto expectedData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), synthesisMode);
+			auto actualData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), synthesisMode);
+			expectedData->generate(440);
+			actualData->generate(440);
+			auto audio = actualData->createCursor();
+			auto video = actualData->createCursor();
+			ASSERT_THAT(audio, NotNull());
+
+			auto bufferSize = expectedData->getSampleBufferSize(10);
+			auto expected = std::make_unique<BYTE[]>(bufferSize);
+			auto actual = std::make_unique<BYTE[]>(bufferSize);
+			auto other = std::make_unique<BYTE[]>(bufferSize);
+			for(int i = 0; i < 10; i++) {
+				ASSERT_HRESULT_SUCCEEDED(expectedData->copyTo(expected.get(), bufferSize));
+				ASSERT_HRESULT_SUCCEEDED(video->copyTo(other.get(), (i + 1) * expectedData->getBlockAlign()));
+				ASSERT_HRESULT_SUCCEEDED(actualData->copyTo(other.get(), (i + 5) * expectedData->getBlockAlign()));
+				ASSERT_HRESULT_SUCCEEDED(audio->copyTo(actual.get(), bufferSize));
+				ASSERT_EQ(0, memcmp(expected.get(), actual.get(), bufferSize)) << sp.name << ": Buffer[" << i << "]";
+			}
+		}
+	}
+}
+
+// New cursor should start from the beginning of the cycle data.
+// Cursor should keep it's position when cycle data is re-tiled by setBlockSize().
+TEST(CursorUnitTest, position)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 1;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	pcmData->generate(440);
+	auto cycleSize = pcmData->getSampleBufferSize(0);
+	auto cycleFrames = cycleSize / sizeof(INT16);
+	std::vector<INT16> cycle(cycleFrames);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(cycle.data(), 10 * sizeof(INT16)));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->createCursor()->copyTo(cycle.data(), cycleSize));
+
+	auto cursor = pcmData->createCursor();
+	INT16 sample;
+	ASSERT_HRESULT_SUCCEEDED(cursor->copyTo(&sample, sizeof(sample)));
+	EXPECT_EQ(cycle[0], sample);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->setBlockSize(100 * sizeof(INT16)));
+	ASSERT_TRUE(pcmData->isTiled());
+	ASSERT_HRESULT_SUCCEEDED(cursor->copyTo(&sample, sizeof(sample)));
+	EXPECT_EQ(cycle[1], sample);
+
+	// Cursor restarts when new data is generated in RetuneMode::Reset.
+	pcmData->generate(440);
+	ASSERT_HRESULT_SUCCEEDED(cursor->copyTo(&sample, sizeof(sample)));
+	EXPECT_EQ(cycle[0], sample);
+}
+
+// Level should be applied to samples copied, for cycle table and oscillator.
+TEST(LevelUnitTest, level)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+			auto pcmData = createPcmData(samplesPerSec, channels, createSquareWaveGenerator(sp.type), synthesisMode);
+			auto zero = IPcmSample::getZeroValue(sp.type).getInt32();
+			auto high = IPcmSample::getHighValue(sp.type).getInt32();
+			pcmData->generate(440, 0.5f);
+
+			auto bufferSize = pcmData->getSampleBufferSize(10);
+			auto buffer = std::make_unique<BYTE[]>(bufferSize);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+			std::unique_ptr<IPcmSample> sample(createPcmSample(sp.type, buffer.get(), bufferSize));
+			EXPECT_NEAR(zero + ((high - zero) * 0.5), (*sample)[0].getInt32(), 1) << sp.name;
+
+			// Level changes without ramp.
+			ASSERT_HRESULT_SUCCEEDED(pcmData->setLevel(1.0f, 0));
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+			EXPECT_EQ(high, (*sample)[0].getInt32()) << sp.name;
+		}
+	}
+}
+
+// setLevel() should change level linearly in rampFrames without generating data again.
+TEST(LevelUnitTest, ramp)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+	static const size_t rampFrames = 100;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSquareWaveGenerator(IPcmData::SampleDataType::PCM_16bits, 0.9f));
+	pcmData->setBlockSize(pcmData->getSampleBufferSize(10));
+	pcmData->generate(100, 1.0f);
+	auto cycleDataSize = pcmData->getCycleDataSize();
+
+	// Ramp from 1.0 to 0.5 over 2 buffers.
+	ASSERT_HRESULT_SUCCEEDED(pcmData->setLevel(0.5f, rampFrames));
+	std::vector<INT16> samples(rampFrames * channels * 2);
+	auto bufferSize = (samples.size() / 2) * sizeof(INT16);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), bufferSize));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&samples[samples.size() / 2], bufferSize));
+	EXPECT_EQ(cycleDataSize, pcmData->getCycleDataSize());
+
+	// Square wave is high during the test. Samples should decrease monotonically to 0x3000.
+	for(size_t i = channels; i < samples.size(); i++) {
+		ASSERT_GE(samples[i - channels], samples[i]) << "Sample[" << i << "]";
+		ASSERT_LT(0x3000 - 2, samples[i]) << "Sample[" << i << "]";
+	}
+	EXPECT_NEAR(0x3000, samples[(rampFrames - 1) * channels], 1);
+	EXPECT_EQ(0x3000, samples.back());
+}
+
+// Dither should add noise to integer samples converted with the level, for cycle table and oscillator.
+// Noise is less than 1 LSB, and rounding might add 1 LSB.
+// IEEE float samples should not be dithered.
+TEST(DitherUnitTest, copyTo)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+			auto plainData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), synthesisMode);
+			auto ditheredData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), synthesisMode);
+			ASSERT_HRESULT_SUCCEEDED(ditheredData->setDither(IPcmData::DitherType::TPDF));
+			plainData->generate(440, 0.5f);
+			ditheredData->generate(440, 0.5f);
+
+			auto bufferSize = plainData->getSampleBufferSize(10);
+			auto plain = std::make_unique<BYTE[]>(bufferSize);
+			auto dithered = std::make_unique<BYTE[]>(bufferSize);
+			ASSERT_HRESULT_SUCCEEDED(plainData->copyTo(plain.get(), bufferSize));
+			ASSERT_HRESULT_SUCCEEDED(ditheredData->copyTo(dithered.get(), bufferSize));
+			std::unique_ptr<IPcmSample> plainSample(createPcmSample(sp.type, plain.get(), bufferSize));
+			std::unique_ptr<IPcmSample> ditheredSample(createPcmSample(sp.type, dithered.get(), bufferSize));
+
+			size_t differences = 0;
+			for(size_t i = 0; i < plainSample->getSampleCount(); i++) {
+				auto difference = (*ditheredSample)[i].getInt32() - (*plainSample)[i].getInt32();
+				ASSERT_GE(2, abs(difference)) << sp.name << ": Sample[" << i << "]";
+				if(difference) { differences++; }
+			}
+			if(sp.formatTag == WAVE_FORMAT_IEEE_FLOAT) {
+				EXPECT_EQ(0, memcmp(plain.get(), dithered.get(), bufferSize)) << sp.name;
+			} else {
+				EXPECT_LT(0u, differences) << sp.name;
+			}
+		}
+	}
+}
+
+// Each wave form should be available at every sample data type, and be the same wave at every bit depth.
+TEST(WaveFormUnitTest, sampleDataTypes)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 1;
+
+	for(auto& wp : PcmDataEnumerator::getWaveFormProperties()) {
+		std::vector<double> expected;
+		for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+			auto pcmData = createPcmData(samplesPerSec, channels, wp.factory(sp.type, wp.defaultParameter));
+			ASSERT_THAT(pcmData, NotNull()) << wp.name << ", " << sp.name;
+			EXPECT_EQ(wp.type, pcmData->getWaveFormType());
+			pcmData->generate(440, 1.0f);
+
+			auto bufferSize = pcmData->getSampleBufferSize(0);
+			auto buffer = std::make_unique<BYTE[]>(bufferSize);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+			std::unique_ptr<IPcmSample> sample(createPcmSample(sp.type, buffer.get(), bufferSize));
+
+			// Compare samples normalized to -1.0 ~ +1.0 with 8 bit resolution.
+			auto zero = (double)IPcmSample::getZeroValue(sp.type);
+			auto height = (double)IPcmSample::getHighValue(sp.type) - zero;
+			for(size_t i = 0; i < sample->getSampleCount(); i++) {
+				auto value = ((double)(*sample)[i] - zero) / height;
+				if(expected.size() <= i) { expected.push_back(value); }
+				ASSERT_NEAR(expected[i], value, 1.0 / 0x40) << wp.name << ", " << sp.name << ": Sample[" << i << "]";
+			}
+		}
+	}
+}
+
+// copyToPlanar() should copy the same samples as copyTo() to buffers of each channel,
+// and continue from the position of copyTo(), for cycle table and oscillator.
+TEST(PlanarUnitTest, copyToPlanar)
+{
+	static const DWORD samplesPerSec = 44100;
+
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+			for(WORD channels : { 1, 2, 6 }) {
+				auto expectedData = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(sp.type), synthesisMode);
+				auto actualData = createPcmData(samplesPerSec, channels, createTriangleWaveGenerator(sp.type), synthesisMode);
+				expectedData->generate(440, 1.0f, 0.3f);
+				actualData->generate(440, 1.0f, 0.3f);
+
+				auto bufferSize = expectedData->getSampleBufferSize(10);
+				auto frames = bufferSize / expectedData->getBlockAlign();
+				auto sampleSize = sp.bitsPerSample / 8;
+				auto expected = std::make_unique<BYTE[]>(bufferSize);
+				auto actual = std::make_unique<BYTE[]>(bufferSize);
+				std::vector<void*> channelBuffers;
+				for(WORD channel = 0; channel < channels; channel++) {
+					channelBuffers.push_back(&actual[channel * frames * sampleSize]);
+				}
+				for(int i = 0; i < 4; i++) {
+					// Level is changed with ramp in the second buffer.
+					if(i == 1) {
+						ASSERT_HRESULT_SUCCEEDED(expectedData->setLevel(0.5f, 100));
+						ASSERT_HRESULT_SUCCEEDED(actualData->setLevel(0.5f, 100));
+					}
+					ASSERT_HRESULT_SUCCEEDED(expectedData->copyTo(expected.get(), bufferSize));
+					if(i % 2) {
+						ASSERT_HRESULT_SUCCEEDED(actualData->copyTo(actual.get(), bufferSize));
+						ASSERT_EQ(0, memcmp(expected.get(), actual.get(), bufferSize)) << sp.name << ": Buffer[" << i << "]";
+						continue;
+					}
+					ASSERT_HRESULT_SUCCEEDED(actualData->copyToPlanar(channelBuffers.data(), frames));
+					for(size_t frame = 0; frame < frames; frame++) {
+						for(WORD channel = 0; channel < channels; channel++) {
+							ASSERT_EQ(0, memcmp(&expected[((frame * channels) + channel) * sampleSize],
+												&actual[((channel * frames) + frame) * sampleSize], sampleSize))
+								<< sp.name << ": channels=" << channels << ", Buffer[" << i << "], frame=" << frame << ", channel=" << channel;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// copyToPlanar() should fail if buffer of any channel is not passed or data has not been generated.
+TEST(PlanarUnitTest, error)
+{
+	static const WORD channels = 2;
+
+	auto pcmData = createPcmData(44100, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	INT16 left[10], right[10];
+	void* channelBuffers[channels] = { left, right };
+	EXPECT_HRESULT_FAILED(pcmData->copyToPlanar(channelBuffers, 10));
+
+	pcmData->generate(440);
+	EXPECT_HRESULT_SUCCEEDED(pcmData->copyToPlanar(channelBuffers, 10));
+	EXPECT_HRESULT_SUCCEEDED(pcmData->createCursor()->copyToPlanar(channelBuffers, 10));
+	EXPECT_HRESULT_FAILED(pcmData->copyToPlanar(nullptr, 10));
+	EXPECT_NE(S_OK, pcmData->copyToPlanar(channelBuffers, 0));
+	channelBuffers[1] = nullptr;
+	EXPECT_HRESULT_FAILED(pcmData->copyToPlanar(channelBuffers, 10));
+}
+
+// IPcmData should not be created with channels that do not fit in the buffer to convert samples,
+// and should copy samples of maximum channels in any synthesis mode.
+TEST(PlanarUnitTest, maxChannels)
+{
+	static const size_t frames = 100;
+
+	EXPECT_THAT(createPcmData(44100, 0, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits)), IsNull());
+	EXPECT_THAT(createPcmData(44100, IPcmData::MaxChannels + 1, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits)), IsNull());
+	for(auto mode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		auto pcmData = createPcmData(44100, IPcmData::MaxChannels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), mode);
+		ASSERT_THAT(pcmData, NotNull());
+		pcmData->generate(440);
+		std::vector<INT16> buffer(frames * IPcmData::MaxChannels);
+		EXPECT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.data(), buffer.size() * sizeof(INT16)));
+	}
+	auto noise = createPcmData(44100, IPcmData::MaxChannels, createWhiteNoiseGenerator(IPcmData::SampleDataType::PCM_16bits));
+	ASSERT_THAT(noise, NotNull());
+	noise->generate(0);
+	std::vector<INT16> buffer(frames * IPcmData::MaxChannels);
+	EXPECT_HRESULT_SUCCEEDED(noise->copyTo(buffer.data(), buffer.size() * sizeof(INT16)));
+}
+
+// Oscillator should generate each channel with it's own key, level and wave form.
+TEST(ChannelParameterUnitTest, oscillator)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::IEEE_Float), IPcmData::SynthesisMode::Oscillator);
+	const IPcmData::ToneParameter channelParameters[channels] = {
+		{ 440, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 },
+		{ 441, 0.5f, 0.5f, IPcmData::WaveFormType::SquareWave, 0.5f },
+	};
+	ASSERT_HRESULT_SUCCEEDED(pcmData->generateChannels(channelParameters));
+
+	// Count rising zero crossings for 1 second.
+	std::vector<float> samples(samplesPerSec * channels);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(float)));
+	for(WORD channel = 0; channel < channels; channel++) {
+		size_t crossings = 0;
+		float peak = 0;
+		for(size_t i = channel + channels; i < samples.size(); i += channels) {
+			if((samples[i - channels] < 0) && (0 <= samples[i])) { crossings++; }
+			peak = (std::max)(peak, fabsf(samples[i]));
+		}
+		EXPECT_NEAR(channelParameters[channel].key, crossings, 1) << "channel=" << channel;
+		EXPECT_NEAR(0.8f * channelParameters[channel].level, peak, 1e-3) << "channel=" << channel;
+	}
+
+	// Square wave has high or low value only.
+	for(size_t i = 1; i < samples.size(); i += channels) {
+		ASSERT_NEAR(0.4f, fabsf(samples[i]), 1e-6) << "Sample[" << i << "]";
+	}
+}
+
+// Cycle table should generate each channel with it's own level, phase and wave form for the same key.
+TEST(ChannelParameterUnitTest, cycleTable)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+	static const float key = 440;
+
+	auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	const IPcmData::ToneParameter channelParameters[channels] = {
+		{ key, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 },
+		{ key, 0.5f, 0.25f, IPcmData::WaveFormType::TriangleWave, 0.5f },
+	};
+	ASSERT_HRESULT_SUCCEEDED(pcmData->generateChannels(channelParameters));
+
+	// Each channel should be same as the wave form generated by PcmData of 1 channel.
+	auto sineData = createPcmData(samplesPerSec, 1, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	auto triangleData = createPcmData(samplesPerSec, 1, createTriangleWaveGenerator(IPcmData::SampleDataType::PCM_16bits, 0.5f));
+	sineData->generate(key, 1.0f);
+	triangleData->generate(key, 0.5f);
+	auto frames = sineData->getSamplesPerCycle();
+	ASSERT_EQ(frames * channels, pcmData->getSamplesPerCycle());
+
+	std::vector<INT16> samples(frames * channels), sine(frames), triangle(frames);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(INT16)));
+	ASSERT_HRESULT_SUCCEEDED(sineData->copyTo(sine.data(), sine.size() * sizeof(INT16)));
+	ASSERT_HRESULT_SUCCEEDED(triangleData->copyTo(triangle.data(), triangle.size() * sizeof(INT16)));
+	auto shift = (size_t)(0.25f * frames);
+	for(size_t frame = 0; frame < frames; frame++) {
+		ASSERT_EQ(sine[frame], samples[frame * channels]) << "Frame[" << frame << "]";
+		ASSERT_EQ(triangle[(frame + shift) % frames], samples[(frame * channels) + 1]) << "Frame[" << frame << "]";
+	}
+}
+
+// Cycle table can not generate channels of different keys.
+// Unknown wave form should not be accepted.
+TEST(ChannelParameterUnitTest, error)
+{
+	static const WORD channels = 2;
+
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		auto pcmData = createPcmData(44100, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), synthesisMode);
+		EXPECT_HRESULT_FAILED(pcmData->generateChannels(nullptr));
+		const IPcmData::ToneParameter unknownWaveForm[channels] = {
+			{ 440, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 },
+			{ 440, 1.0f, 0, (IPcmData::WaveFormType)100, 0 },
+		};
+		EXPECT_HRESULT_FAILED(pcmData->generateChannels(unknownWaveForm));
+
+		const IPcmData::ToneParameter differentKeys[channels] = {
+			{ 440, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 },
+			{ 441, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 },
+		};
+		if(synthesisMode == IPcmData::SynthesisMode::CycleTable) {
+			EXPECT_EQ(E_INVALIDARG, pcmData->generateChannels(differentKeys));
+		} else {
+			EXPECT_HRESULT_SUCCEEDED(pcmData->generateChannels(differentKeys));
+		}
+	}
+}
+
+// Oscillator bank should generate sum of tones to all channels.
+TEST(OscillatorBankUnitTest, tones)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t frames = samplesPerSec;
+
+	const IPcmData::ToneParameter tones[] = {
+		{ 440, 0.3f, 0, IPcmData::WaveFormType::Unknown, 0 },
+		{ 660, 0.2f, 0.25f, IPcmData::WaveFormType::SquareWave, 0.5f },
+		{ 1000.5f, 0.1f, 0.5f, IPcmData::WaveFormType::TriangleWave, 0.25f },
+	};
+	auto create = []() {
+		return createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::IEEE_Float), IPcmData::SynthesisMode::OscillatorBank);
+	};
+
+	auto pcmData = create();
+	ASSERT_HRESULT_SUCCEEDED(pcmData->generateTones(tones, ARRAYSIZE(tones)));
+	std::vector<float> samples(frames * channels);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(float)));
+
+	// Sum should be same as tones generated separately.
+	std::vector<float> expected(frames * channels, 0.0f);
+	for(auto& tone : tones) {
+		auto toneData = create();
+		ASSERT_HRESULT_SUCCEEDED(toneData->generateTones(&tone, 1));
+		std::vector<float> toneSamples(frames * channels);
+		ASSERT_HRESULT_SUCCEEDED(toneData->copyTo(toneSamples.data(), toneSamples.size() * sizeof(float)));
+		for(size_t i = 0; i < expected.size(); i++) { expected[i] += toneSamples[i]; }
+	}
+	for(size_t i = 0; i < samples.size(); i++) {
+		ASSERT_NEAR(expected[i], samples[i], 1e-6) << "Sample[" << i << "]";
+	}
+
+	// Channels should be same.
+	for(size_t frame = 0; frame < frames; frame++) {
+		ASSERT_EQ(samples[frame * channels], samples[(frame * channels) + 1]) << "Frame[" << frame << "]";
+	}
+
+	// Copy should continue from the position.
+	auto restarted = create();
+	ASSERT_HRESULT_SUCCEEDED(restarted->generateTones(tones, ARRAYSIZE(tones)));
+	std::vector<float> first(1001 * channels), next(samples.size() - first.size());
+	ASSERT_HRESULT_SUCCEEDED(restarted->copyTo(first.data(), first.size() * sizeof(float)));
+	ASSERT_HRESULT_SUCCEEDED(restarted->copyTo(next.data(), next.size() * sizeof(float)));
+	ASSERT_EQ(0, memcmp(samples.data(), first.data(), first.size() * sizeof(float)));
+	ASSERT_EQ(0, memcmp(&samples[first.size()], next.data(), next.size() * sizeof(float)));
+}
+
+// Single tone of oscillator bank should be same as oscillator with frequency error of 32-bit phase.
+TEST(OscillatorBankUnitTest, generate)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+	static const float key = 441;
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto bank = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), IPcmData::SynthesisMode::OscillatorBank);
+		auto oscillator = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), IPcmData::SynthesisMode::Oscillator);
+		ASSERT_THAT(bank, NotNull());
+		bank->generate(key, 1.0f, 0);
+		oscillator->generate(key, 1.0f, 0);
+		EXPECT_EQ(IPcmData::SynthesisMode::OscillatorBank, bank->getSynthesisMode());
+		EXPECT_GT(1e-5, fabs(bank->getFrequencyError()));
+		EXPECT_EQ(oscillator->getSamplesPerCycle(), bank->getSamplesPerCycle());
+
+		auto bufferSize = bank->getSampleBufferSize(1000);
+		auto bankBuffer = std::make_unique<BYTE[]>(bufferSize);
+		auto oscillatorBuffer = std::make_unique<BYTE[]>(bufferSize);
+		ASSERT_HRESULT_SUCCEEDED(bank->copyTo(bankBuffer.get(), bufferSize));
+		ASSERT_HRESULT_SUCCEEDED(oscillator->copyTo(oscillatorBuffer.get(), bufferSize));
+
+		// Phase of the bank differs by truncation of 32-bit phase delta, up to 1e-5 cycle in 1 second.
+		auto tolerance = (std::max)(1, IPcmSample::getHighValue(sp.type).getInt32() >> 12);
+		std::unique_ptr<IPcmSample> bankSample(createPcmSample(sp.type, bankBuffer.get(), bufferSize));
+		std::unique_ptr<IPcmSample> oscillatorSample(createPcmSample(sp.type, oscillatorBuffer.get(), bufferSize));
+		for(size_t i = 0; i < bankSample->getSampleCount(); i++) {
+			ASSERT_NEAR((*oscillatorSample)[i].getInt32(), (*bankSample)[i].getInt32(), tolerance) << sp.name << ": Sample[" << i << "]";
+		}
+	}
+}
+
+// Planar samples of oscillator bank should be same as interleaved samples.
+TEST(OscillatorBankUnitTest, copyToPlanar)
+{
+	static const WORD channels = 3;
+	static const size_t frames = 5000;
+
+	std::vector<IPcmData::ToneParameter> tones;
+	for(int i = 0; i < 100; i++) {
+		tones.push_back({ 100.0f + (i * 37.5f), 0.01f, i * 0.01f, IPcmData::WaveFormType::Unknown, 0 });
+	}
+
+	auto interleaved = createPcmData(48000, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_32bits), IPcmData::SynthesisMode::OscillatorBank);
+	auto planar = createPcmData(48000, channels, createSineWaveGenerator(IPcmData::SampleDataType::PCM_32bits), IPcmData::SynthesisMode::OscillatorBank);
+	ASSERT_HRESULT_SUCCEEDED(interleaved->generateTones(tones.data(), tones.size()));
+	ASSERT_HRESULT_SUCCEEDED(planar->generateTones(tones.data(), tones.size()));
+
+	std::vector<INT32> samples(frames * channels);
+	ASSERT_HRESULT_SUCCEEDED(interleaved->copyTo(samples.data(), samples.size() * sizeof(INT32)));
+	std::vector<INT32> buffers[channels];
+	void* channelBuffers[channels];
+	for(WORD channel = 0; channel < channels; channel++) {
+		buffers[channel].resize(frames);
+		channelBuffers[channel] = buffers[channel].data();
+	}
+	ASSERT_HRESULT_SUCCEEDED(planar->copyToPlanar(channelBuffers, frames));
+	for(size_t frame = 0; frame < frames; frame++) {
+		for(WORD channel = 0; channel < channels; channel++) {
+			ASSERT_EQ(samples[(frame * channels) + channel], buffers[channel][frame]) << "Frame[" << frame << "]";
+		}
+	}
+}
+
+// generateTones() is available in oscillator bank only, up to MaxTones tones.
+TEST(OscillatorBankUnitTest, error)
+{
+	const IPcmData::ToneParameter tone = { 440, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 };
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		auto pcmData = createPcmData(44100, 2, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), synthesisMode);
+		EXPECT_EQ(E_NOTIMPL, pcmData->generateTones(&tone, 1));
+	}
+
+	auto pcmData = createPcmData(44100, 2, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), IPcmData::SynthesisMode::OscillatorBank);
+	INT16 buffer[4];
+	EXPECT_EQ(E_ILLEGAL_METHOD_CALL, pcmData->copyTo(buffer, sizeof(buffer)));
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateChannels(&tone));
+	EXPECT_EQ(E_POINTER, pcmData->generateTones(nullptr, 1));
+	EXPECT_EQ(E_INVALIDARG, pcmData->generateTones(&tone, 0));
+	std::vector<IPcmData::ToneParameter> tones(IPcmData::MaxTones + 1, tone);
+	EXPECT_EQ(E_INVALIDARG, pcmData->generateTones(tones.data(), tones.size()));
+	EXPECT_HRESULT_SUCCEEDED(pcmData->generateTones(tones.data(), IPcmData::MaxTones));
+	tones[1].waveFormType = (IPcmData::WaveFormType)100;
+	EXPECT_EQ(E_INVALIDARG, pcmData->generateTones(tones.data(), 2));
+	EXPECT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer, sizeof(buffer)));
+}
+
+// Amplitude of the frequency in the samples, calculated by DFT of single bin.
+static double getAmplitude(const float* samples, size_t frames, WORD channels, DWORD samplesPerSec, double frequency)
+{
+	static const double pi = 3.14159265358979323846;
+	double re = 0, im = 0;
+	for(size_t frame = 0; frame < frames; frame++) {
+		auto theta = 2 * pi * frequency * frame / samplesPerSec;
+		re += samples[frame * channels] * cos(theta);
+		im += samples[frame * channels] * sin(theta);
+	}
+	return 2 * sqrt((re * re) + (im * im)) / frames;
+}
+
+// Each digit should consist of it's 2 frequencies at half of the height(HighValue of float sample is 0.8).
+TEST(DualToneUnitTest, frequency)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t toneMilliseconds = 100;
+	static const size_t frames = samplesPerSec * toneMilliseconds / 1000;
+
+	struct Digit { IPcmData::WaveFormType type; char digit; double low; double high; };
+	static const Digit digits[] = {
+		{ IPcmData::WaveFormType::DTMF, '1', 697, 1209 },
+		{ IPcmData::WaveFormType::DTMF, '5', 770, 1336 },
+		{ IPcmData::WaveFormType::DTMF, '#', 941, 1477 },
+		{ IPcmData::WaveFormType::DTMF, 'c', 852, 1633 },
+		{ IPcmData::WaveFormType::MF, '0', 1300, 1500 },
+		{ IPcmData::WaveFormType::MF, 'K', 1100, 1700 },
+	};
+	static const double dtmfFrequencies[] = { 697, 770, 852, 941, 1209, 1336, 1477, 1633 };
+	static const double mfFrequencies[] = { 700, 900, 1100, 1300, 1500, 1700 };
+
+	for(auto& digit : digits) {
+		auto& wp = PcmDataEnumerator::getWaveFormProperty(digit.type);
+		auto pcmData = createPcmData(samplesPerSec, channels, wp.factory(IPcmData::SampleDataType::IEEE_Float, wp.defaultParameter));
+		ASSERT_THAT(pcmData, NotNull());
+		const char str[] = { digit.digit, '\0' };
+		ASSERT_HRESULT_SUCCEEDED(pcmData->generateDigits(str, toneMilliseconds, 0, 1.0f));
+		EXPECT_EQ(frames * channels * sizeof(float), pcmData->getSampleBufferSize(0));
+		EXPECT_EQ(0, pcmData->getFrequencyError());
+
+		std::vector<float> samples(frames * channels);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(float)));
+		auto isDtmf = (digit.type == IPcmData::WaveFormType::DTMF);
+		auto frequencies = isDtmf ? dtmfFrequencies : mfFrequencies;
+		auto count = isDtmf ? ARRAYSIZE(dtmfFrequencies) : ARRAYSIZE(mfFrequencies);
+		for(size_t i = 0; i < count; i++) {
+			auto amplitude = getAmplitude(samples.data(), frames, channels, samplesPerSec, frequencies[i]);
+			if((frequencies[i] == digit.low) || (frequencies[i] == digit.high)) {
+				EXPECT_NEAR(0.4, amplitude, 0.01) << wp.name << ": " << digit.digit << ": " << frequencies[i] << "Hz";
+			} else {
+				EXPECT_GT(0.05, amplitude) << wp.name << ": " << digit.digit << ": " << frequencies[i] << "Hz";
+			}
+		}
+	}
+}
+
+// Script of digits should have tone, pause and ',' at their length, and be repeated.
+TEST(DualToneUnitTest, script)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const size_t toneFrames = 2400;		// 50 mSec
+	static const size_t pauseFrames = 1440;		// 30 mSec
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createDtmfWaveGenerator(sp.type));
+		ASSERT_THAT(pcmData, NotNull());
+		ASSERT_HRESULT_SUCCEEDED(pcmData->generateDigits("1,2", 50, 30, 1.0f));
+		const size_t frames = toneFrames + pauseFrames + (toneFrames + pauseFrames) + toneFrames + pauseFrames;
+		auto bufferSize = pcmData->getSampleBufferSize(0);
+		ASSERT_EQ(frames * pcmData->getBlockAlign(), bufferSize);
+		EXPECT_THAT(createPcmSample(pcmData), IsNull());
+
+		// Copy 2 scripts in pieces.
+		std::vector<BYTE> buffer(bufferSize * 2);
+		auto blockAlign = pcmData->getBlockAlign();
+		for(size_t offset = 0; offset < buffer.size(); offset += blockAlign * 1001) {
+			auto size = (std::min)(buffer.size() - offset, (size_t)blockAlign * 1001);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&buffer[offset], size));
+		}
+		ASSERT_EQ(0, memcmp(buffer.data(), &buffer[bufferSize], bufferSize)) << sp.name;
+
+		std::unique_ptr<IPcmSample> sample(createPcmSample(sp.type, buffer.data(), bufferSize));
+		auto zero = IPcmSample::getZeroValue(sp.type).getInt32();
+		auto isSilent = [&](size_t start, size_t count) {
+			for(size_t i = start * channels; i < (start + count) * channels; i++) {
+				if((*sample)[i].getInt32() != zero) { return false; }
+			}
+			return true;
+		};
+		EXPECT_FALSE(isSilent(0, toneFrames)) << sp.name;
+		EXPECT_TRUE(isSilent(toneFrames, pauseFrames + toneFrames + pauseFrames)) << sp.name;
+		EXPECT_FALSE(isSilent(frames - toneFrames - pauseFrames, toneFrames)) << sp.name;
+		EXPECT_TRUE(isSilent(frames - pauseFrames, pauseFrames)) << sp.name;
+	}
+}
+
+// generate() should generate continuous tone of the digit passed to the factory.
+TEST(DualToneUnitTest, generate)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 1;
+
+	auto digits = PcmDataEnumerator::getDigits(IPcmData::WaveFormType::DTMF);
+	auto digit = strchr(digits, '9') - digits;
+	auto continuous = createPcmData(samplesPerSec, channels, createDtmfWaveGenerator(IPcmData::SampleDataType::IEEE_Float, (float)digit));
+	auto script = createPcmData(samplesPerSec, channels, createDtmfWaveGenerator(IPcmData::SampleDataType::IEEE_Float));
+	continuous->generate(440, 1.0f);
+	ASSERT_HRESULT_SUCCEEDED(script->generateDigits("9", 1000, 0, 1.0f));
+	EXPECT_EQ(IPcmData::SynthesisMode::Stream, continuous->getSynthesisMode());
+	EXPECT_EQ(0, continuous->getFrequencyError());
+
+	// Continuous tone should be same as a digit of 1 second, in every second.
+	std::vector<float> expected(samplesPerSec), actual(samplesPerSec);
+	ASSERT_HRESULT_SUCCEEDED(script->copyTo(expected.data(), expected.size() * sizeof(float)));
+	for(int i = 0; i < 3; i++) {
+		ASSERT_HRESULT_SUCCEEDED(continuous->copyTo(actual.data(), actual.size() * sizeof(float)));
+		ASSERT_EQ(0, memcmp(expected.data(), actual.data(), expected.size() * sizeof(float))) << i;
+	}
+
+	// Level passed to generateDigits() should be applied to the script.
+	ASSERT_HRESULT_SUCCEEDED(script->generateDigits("9", 1000, 0, 0.5f));
+	ASSERT_HRESULT_SUCCEEDED(script->copyTo(actual.data(), actual.size() * sizeof(float)));
+	for(size_t i = 0; i < actual.size(); i++) {
+		ASSERT_FLOAT_EQ(expected[i] * 0.5f, actual[i]) << i;
+	}
+}
+
+// generateDigits() is available for DTMF and MF only, and accepts digits of the signalling.
+TEST(DualToneUnitTest, error)
+{
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator, IPcmData::SynthesisMode::OscillatorBank }) {
+		auto pcmData = createPcmData(44100, 2, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), synthesisMode);
+		EXPECT_EQ(E_NOTIMPL, pcmData->generateDigits("123"));
+	}
+
+	auto dtmf = createPcmData(44100, 2, createDtmfWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	INT16 buffer[4];
+	EXPECT_EQ(E_ILLEGAL_METHOD_CALL, dtmf->copyTo(buffer, sizeof(buffer)));
+	EXPECT_EQ(E_POINTER, dtmf->generateDigits(nullptr));
+	EXPECT_EQ(E_INVALIDARG, dtmf->generateDigits(""));
+	EXPECT_EQ(E_INVALIDARG, dtmf->generateDigits("12X"));
+	EXPECT_EQ(E_INVALIDARG, dtmf->generateDigits("123", 0, 10));
+	EXPECT_HRESULT_SUCCEEDED(dtmf->generateDigits("0123456789*#ABCD,abcd", 40, 0));
+	EXPECT_HRESULT_SUCCEEDED(dtmf->copyTo(buffer, sizeof(buffer)));
+
+	auto mf = createPcmData(44100, 2, createMfWaveGenerator(IPcmData::SampleDataType::PCM_16bits));
+	EXPECT_EQ(E_INVALIDARG, mf->generateDigits("K123*S"));
+	EXPECT_HRESULT_SUCCEEDED(mf->generateDigits("K0123456789S,ABC"));
+}
+
+// Sweep should be sine wave of the analytic phase of linear and logarithmic law.
+TEST(SweepUnitTest, phase)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const double pi = 3.14159265358979323846;
+	static const double startKey = 20;
+	static const double endKey = 20000;
+	static const size_t frames = samplesPerSec * 2;
+
+	for(auto law : { IPcmData::SweepLaw::Linear, IPcmData::SweepLaw::Logarithmic }) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::IEEE_Float), IPcmData::SynthesisMode::Sweep);
+		ASSERT_THAT(pcmData, NotNull());
+		ASSERT_HRESULT_SUCCEEDED(pcmData->generateSweep((float)startKey, (float)endKey, 2000, law, 1.0f));
+		EXPECT_EQ(IPcmData::SynthesisMode::Sweep, pcmData->getSynthesisMode());
+		ASSERT_EQ(frames * channels * sizeof(float), pcmData->getSampleBufferSize(0));
+		EXPECT_THAT(createPcmSample(pcmData), IsNull());
+
+		std::vector<float> samples(frames * channels);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), samples.size() * sizeof(float)));
+
+		// HighValue of float sample is 0.8.
+		auto length = frames / log(endKey / startKey);
+		for(size_t frame = 0; frame < frames; frame++) {
+			auto t = (double)frame;
+			auto phase = (law == IPcmData::SweepLaw::Linear) ?
+				((startKey * t) + ((endKey - startKey) / (2.0 * frames) * t * t)) / samplesPerSec :
+				startKey * length * expm1(t / length) / samplesPerSec;
+			auto expected = 0.8 * sin(2 * pi * (phase - floor(phase)));
+			ASSERT_NEAR(expected, samples[frame * channels], 1e-4) << "Law=" << (int)law << ", Frame[" << frame << "]";
+			ASSERT_EQ(samples[frame * channels], samples[(frame * channels) + 1]) << "Frame[" << frame << "]";
+		}
+	}
+}
+
+// Sweep should be repeated, and be same regardless of how samples are split into copyTo() calls.
+TEST(SweepUnitTest, repeat)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 3;
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type), IPcmData::SynthesisMode::Sweep);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->generateSweep(1000, 100, 333, IPcmData::SweepLaw::Logarithmic, 1.0f));
+		auto bufferSize = pcmData->getSampleBufferSize(0);
+		auto blockAlign = pcmData->getBlockAlign();
+		ASSERT_EQ(samplesPerSec * 333 / 1000 * blockAlign, bufferSize);
+
+		std::vector<BYTE> whole(bufferSize), pieces(bufferSize * 2);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(whole.data(), bufferSize));
+		ASSERT_HRESULT_SUCCEEDED(pcmData->generateSweep(1000, 100, 333, IPcmData::SweepLaw::Logarithmic, 1.0f));
+		for(size_t offset = 0; offset < pieces.size(); offset += blockAlign * 1001) {
+			auto size = (std::min)(pieces.size() - offset, (size_t)blockAlign * 1001);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&pieces[offset], size));
+		}
+		ASSERT_EQ(0, memcmp(whole.data(), pieces.data(), bufferSize)) << sp.name;
+		ASSERT_EQ(0, memcmp(whole.data(), &pieces[bufferSize], bufferSize)) << sp.name;
+	}
+}
+
+// Sweep of any length should be synthesized in constant memory.
+// generate() should generate sine wave of the key that does not end.
+TEST(SweepUnitTest, length)
+{
+	auto pcmData = createPcmData(192000, 2, createSineWaveGenerator(IPcmData::SampleDataType::PCM_24bits), IPcmData::SynthesisMode::Sweep);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->generateSweep(20, 20000, 1000));
+	auto cycleDataSize = pcmData->getCycleDataSize();
+	ASSERT_HRESULT_SUCCEEDED(pcmData->generateSweep(20, 20000, 10 * 60 * 1000));
+	EXPECT_EQ(cycleDataSize, pcmData->getCycleDataSize());
+	EXPECT_EQ((size_t)192000 * 10 * 60 * pcmData->getBlockAlign(), pcmData->getSampleBufferSize(0));
+
+	pcmData->generate(1000, 1.0f);
+	EXPECT_EQ(192 * 2, pcmData->getSamplesPerCycle());
+	EXPECT_EQ(0, pcmData->getFrequencyError());
+	auto bufferSize = pcmData->getSampleBufferSize(1000);
+	auto first = std::make_unique<BYTE[]>(bufferSize);
+	auto next = std::make_unique<BYTE[]>(bufferSize);
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(first.get(), bufferSize));
+	ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(next.get(), bufferSize));
+	std::unique_ptr<IPcmSample> firstSample(createPcmSample(IPcmData::SampleDataType::PCM_24bits, first.get(), bufferSize));
+	std::unique_ptr<IPcmSample> nextSample(createPcmSample(IPcmData::SampleDataType::PCM_24bits, next.get(), bufferSize));
+	for(size_t i = 0; i < firstSample->getSampleCount(); i++) {
+		ASSERT_NEAR((*firstSample)[i].getInt32(), (*nextSample)[i].getInt32(), 0x10) << "Sample[" << i << "]";
+	}
+}
+
+// generateSweep() is available in SynthesisMode::Sweep only, and accepts keys up to Nyquist frequency.
+TEST(SweepUnitTest, error)
+{
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator, IPcmData::SynthesisMode::OscillatorBank }) {
+		auto pcmData = createPcmData(44100, 2, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), synthesisMode);
+		EXPECT_EQ(E_NOTIMPL, pcmData->generateSweep(20, 20000, 1000));
+	}
+
+	auto pcmData = createPcmData(44100, 2, createSineWaveGenerator(IPcmData::SampleDataType::PCM_16bits), IPcmData::SynthesisMode::Sweep);
+	INT16 buffer[4];
+	EXPECT_EQ(E_ILLEGAL_METHOD_CALL, pcmData->copyTo(buffer, sizeof(buffer)));
+	const IPcmData::ToneParameter tone = { 440, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 };
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateChannels(&tone));
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateTones(&tone, 1));
+	EXPECT_EQ(E_INVALIDARG, pcmData->generateSweep(0, 20000, 1000));
+	EXPECT_EQ(E_INVALIDARG, pcmData->generateSweep(20, 22051, 1000));
+	EXPECT_EQ(E_INVALIDARG, pcmData->generateSweep(20, 20000, 0));
+	EXPECT_HRESULT_SUCCEEDED(pcmData->generateSweep(22050, 20, 1000, IPcmData::SweepLaw::Linear));
+	EXPECT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer, sizeof(buffer)));
+}
+
+// Noise should be reproduced from the seed regardless of how samples are split into copyTo() calls,
+// and should be different for another seed and each channel.
+TEST(NoiseUnitTest, reproducible)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+	static const size_t frames = 10000;
+
+	for(auto& wp : { PcmDataEnumerator::getWaveFormProperty(IPcmData::WaveFormType::WhiteNoise), PcmDataEnumerator::getWaveFormProperty(IPcmData::WaveFormType::PinkNoise) }) {
+		auto pcmData = createPcmData(samplesPerSec, channels, wp.factory(IPcmData::SampleDataType::IEEE_Float, 123));
+		ASSERT_THAT(pcmData, NotNull());
+		EXPECT_EQ(wp.type, pcmData->getWaveFormType());
+		EXPECT_EQ(IPcmData::SynthesisMode::Stream, pcmData->getSynthesisMode());
+		pcmData->generate(440, 1.0f);
+		EXPECT_THAT(createPcmSample(pcmData), IsNull());
+
+		std::vector<float> whole(frames * channels), pieces(frames * channels), another(frames * channels);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(whole.data(), whole.size() * sizeof(float)));
+		// generate() restarts the stream.
+		pcmData->generate(1000, 1.0f);
+		for(size_t frame = 0; frame < frames; frame += 777) {
+			auto count = (std::min)(frames - frame, (size_t)777);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(&pieces[frame * channels], count * channels * sizeof(float)));
+		}
+		ASSERT_EQ(0, memcmp(whole.data(), pieces.data(), whole.size() * sizeof(float))) << wp.name;
+
+		auto seed124 = createPcmData(samplesPerSec, channels, wp.factory(IPcmData::SampleDataType::IEEE_Float, 124));
+		seed124->generate(440, 1.0f);
+		ASSERT_HRESULT_SUCCEEDED(seed124->copyTo(another.data(), another.size() * sizeof(float)));
+		size_t sameSeed = 0, sameChannel = 0;
+		for(size_t frame = 0; frame < frames; frame++) {
+			if(whole[frame * channels] == another[frame * channels]) { sameSeed++; }
+			if(whole[frame * channels] == whole[(frame * channels) + 1]) { sameChannel++; }
+		}
+		EXPECT_GT(frames / 100, sameSeed) << wp.name;
+		EXPECT_GT(frames / 100, sameChannel) << wp.name;
+	}
+}
+
+// White noise should be uniform distribution of -1.0 ~ +1.0 with no correlation between adjacent samples.
+// Pink noise should have more power in low frequency, that makes mean of a block vary more than white noise.
+TEST(NoiseUnitTest, statistics)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const size_t frames = samplesPerSec * 4;
+	static const size_t blockFrames = 1024;
+
+	struct Statistics { double mean; double rms; double correlation; double blockMeanVariance; };
+	auto measure = [](IWaveGenerator* generator) {
+		auto pcmData = createPcmData(samplesPerSec, 1, generator);
+		pcmData->generate(1000, 1.0f);
+		std::vector<float> samples(frames);
+		pcmData->copyTo(samples.data(), frames * sizeof(float));
+		Statistics s = {};
+		double power = 0, lag = 0, blockMean = 0;
+		for(size_t i = 0; i < frames; i++) {
+			// HighValue of float sample is 0.8.
+			auto value = samples[i] / 0.8;
+			s.mean += value;
+			power += value * value;
+			if(i) { lag += value * samples[i - 1] / 0.8; }
+			blockMean += value;
+			if((i % blockFrames) == (blockFrames - 1)) {
+				s.blockMeanVariance += (blockMean / blockFrames) * (blockMean / blockFrames);
+				blockMean = 0;
+			}
+		}
+		s.mean /= frames;
+		s.rms = sqrt(power / frames);
+		s.correlation = lag / power;
+		s.blockMeanVariance /= (frames / blockFrames);
+		return s;
+	};
+
+	auto white = measure(createWhiteNoiseGenerator(IPcmData::SampleDataType::IEEE_Float));
+	EXPECT_NEAR(0, white.mean, 0.01);
+	EXPECT_NEAR(1 / sqrt(3.0), white.rms, 0.01);
+	EXPECT_NEAR(0, white.correlation, 0.01);
+
+	auto pink = measure(createPinkNoiseGenerator(IPcmData::SampleDataType::IEEE_Float));
+	EXPECT_NEAR(0, pink.mean, 0.05);
+	EXPECT_LT(0.1, pink.correlation);
+	EXPECT_LT(white.blockMeanVariance * 10, pink.blockMeanVariance);
+	std::cout << "White: RMS=" << white.rms << ", Block mean variance=" << white.blockMeanVariance
+		<< "\nPink: RMS=" << pink.rms << ", Correlation=" << pink.correlation << ", Block mean variance=" << pink.blockMeanVariance << std::endl;
+}
+
+// Noise is synthesized in any synthesis mode and of any sample data type, and never clips.
+TEST(NoiseUnitTest, sampleDataType)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 3;
+
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator, IPcmData::SynthesisMode::Sweep }) {
+			auto pcmData = createPcmData(samplesPerSec, channels, createPinkNoiseGenerator(sp.type), synthesisMode);
+			ASSERT_THAT(pcmData, NotNull());
+			pcmData->generate(100, 1.0f);
+			EXPECT_EQ(samplesPerSec / 100 * channels, pcmData->getSamplesPerCycle());
+			EXPECT_EQ(0, pcmData->getFrequencyError());
+			auto bufferSize = pcmData->getSampleBufferSize(100);
+			auto buffer = std::make_unique<BYTE[]>(bufferSize);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.get(), bufferSize));
+			std::unique_ptr<IPcmSample> pcmSample(createPcmSample(sp.type, buffer.get(), bufferSize));
+			for(size_t i = 0; i < pcmSample->getSampleCount(); i++) {
+				double value = (*pcmSample)[i];
+				ASSERT_LE((double)IPcmSample::getLowValue(sp.type), value) << sp.name << ": Sample[" << i << "]";
+				ASSERT_GE((double)IPcmSample::getHighValue(sp.type), value) << sp.name << ": Sample[" << i << "]";
+			}
+		}
+	}
+}
+
+// copyTo() fails before the noise is generated.
+TEST(NoiseUnitTest, error)
+{
+	auto pcmData = createPcmData(44100, 2, createWhiteNoiseGenerator(IPcmData::SampleDataType::PCM_16bits));
+	INT16 buffer[4];
+	EXPECT_EQ(E_ILLEGAL_METHOD_CALL, pcmData->copyTo(buffer, sizeof(buffer)));
+	const IPcmData::ToneParameter tone = { 440, 1.0f, 0, IPcmData::WaveFormType::Unknown, 0 };
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateChannels(&tone));
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateTones(&tone, 1));
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateSweep(20, 20000, 1000));
+	EXPECT_EQ(E_NOTIMPL, pcmData->generateDigits("1"));
+	pcmData->generate(440);
+	EXPECT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer, sizeof(buffer)));
+}
+
+// Sequence of each order should have all non-zero states of order bits once in a period,
+// and circular autocorrelation should be length at lag 0 and -1 at other lags.
+TEST(MlsUnitTest, sequence)
+{
+	for(int order = MaximumLengthSequence::MinOrder; order <= 20; order++) {
+		MaximumLengthSequence mls(order);
+		auto length = mls.getLength();
+		ASSERT_EQ(((size_t)1 << order) - 1, length);
+
+		std::vector<bool> states((size_t)1 << order);
+		size_t state = 0;
+		for(int t = 0; t < order; t++) { state |= (size_t)mls.getBit(t) << t; }
+		for(size_t n = 0; n < length; n++) {
+			ASSERT_NE(0, state) << "Order=" << order << ", n=" << n;
+			ASSERT_FALSE(states[state]) << "Order=" << order << ", n=" << n;
+			states[state] = true;
+			state = (state >> 1) | ((size_t)mls.getBit((n + order) % length) << (order - 1));
+		}
+
+		if(order <= 10) {
+			std::vector<float> samples(length);
+			mls.generate(samples.data(), length, 0, 1.0f);
+			for(size_t lag = 0; lag < length; lag++) {
+				double correlation = 0;
+				for(size_t n = 0; n < length; n++) { correlation += samples[n] * samples[(n + lag) % length]; }
+				ASSERT_EQ(lag ? -1.0 : (double)length, correlation) << "Order=" << order << ", Lag=" << lag;
+			}
+		}
+	}
+
+	// Order out of range is limited.
+	EXPECT_EQ((int)MaximumLengthSequence::MinOrder, MaximumLengthSequence(0).getOrder());
+	EXPECT_EQ((int)MaximumLengthSequence::MaxOrder, MaximumLengthSequence(100).getOrder());
+}
+
+// Impulse response should be recovered from circular convolution of the sequence and the impulse response.
+TEST(MlsUnitTest, analyze)
+{
+	static const float impulseResponse[] = { 0.5f, 0, -0.25f, 0.125f, 0, 0, 0.0625f, -0.03125f, 0.01f };
+
+	for(int order : { 4, 8, 12, 16 }) {
+		MaximumLengthSequence mls(order);
+		auto length = mls.getLength();
+		std::vector<float> sequence(length), response(length);
+		mls.generate(sequence.data(), length, 0, 1.0f);
+		for(size_t n = 0; n < length; n++) {
+			double sum = 0;
+			for(size_t k = 0; k < ARRAYSIZE(impulseResponse); k++) {
+				sum += impulseResponse[k] * sequence[(n + length - (k % length)) % length];
+			}
+			response[n] = (float)sum;
+		}
+
+		std::vector<float> actual(length);
+		ASSERT_HRESULT_SUCCEEDED(mls.analyze(actual.data(), response.data()));
+		for(size_t k = 0; k < length; k++) {
+			// Impulse response longer than the sequence is aliased.
+			double expected = 0;
+			for(size_t i = k; i < ARRAYSIZE(impulseResponse); i += length) { expected += impulseResponse[i]; }
+			ASSERT_NEAR(expected, actual[k], 1e-5) << "Order=" << order << ", k=" << k;
+		}
+
+		// Analyzed in place.
+		ASSERT_HRESULT_SUCCEEDED(mls.analyze(response.data(), response.data()));
+		ASSERT_EQ(actual, response) << "Order=" << order;
+	}
+
+	EXPECT_EQ(E_POINTER, MaximumLengthSequence(4).analyze(nullptr, nullptr));
+}
+
+// PcmData of MLS should copy 1 period of the sequence as cycle data regardless of key and synthesis mode.
+TEST(MlsUnitTest, pcmData)
+{
+	static const DWORD samplesPerSec = 48000;
+	static const WORD channels = 2;
+	static const int order = 10;
+
+	MaximumLengthSequence mls(order);
+	auto length = mls.getLength();
+	for(auto synthesisMode : { IPcmData::SynthesisMode::CycleTable, IPcmData::SynthesisMode::Oscillator }) {
+		auto pcmData = createPcmData(samplesPerSec, channels, createMlsWaveGenerator(IPcmData::SampleDataType::PCM_16bits, order), synthesisMode);
+		ASSERT_THAT(pcmData, NotNull());
+		EXPECT_EQ(IPcmData::WaveFormType::MLS, pcmData->getWaveFormType());
+		pcmData->generate(440, 1.0f);
+		EXPECT_EQ(IPcmData::SynthesisMode::CycleTable, pcmData->getSynthesisMode());
+		EXPECT_EQ(length * channels, pcmData->getSamplesPerCycle());
+		EXPECT_EQ(1, pcmData->getCycles());
+		EXPECT_NEAR(0, pcmData->getFrequencyError(), 1e-3);
+
+		std::unique_ptr<IPcmSample> pcmSample(createPcmSample(pcmData));
+		ASSERT_THAT(pcmSample, NotNull());
+		for(size_t n = 0; n < length; n++) {
+			for(WORD channel = 0; channel < channels; channel++) {
+				ASSERT_EQ(mls.getBit(n) ? -(INT32)IPcmSample::HighValue<INT16> : (INT32)IPcmSample::HighValue<INT16>,
+							(INT32)(*pcmSample)[(n * channels) + channel]) << "Frame[" << n << "]";
+			}
+		}
+
+		// Sequence is repeated.
+		auto periodSize = pcmData->getSampleBufferSize(0);
+		std::vector<BYTE> buffer(periodSize * 3);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(buffer.data(), buffer.size()));
+		EXPECT_EQ(0, memcmp(buffer.data(), &buffer[periodSize], periodSize));
+		EXPECT_EQ(0, memcmp(buffer.data(), &buffer[periodSize * 2], periodSize));
+	}
+
+	const IPcmData::ToneParameter tones[channels] = {};
+	EXPECT_EQ(E_NOTIMPL, createPcmData(samplesPerSec, channels, createMlsWaveGenerator(IPcmData::SampleDataType::PCM_16bits))->generateChannels(tones));
+}
+
+// Returns power of the components that are not harmonics of the key(aliasing) relative to power of the harmonics,
+// in `frames` samples of exact period that contains `cycles` cycles.
+static double getAliasingRatio(const std::vector<float>& samples, size_t cycles)
+{
+	static const double pi = 3.14159265358979;
+
+	auto frames = samples.size();
+	double aliasing = 0, harmonics = 0;
+	for(size_t k = 1; k <= frames / 2; k++) {
+		double re = 0, im = 0;
+		for(size_t n = 0; n < frames; n++) {
+			auto phase = 2 * pi * ((k * n) % frames) / frames;
+			re += samples[n] * cos(phase);
+			im += samples[n] * sin(phase);
+		}
+		((k % cycles) ? aliasing : harmonics) += (re * re) + (im * im);
+	}
+	return aliasing / harmonics;
+}
+
+// Band-limited wave forms should have aliasing at least 13dB less than naive ones at high key,
+// without overshoot that clips integer samples.
+TEST(BandLimitedUnitTest, aliasing)
+{
+	static const DWORD samplesPerSec = 44100;
+	// 441 frames of exact period hold 31 cycles.
+	static const float key = 3100;
+	static const size_t frames = 441;
+	static const size_t cycles = 31;
+
+	struct Parameter { IPcmData::WaveFormType naive; IPcmData::WaveFormType bandLimited; float parameter; };
+	static const Parameter parameters[] = {
+		{ IPcmData::WaveFormType::SquareWave, IPcmData::WaveFormType::BandLimitedSquareWave, 0.5f },
+		{ IPcmData::WaveFormType::SquareWave, IPcmData::WaveFormType::BandLimitedSquareWave, 0.2f },
+		{ IPcmData::WaveFormType::TriangleWave, IPcmData::WaveFormType::BandLimitedTriangleWave, 0.25f },
+		{ IPcmData::WaveFormType::TriangleWave, IPcmData::WaveFormType::BandLimitedTriangleWave, 0.8f },
+		{ IPcmData::WaveFormType::TriangleWave, IPcmData::WaveFormType::BandLimitedTriangleWave, 0.0f },
+		{ IPcmData::WaveFormType::TriangleWave, IPcmData::WaveFormType::BandLimitedTriangleWave, 0.5f },
+		{ IPcmData::WaveFormType::TriangleWave, IPcmData::WaveFormType::BandLimitedTriangleWave, 1.0f },
+	};
+
+	for(auto& p : parameters) {
+		double ratio[2];
+		for(auto type : { p.naive, p.bandLimited }) {
+			auto& wp = PcmDataEnumerator::getWaveFormProperty(type);
+			auto pcmData = createPcmData(samplesPerSec, 1, wp.factory(IPcmData::SampleDataType::IEEE_Float, p.parameter));
+			EXPECT_EQ(type, pcmData->getWaveFormType());
+			ASSERT_HRESULT_SUCCEEDED(pcmData->setExactPeriod());
+			pcmData->generate(key, 1.0f);
+			ASSERT_EQ(frames, pcmData->getSamplesPerCycle());
+			ASSERT_EQ(cycles, pcmData->getCycles());
+
+			std::vector<float> samples(frames);
+			ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), frames * sizeof(float)));
+			ratio[type == p.bandLimited] = getAliasingRatio(samples, cycles);
+			// HighValue of float sample is 0.8.
+			for(auto value : samples) { ASSERT_GE(0.8f, fabs(value)) << wp.name << "(" << p.parameter << ")"; }
+		}
+		EXPECT_LT(ratio[1] * 20, ratio[0]) << PcmDataEnumerator::getWaveFormProperty(p.naive).name << "(" << p.parameter << ")";
+		std::cout << PcmDataEnumerator::getWaveFormProperty(p.naive).name << "(" << p.parameter << "): Aliasing "
+			<< (10 * log10(ratio[0])) << "dB -> " << (10 * log10(ratio[1])) << "dB" << std::endl;
+	}
+}
+
+// Oscillators of the same wave form should share tables of WaveTableCache,
+// and band-limited wave form should have mip levels of octave-spaced harmonics.
+TEST(WaveTableCacheUnitTest, shared)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const size_t tableBytes = (WaveTableCache::TableSize + 1) * sizeof(float);
+
+	EXPECT_EQ(WaveTableCache::TableSize / 2 - 1, WaveTableCache::getHarmonics(0));
+	EXPECT_EQ(WaveTableCache::TableSize / 4, WaveTableCache::getHarmonics(1));
+	EXPECT_EQ(1, WaveTableCache::getHarmonics(WaveTableCache::Levels - 1));
+	EXPECT_EQ(0, WaveTableCache::getLevel(20, samplesPerSec));
+	// 32 harmonics of 440Hz do not exceed 22050Hz, while 64 harmonics do.
+	EXPECT_EQ(5, WaveTableCache::getLevel(440, samplesPerSec));
+	EXPECT_EQ(WaveTableCache::Levels - 1, WaveTableCache::getLevel(20000, samplesPerSec));
+
+	auto& cache = WaveTableCache::getInstance();
+	cache.clear();
+	std::vector<std::shared_ptr<IPcmData>> pcmData;
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		pcmData.push_back(createPcmData(samplesPerSec, 2, createBandLimitedSquareWaveGenerator(sp.type), IPcmData::SynthesisMode::Oscillator));
+		pcmData.back()->generate(440);
+		EXPECT_EQ(tableBytes * WaveTableCache::Levels, pcmData.back()->getCycleDataSize()) << sp.name;
+	}
+	auto statistics = cache.getStatistics();
+	EXPECT_EQ(1, statistics.misses);
+	EXPECT_EQ(pcmData.size() - 1, statistics.hits);
+	EXPECT_EQ(1, statistics.entries);
+	EXPECT_EQ(tableBytes * WaveTableCache::Levels, statistics.bytes);
+
+	// Wave form that is not band-limited has 1 table. Another duty is another entry.
+	pcmData.push_back(createPcmData(samplesPerSec, 2, createSquareWaveGenerator(IPcmData::SampleDataType::PCM_16bits), IPcmData::SynthesisMode::Oscillator));
+	pcmData.back()->generate(440);
+	pcmData.push_back(createPcmData(samplesPerSec, 2, createBandLimitedSquareWaveGenerator(IPcmData::SampleDataType::PCM_16bits, 0.25f), IPcmData::SynthesisMode::Oscillator));
+	pcmData.back()->generate(440);
+	statistics = cache.getStatistics();
+	EXPECT_EQ(3, statistics.misses);
+	EXPECT_EQ(3, statistics.entries);
+	EXPECT_EQ(tableBytes * ((WaveTableCache::Levels * 2) + 1), statistics.bytes);
+	cache.clear();
+}
+
+// Cycle data of the same wave form and key should be generated from the master shared through WaveTableCache
+// for any sample data type, while another key has another master.
+TEST(WaveTableCacheUnitTest, cycleData)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const WORD channels = 2;
+
+	auto& cache = WaveTableCache::getInstance();
+	cache.clear();
+	std::vector<std::shared_ptr<IPcmData>> pcmData;
+	for(auto& sp : PcmDataEnumerator::getSampleDatatypeProperties()) {
+		pcmData.push_back(createPcmData(samplesPerSec, channels, createSineWaveGenerator(sp.type)));
+		pcmData.back()->generate(440);
+	}
+	auto frames = pcmData[0]->getSamplesPerCycle() / channels;
+	auto statistics = cache.getStatistics();
+	EXPECT_EQ(1, statistics.misses);
+	EXPECT_EQ(pcmData.size() - 1, statistics.hits);
+	EXPECT_EQ(1, statistics.entries);
+	EXPECT_EQ(frames * sizeof(float), statistics.bytes);
+
+	// Master of the key is not changed by another object.
+	std::vector<float> expected(frames * channels), actual(frames * channels);
+	auto reference = createPcmData(samplesPerSec, channels, createSineWaveGenerator(IPcmData::SampleDataType::IEEE_Float));
+	reference->generate(440);
+	ASSERT_HRESULT_SUCCEEDED(reference->copyTo(expected.data(), expected.size() * sizeof(float)));
+	pcmData[0]->generate(880);
+	reference->generate(440);
+	ASSERT_HRESULT_SUCCEEDED(reference->copyTo(actual.data(), actual.size() * sizeof(float)));
+	EXPECT_EQ(expected, actual);
+	statistics = cache.getStatistics();
+	EXPECT_EQ(2, statistics.misses);
+	EXPECT_EQ(pcmData.size() + 1, statistics.hits);
+	EXPECT_EQ(2, statistics.entries);
+	cache.clear();
+}
+
+// Oscillator should release wave tables that are not used by any channel after generate() or generateChannels().
+TEST(WaveTableCacheUnitTest, released)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const size_t tableBytes = (WaveTableCache::TableSize + 1) * sizeof(float);
+
+	auto pcmData = createPcmData(samplesPerSec, 2, createSquareWaveGenerator(IPcmData::SampleDataType::PCM_16bits), IPcmData::SynthesisMode::Oscillator);
+	pcmData->generate(440);
+	EXPECT_EQ(tableBytes, pcmData->getCycleDataSize());
+
+	// Each channel has another wave form.
+	IPcmData::ToneParameter channels[] = {
+		{ 440, 1.0f, 0, IPcmData::WaveFormType::SineWave, 0 },
+		{ 440, 1.0f, 0, IPcmData::WaveFormType::BandLimitedSquareWave, 0.5f },
+	};
+	ASSERT_HRESULT_SUCCEEDED(pcmData->generateChannels(channels));
+	EXPECT_EQ(tableBytes * (WaveTableCache::Levels + 1), pcmData->getCycleDataSize());
+
+	// Sine wave is used by both channels. Other wave forms are released.
+	channels[1] = channels[0];
+	for(int i = 0; i < 100; i++) {
+		ASSERT_HRESULT_SUCCEEDED(pcmData->generateChannels(channels));
+	}
+	EXPECT_EQ(tableBytes, pcmData->getCycleDataSize());
+	WaveTableCache::getInstance().clear();
+}
+
+// Least recently used entry should be evicted when the size exceeds the bound,
+// while IPcmData that refers to the evicted tables keeps playing them.
+TEST(WaveTableCacheUnitTest, eviction)
+{
+	static const DWORD samplesPerSec = 44100;
+	static const size_t entryBytes = (WaveTableCache::TableSize + 1) * sizeof(float) * WaveTableCache::Levels;
+	static const size_t frames = 1000;
+
+	auto& cache = WaveTableCache::getInstance();
+	cache.clear();
+	cache.setMaxBytes(entryBytes * 2);
+	auto create = [](float peakPosition) {
+		auto pcmData = createPcmData(samplesPerSec, 1, createBandLimitedTriangleWaveGenerator(IPcmData::SampleDataType::IEEE_Float, peakPosition), IPcmData::SynthesisMode::Oscillator);
+		pcmData->generate(1000, 1.0f);
+		return pcmData;
+	};
+
+	auto a = create(0.1f);
+	auto b = create(0.2f);
+	create(0.1f);
+	auto c = create(0.3f);
+	auto statistics = cache.getStatistics();
+	EXPECT_EQ(3, statistics.misses);
+	EXPECT_EQ(1, statistics.hits);
+	EXPECT_EQ(1, statistics.evictions);
+	EXPECT_EQ(2, statistics.entries);
+	EXPECT_EQ(entryBytes * 2, statistics.bytes);
+	EXPECT_EQ(entryBytes * 2, statistics.maxBytes);
+
+	// b was evicted, and a is still cached. Then c is evicted by b.
+	create(0.1f);
+	auto b2 = create(0.2f);
+	statistics = cache.getStatistics();
+	EXPECT_EQ(4, statistics.misses);
+	EXPECT_EQ(2, statistics.hits);
+	EXPECT_EQ(2, statistics.evictions);
+
+	std::vector<float> expected(frames), actual(frames);
+	ASSERT_HRESULT_SUCCEEDED(b2->copyTo(expected.data(), frames * sizeof(float)));
+	ASSERT_HRESULT_SUCCEEDED(b->copyTo(actual.data(), frames * sizeof(float)));
+	EXPECT_EQ(0, memcmp(expected.data(), actual.data(), frames * sizeof(float)));
+
+	// Shrinking the bound evicts entries immediately.
+	cache.setMaxBytes(0);
+	statistics = cache.getStatistics();
+	EXPECT_EQ(0, statistics.entries);
+	EXPECT_EQ(0, statistics.bytes);
+	ASSERT_HRESULT_SUCCEEDED(a->copyTo(actual.data(), frames * sizeof(float)));
+
+	cache.setMaxBytes(WaveTableCache::DefaultMaxBytes);
+	cache.clear();
+}
+
+// Oscillator of band-limited wave form should read the level whose harmonics do not alias at the key.
+TEST(WaveTableCacheUnitTest, aliasing)
+{
+	static const DWORD samplesPerSec = 44100;
+	// 441 frames hold 31 cycles.
+	static const float key = 3100;
+	static const size_t frames = 441;
+	static const size_t cycles = 31;
+
+	double ratio[2];
+	for(auto type : { IPcmData::WaveFormType::SquareWave, IPcmData::WaveFormType::BandLimitedSquareWave }) {
+		auto& wp = PcmDataEnumerator::getWaveFormProperty(type);
+		auto pcmData = createPcmData(samplesPerSec, 1, wp.factory(IPcmData::SampleDataType::IEEE_Float, 0.5f), IPcmData::SynthesisMode::Oscillator);
+		pcmData->generate(key, 1.0f);
+		std::vector<float> samples(frames);
+		ASSERT_HRESULT_SUCCEEDED(pcmData->copyTo(samples.data(), frames * sizeof(float)));
+		ratio[type == IPcmData::WaveFormType::BandLimitedSquareWave] = getAliasingRatio(samples, cycles);
+		// HighValue of float sample is 0.8, and band-limited square wave overshoots by Gibbs phenomenon(about 9% of the jump) and ripple.
+		for(auto value : samples) { ASSERT_GE(0.8f * 1.25f, fabs(value)) << wp.name; }
+	}
+	std::cout << "Oscillator: Aliasing " << (10 * log10(ratio[0])) << "dB -> " << (10 * log10(ratio[1])) << "dB" << std::endl;
+	EXPECT_LT(ratio[1] * 100, ratio[0]);
+	WaveTableCache::getInstance().clear();
+}
+
+// Values of SineTable calculated at compile time should be as accurate as sin() of C runtime library.
+TEST(SineTableUnitTest, table)
+{
+	static const double pi = 3.14159265358979323846;
+
+	EXPECT_EQ(0.0, SineTable::quarter(0));
+	double maxError = 0;
+	for(size_t i = 0; i <= SineTable::Size; i++) {
+		auto error = fabs(SineTable::quarter(i) - sin(pi / 2 * i / SineTable::Size));
+		maxError = max(maxError, error);
+		ASSERT_GE(SineTable::MaxTableError, error) << i;
+	}
+	std::cout << "Bits: " << SineTable::Bits << ", Max error of the table: " << maxError << std::endl;
+
+	// Period that divides 4 * Size reads the table without interpolation.
+	for(size_t period : { (size_t)4, (size_t)64, SineTable::Size, SineTable::Size * 4 }) {
+		for(size_t i = 0; i < period * 2; i++) {
+			// Angle is reduced to 1 cycle, so that rounding error of the angle does not exceed the error of the table.
+			auto x = 2 * pi * (i % period) / period;
+			ASSERT_NEAR(sin(x), SineTable::sinAt(i, period), SineTable::MaxTableError) << i << "/" << period;
+			ASSERT_NEAR(cos(x), SineTable::cosAt(i, period), SineTable::MaxTableError) << i << "/" << period;
+		}
+	}
+}
+
+// Interpolated value should be within the error of linear interpolation.
+TEST(SineTableUnitTest, interpolation)
+{
+	static const double pi = 3.14159265358979323846;
+
+	double maxError = 0;
+	for(size_t period : { (size_t)3, (size_t)1000, (size_t)44100, SineTable::Size * 4 + 1 }) {
+		for(size_t i = 0; i < period; i++) {
+			auto x = 2 * pi * i / period;
+			auto error = fabs(SineTable::sinAt(i, period) - sin(x));
+			maxError = max(maxError, error);
+			ASSERT_GE(SineTable::MaxInterpolationError, error) << i << "/" << period;
+			ASSERT_NEAR(cos(x), SineTable::cosAt(i, period), SineTable::MaxInterpolationError) << i << "/" << period;
+		}
+	}
+	std::cout << "Bits: " << SineTable::Bits << ", Max error of interpolation: " << maxError
+			<< " (bound " << SineTable::MaxInterpolationError << ")" << std::endl;
+
+	// Position in cycles may be negative or exceed 1 cycle.
+	for(auto x : { -2.7, -0.25, -1e-20, 0.0, 0.1, 0.999999999, 1.0, 12.34 }) {
+		EXPECT_NEAR(sin(2 * pi * x), SineTable::sinCycle(x), SineTable::MaxInterpolationError) << x;
+		EXPECT_NEAR(cos(2 * pi * x), SineTable::cosCycle(x), SineTable::MaxInterpolationError) << x;
+	}
+}
@@ -13,18 +13,7 @@ using namespace ::testing;
 template<typename T>
 IPcmData::SampleDataType getSampleDataType()
 {
-	switch(sizeof(T)) {
-	case 1:
-		return IPcmData::SampleDataType::PCM_8bits;
-	case 2:
-		return IPcmData::SampleDataType::PCM_16bits;
-	case 3:
-		return IPcmData::SampleDataType::PCM_24bits;
-	case 4:
-		return IPcmData::SampleDataType::IEEE_Float;
-	default:
-		return IPcmData::SampleDataType::Unknown;
-	}
+	return WaveGenerator<T>::SampleDataType;
 }
 
 template<typename T> T Samples[];
@@ -33,6 +22,9 @@ template<> UINT8 Samples<UINT8>[] = { 0, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xff };
 template<> INT16 Samples<INT16>[] = { (INT16)0xa000, (INT16)0xc000, 0, 0x6000, 0x7fff, (INT16)0xffff };
 template<> INT24 Samples<INT24>[] = { 0xa00000, 0xc00000, 0, 0x600000, 0x7fffff, 0xffffff };
 template<> float Samples<float>[] = { -1.0f, -0.4f, -0.8f, 0, 0.4f, 0.8f, 1.0f };
+template<> INT24in32 Samples<INT24in32>[] = { -0x600000, -0x400000, 0, 0x600000, 0x7fffff, -1 };
+template<> INT32 Samples<INT32>[] = { -0x60000000, -0x40000000, 0, 0x60000000, 0x7fffffff, (INT32)0x80000000 };
+template<> double Samples<double>[] = { -1.0, -0.4, -0.8, 0, 0.4, 0.8, 1.0, 0.1234567890123 };
 
 template<typename T>
 class PcmSampleTypedTest : public Test
@@ -53,7 +45,7 @@ public:
 	}
 };
 
-using AllSampleDataTypes = Types<UINT8, INT16, INT24, float>;
+using AllSampleDataTypes = Types<UINT8, INT16, INT24, float, INT24in32, INT32, double>;
 TYPED_TEST_SUITE(PcmSampleTypedTest, AllSampleDataTypes);
 
 // Test for IPcmSample::isValue(index).
@@ -84,6 +76,7 @@ TYPED_TEST(PcmSampleTypedTest, to_int_float)
 		auto formatTag = this->testee->getFormatTag();
 		switch(formatTag) {
 		case WAVE_FORMAT_PCM:
+		case WAVE_FORMAT_EXTENSIBLE:
 			EXPECT_EQ((INT32)value, this->testSamples[i]);
 			break;
 		case WAVE_FORMAT_IEEE_FLOAT:
@@ -106,6 +99,7 @@ TYPED_TEST(PcmSampleTypedTest, to_string)
 		auto formatTag = this->testee->getFormatTag();
 		switch(formatTag) {
 		case WAVE_FORMAT_PCM:
+		case WAVE_FORMAT_EXTENSIBLE:
 			EXPECT_EQ((TypeParam)atoi(str.c_str()), this->testSamples[i]);
 			break;
 		case WAVE_FORMAT_IEEE_FLOAT:
@@ -127,6 +121,7 @@ TYPED_TEST(PcmSampleTypedTest, constants)
 
 	switch(formatTag) {
 	case WAVE_FORMAT_PCM:
+	case WAVE_FORMAT_EXTENSIBLE:
 		EXPECT_EQ((INT32)IPcmSample::HighValue<TypeParam>, PcmData<TypeParam>::HighValue);
 		EXPECT_EQ((INT32)IPcmSample::ZeroValue<TypeParam>, PcmData<TypeParam>::ZeroValue);
 		EXPECT_EQ((INT32)IPcmSample::LowValue<TypeParam>, PcmData<TypeParam>::LowValue);
@@ -203,6 +198,12 @@ TYPED_TEST(PcmSampleTypedTest, assignment_type_error)
 			sourceSamples.reset(createPcmSample(&source, 1));
 		}
 		break;
+	case 8:	// float can not assign to double
+		{
+			static float source = 0;
+			sourceSamples.reset(createPcmSample(&source, 1));
+		}
+		break;
 	}
 
 	ASSERT_THAT(sourceSamples, NotNull());
@@ -0,0 +1,658 @@
+#include <PcmData/SimdKernel.h>
+#include <PcmData/INT24.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <vector>
+#include <tuple>
+#include <type_traits>
+#include <math.h>
+
+using namespace ::testing;
+
+// Instruction sets supported by the CPU on which the test runs.
+static std::vector<SimdKernel::InstructionSet> getInstructionSets()
+{
+	std::vector<SimdKernel::InstructionSet> ret;
+	for(auto is : { SimdKernel::InstructionSet::Scalar, SimdKernel::InstructionSet::SSE2, SimdKernel::InstructionSet::SSSE3, SimdKernel::InstructionSet::AVX2 }) {
+		if(is <= SimdKernel::getSupportedInstructionSet()) { ret.push_back(is); }
+	}
+	return ret;
+}
+
+class SimdKernelUnitTest : public Test
+{
+public:
+	void SetUp() override { m_instructionSet = SimdKernel::getInstructionSet(); }
+	void TearDown() override { SimdKernel::setInstructionSet(m_instructionSet); }
+
+	// frames, cycles
+	using SineParameter = std::tuple<size_t, size_t>;
+	static const SineParameter sineParameters[];
+	static const float peakPositions[];
+
+protected:
+	SimdKernel::InstructionSet m_instructionSet;
+
+	// Calls kernel(float* dest, size_t stride, size_t frames, size_t cycles) for all instruction sets
+	// and compares the results.
+	template<typename F>
+	void identical(F kernel);
+};
+
+const SimdKernelUnitTest::SineParameter SimdKernelUnitTest::sineParameters[] = {
+	{ 1, 1 }, { 3, 1 }, { 7, 2 }, { 100, 1 }, { 109, 1 }, { 2205, 22 }, { 44100, 1 }, { 48000, 7 }, { 192000, 1 },
+};
+
+const float SimdKernelUnitTest::peakPositions[] = { 0.0f, 0.1f, 0.25f, 0.4f, 0.5f, 0.6f, 0.75f, 0.9f, 1.0f };
+
+// Error of sine kernel compared with sin() should be less than or equal to SineMaxError.
+// Samples of another channel should not be written.
+TEST_F(SimdKernelUnitTest, sineAccuracy)
+{
+	static const double pi = 3.14159265358979323846;
+	static const WORD channels = 2;
+	static const float notWritten = 100.0f;
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		double maxError = 0;
+		for(auto& param : sineParameters) {
+			size_t frames, cycles;
+			std::tie(frames, cycles) = param;
+			std::vector<float> data(frames * channels, notWritten);
+			SimdKernel::sine(data.data(), channels, frames, cycles, 0, 1.0f);
+
+			for(size_t frame = 0; frame < frames; frame++) {
+				auto expected = sin(2 * pi * ((frame * cycles) % frames) / frames);
+				auto error = fabs(data[frame * channels] - expected);
+				ASSERT_LE(error, SimdKernel::SineMaxError)
+					<< SimdKernel::getInstructionSetName(is) << ": frames=" << frames << ", cycles=" << cycles << ", frame=" << frame;
+				ASSERT_EQ(notWritten, data[(frame * channels) + 1]);
+				if(maxError < error) { maxError = error; }
+			}
+		}
+		std::cout << SimdKernel::getInstructionSetName(is) << ": Max error=" << maxError << std::endl;
+	}
+}
+
+template<typename F>
+void SimdKernelUnitTest::identical(F kernel)
+{
+	using T = float;
+	static const WORD channels = 3;
+
+	for(auto& param : sineParameters) {
+		size_t frames, cycles;
+		std::tie(frames, cycles) = param;
+		SimdKernel::setInstructionSet(SimdKernel::InstructionSet::Scalar);
+		std::unique_ptr<T[]> expected(new T[frames * channels]());
+		kernel(expected.get(), channels, frames, cycles);
+
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::unique_ptr<T[]> actual(new T[frames * channels]());
+			kernel(actual.get(), channels, frames, cycles);
+			ASSERT_EQ(0, memcmp(expected.get(), actual.get(), frames * channels * sizeof(T)))
+				<< SimdKernel::getInstructionSetName(is) << ": frames=" << frames << ", cycles=" << cycles;
+		}
+	}
+}
+
+// All implementations should generate identical float master.
+TEST_F(SimdKernelUnitTest, sineIdentical)
+{
+	identical([](float* dest, size_t stride, size_t frames, size_t cycles) { SimdKernel::sine(dest, stride, frames, cycles, 0, 1.0f); });
+	identical([](float* dest, size_t stride, size_t frames, size_t cycles) { SimdKernel::sine(dest, stride, frames, cycles, 0.1f, 0.8f); });
+}
+
+TEST_F(SimdKernelUnitTest, squareIdentical)
+{
+	for(float duty : { 0.1f, 0.5f, 0.9f }) {
+		auto highFrames = [duty](size_t frames) { return (size_t)(frames * duty); };
+		identical([&](float* dest, size_t stride, size_t frames, size_t cycles) { SimdKernel::square(dest, stride, frames, cycles, highFrames(frames), 1.0f, -1.0f); });
+	}
+}
+
+TEST_F(SimdKernelUnitTest, triangleIdentical)
+{
+	for(float peak : peakPositions) {
+		identical([peak](float* dest, size_t stride, size_t frames, size_t cycles) { SimdKernel::triangle(dest, stride, frames, cycles, peak, 0, 1.0f, 1.0f); });
+		identical([peak](float* dest, size_t stride, size_t frames, size_t cycles) { SimdKernel::triangle(dest, stride, frames, cycles, peak, 0.1f, 0.8f, 0.7f); });
+	}
+}
+
+// Square wave should be high while position in the cycle is less than highFrames.
+TEST_F(SimdKernelUnitTest, square)
+{
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		for(auto& param : sineParameters) {
+			size_t frames, cycles;
+			std::tie(frames, cycles) = param;
+			auto highFrames = frames / 3;
+			std::vector<float> data(frames);
+			SimdKernel::square(data.data(), 1, frames, cycles, highFrames, 100, -100);
+			for(size_t frame = 0; frame < frames; frame++) {
+				ASSERT_EQ((((frame * cycles) % frames) < highFrames) ? 100 : -100, data[frame])
+					<< SimdKernel::getInstructionSetName(is) << ": frames=" << frames << ", cycles=" << cycles << ", frame=" << frame;
+			}
+		}
+	}
+}
+
+// Returns value of triangle wave at position x(0.0 ~ 1.0) in the cycle.
+// See description of TriangleWaveGenerator class.
+static double triangleValue(double p, double x)
+{
+	if(p == 0.0) { return 1 - (2 * x); }
+	if(p == 1.0) { return (2 * x) - 1; }
+	if(p == 0.5) { return (x < 0.5) ? (2 * x) : ((2 * x) - 2); }
+	if(p < 0.5) {
+		if(x < p) { return x / p; }
+		if(x < (1 - p)) { return 1 - (2 * (x - p) / (1 - (2 * p))); }
+		return ((x - (1 - p)) / p) - 1;
+	} else {
+		auto q = 1 - p;
+		if(x < q) { return -x / q; }
+		if(x < p) { return (2 * (x - q) / (p - q)) - 1; }
+		return 1 - ((x - p) / q);
+	}
+}
+
+// Triangle wave should match the piecewise linear function.
+TEST_F(SimdKernelUnitTest, triangle)
+{
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		for(float peak : peakPositions) {
+			for(auto& param : sineParameters) {
+				size_t frames, cycles;
+				std::tie(frames, cycles) = param;
+				std::vector<float> data(frames);
+				SimdKernel::triangle(data.data(), 1, frames, cycles, peak, 0, 1.0f, 1.0f);
+				for(size_t frame = 0; frame < frames; frame++) {
+					auto expected = triangleValue(peak, (double)((frame * cycles) % frames) / frames);
+					ASSERT_NEAR(expected, data[frame], 2e-5)
+						<< SimdKernel::getInstructionSetName(is) << ": peakPosition=" << peak
+						<< ", frames=" << frames << ", cycles=" << cycles << ", frame=" << frame;
+				}
+			}
+		}
+	}
+}
+
+// Sample at the same position in the cycle should be the same regardless of number of cycles.
+TEST_F(SimdKernelUnitTest, triangleIndependentOfCycles)
+{
+	static const size_t frames = 2205;
+	static const size_t cycles = 22;
+
+	for(float peak : peakPositions) {
+		std::vector<float> oneCycle(frames), multiCycles(frames);
+		SimdKernel::triangle(oneCycle.data(), 1, frames, 1, peak, 0, 1.0f, 1.0f);
+		SimdKernel::triangle(multiCycles.data(), 1, frames, cycles, peak, 0, 1.0f, 1.0f);
+		for(size_t frame = 0; frame < frames; frame++) {
+			ASSERT_EQ(oneCycle[(frame * cycles) % frames], multiCycles[frame])
+				<< "peakPosition=" << peak << ", frame=" << frame;
+		}
+	}
+}
+
+// Residuals should be added to 2 frames around the discontinuity of each cycle,
+// and the frame at the edge of square wave should be the middle of high and low.
+TEST_F(SimdKernelUnitTest, polyBlep)
+{
+	static const float jump = 2.0f;
+	static const float slopeChange = 5.0f;
+
+	for(auto& param : sineParameters) {
+		size_t frames, cycles;
+		std::tie(frames, cycles) = param;
+		for(double edge : { 0.0, frames / 3.0, frames * 0.5 }) {
+			std::vector<float> data(frames);
+			SimdKernel::polyBlep(data.data(), 1, frames, cycles, edge, jump, slopeChange);
+			std::vector<double> expected(frames);
+			for(size_t cycle = 0; cycle < cycles; cycle++) {
+				auto position = ((double)cycle * frames + edge) / cycles;
+				for(auto frame = (size_t)position; frame <= (size_t)position + 1; frame++) {
+					auto d = frame - position;
+					auto x = (d < 0) ? (1 + d) : (1 - d);
+					auto slope = slopeChange * cycles / frames;
+					expected[frame % frames] += (((d < 0) ? jump : -jump) * x * x / 2) + (slope * x * x * x / 6);
+				}
+			}
+			for(size_t frame = 0; frame < frames; frame++) {
+				ASSERT_NEAR(expected[frame], data[frame], 1e-5)
+					<< "frames=" << frames << ", cycles=" << cycles << ", edge=" << edge << ", frame=" << frame;
+			}
+		}
+
+		// Rising edge at 0 and falling edge at highFrames, that overlap in 1 frame.
+		auto highFrames = frames / 2;
+		if(highFrames == 0) { continue; }
+		std::vector<float> data(frames);
+		SimdKernel::square(data.data(), 1, frames, cycles, highFrames, 1.0f, -1.0f);
+		SimdKernel::polyBlep(data.data(), 1, frames, cycles, 0, 2.0f, 0);
+		SimdKernel::polyBlep(data.data(), 1, frames, cycles, (double)highFrames, -2.0f, 0);
+		for(size_t frame = 0; frame < frames; frame++) {
+			auto value = (frame * cycles) % frames;
+			if((value == 0) || (value == highFrames)) {
+				ASSERT_EQ(0, data[frame]) << "frames=" << frames << ", cycles=" << cycles << ", frame=" << frame;
+			}
+			ASSERT_GE(1.0f, fabs(data[frame])) << "frames=" << frames << ", cycles=" << cycles << ", frame=" << frame;
+		}
+	}
+}
+
+// Instruction set can not exceed the supported one.
+TEST_F(SimdKernelUnitTest, setInstructionSet)
+{
+	SimdKernel::setInstructionSet(SimdKernel::InstructionSet::AVX2);
+	EXPECT_EQ(SimdKernel::getSupportedInstructionSet(), SimdKernel::getInstructionSet());
+
+	SimdKernel::setInstructionSet(SimdKernel::InstructionSet::Scalar);
+	EXPECT_EQ(SimdKernel::InstructionSet::Scalar, SimdKernel::getInstructionSet());
+}
+
+// Returns float master from -range to +range in turn.
+static std::vector<float> convertSource(size_t count, float range)
+{
+	std::vector<float> ret(count);
+	for(size_t i = 0; i < count; i++) {
+		ret[i] = range * (((float)((i * 7919) % count) * 2.0f / (float)(count - 1)) - 1.0f);
+	}
+	return ret;
+}
+
+// Conversion should be rounded to nearest and saturated to the range of T.
+// tolerance is for float precision(24 bits) of the multiplication, that exceeds 1 LSB of 32-bit sample.
+template<typename T>
+static void testConvert(INT32 min, INT32 max, float zero, float height, INT32 tolerance = 1)
+{
+	static const size_t count = 1001;		// Not a multiple of lanes.
+
+	// Master beyond +-1.0 saturates when height is large.
+	auto source = convertSource(count, 1.5f);
+	for(float gain : { 0.0f, 0.25f, 0.5f, 0.7071f, 1.0f, 1.5f, 3.0f }) {
+		std::vector<T> expected(count);
+		for(size_t i = 0; i < count; i++) {
+			auto v = nearbyint(((double)source[i] * height * gain) + zero);
+			expected[i] = (T)(INT32)((v < min) ? min : ((max < v) ? max : v));
+		}
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::vector<T> actual(count);
+			SimdKernel::convert(actual.data(), source.data(), count, zero, height * gain);
+			for(size_t i = 0; i < count; i++) {
+				ASSERT_NEAR((INT32)expected[i], (INT32)actual[i], tolerance)
+					<< SimdKernel::getInstructionSetName(is) << ": gain=" << gain << ", source=" << source[i];
+			}
+		}
+	}
+}
+
+TEST_F(SimdKernelUnitTest, convert)
+{
+	testConvert<UINT8>(0, 0xff, 0x80, 0x40);
+	testConvert<INT16>(-0x8000, 0x7fff, 0, 0x6000);
+	testConvert<INT24>(-0x800000, 0x7fffff, 0, 0x600000);
+	testConvert<INT24in32>(-0x800000, 0x7fffff, 0, 0x600000);
+	testConvert<INT32>(INT32_MIN, 0x7fffff80, 0, 0x60000000, 0x200);
+}
+
+// 24-bit value should be stored in the high 24 bits of 32-bit container.
+TEST_F(SimdKernelUnitTest, convertInt24in32)
+{
+	static const size_t count = 37;
+	auto source = convertSource(count, 1.5f);
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		std::vector<INT24in32> actual(count);
+		std::vector<INT24> expected(count);
+		SimdKernel::convert(actual.data(), source.data(), count, 0, 0x600000);
+		SimdKernel::convert(expected.data(), source.data(), count, 0, 0x600000);
+		for(size_t i = 0; i < count; i++) {
+			auto container = *(const INT32*)&actual[i];
+			ASSERT_EQ((INT32)expected[i] * 0x100, container) << SimdKernel::getInstructionSetName(is) << ": " << i;
+		}
+	}
+}
+
+// All implementations should convert identically for all sample types, with and without dither.
+// Dithered result should not depend on how samples are split into calls.
+TEST_F(SimdKernelUnitTest, convertIdentical)
+{
+	auto test = [](auto* type, float zero, float height, SimdKernel::Dither dither) {
+		using T = std::remove_pointer_t<decltype(type)>;
+		static const size_t count = 1003;
+		static const UINT32 ditherIndex = 12345;
+		auto source = convertSource(count, 1.2f);
+		SimdKernel::setInstructionSet(SimdKernel::InstructionSet::Scalar);
+		std::vector<T> expected(count);
+		SimdKernel::convert(expected.data(), source.data(), count, zero, height, dither, ditherIndex);
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::vector<T> actual(count);
+			SimdKernel::convert(actual.data(), source.data(), count, zero, height, dither, ditherIndex);
+			ASSERT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(T)))
+				<< SimdKernel::getInstructionSetName(is) << ": height=" << height;
+
+			std::vector<T> split(count);
+			SimdKernel::convert(split.data(), source.data(), 13, zero, height, dither, ditherIndex);
+			SimdKernel::convert(&split[13], &source[13], count - 13, zero, height, dither, ditherIndex + 13);
+			ASSERT_EQ(0, memcmp(expected.data(), split.data(), count * sizeof(T)))
+				<< SimdKernel::getInstructionSetName(is) << ": height=" << height;
+		}
+	};
+
+	for(auto dither : { SimdKernel::Dither::None, SimdKernel::Dither::TPDF }) {
+		for(float gain : { 0.1f, 0.5f, 0.999f, 1.0f }) {
+			test((UINT8*)nullptr, 0x80, 0x40 * gain, dither);
+			test((INT16*)nullptr, 0, 0x6000 * gain, dither);
+			test((INT24*)nullptr, 0, 0x600000 * gain, dither);
+			test((float*)nullptr, 0, 0.8f * gain, dither);
+			test((INT24in32*)nullptr, 0, 0x600000 * gain, dither);
+			test((INT32*)nullptr, 0, 0x60000000 * gain, dither);
+			test((double*)nullptr, 0, 0.8f * gain, dither);
+		}
+	}
+}
+
+// TPDF dither should make average of samples equal to the value between integers,
+// with error less than 2 LSB for each sample.
+TEST_F(SimdKernelUnitTest, dither)
+{
+	static const size_t count = 100000;
+	static const double value = 0.3;
+
+	std::vector<float> source(count, (float)value);
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		std::vector<INT16> actual(count);
+		SimdKernel::convert(actual.data(), source.data(), count, 0, 1.0f, SimdKernel::Dither::TPDF);
+		double sum = 0;
+		for(auto sample : actual) {
+			ASSERT_GE(1, abs(sample)) << SimdKernel::getInstructionSetName(is);
+			sum += sample;
+		}
+		EXPECT_NEAR(value, sum / count, 0.01) << SimdKernel::getInstructionSetName(is);
+
+		// Without dither, all samples are rounded to the same value.
+		SimdKernel::convert(actual.data(), source.data(), count, 0, 1.0f);
+		EXPECT_THAT(actual, Each(0)) << SimdKernel::getInstructionSetName(is);
+	}
+}
+
+// Height of each frame should change linearly and be same for all channels.
+TEST_F(SimdKernelUnitTest, convertRamp)
+{
+	static const size_t frames = 100;
+	static const size_t channels = 3;
+
+	std::vector<float> source(frames * channels, 0.5f);
+	std::vector<INT16> samples(frames * channels);
+	SimdKernel::convertRamp(samples.data(), source.data(), frames, channels, 0, 20000, 1.0f, -0.01f);
+	for(size_t frame = 0; frame < frames; frame++) {
+		for(size_t channel = 0; channel < channels; channel++) {
+			ASSERT_NEAR(10000 * (1.0 - (0.01 * (frame + 1))), samples[(frame * channels) + channel], 1)
+				<< "frame=" << frame << ", channel=" << channel;
+		}
+	}
+}
+
+// All implementations should interleave planar master of any channel count,
+// including channels that are not multiple of the vector width.
+TEST_F(SimdKernelUnitTest, interleave)
+{
+	static const size_t frames = 103;
+	static const size_t srcStride = 107;
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		for(size_t channels : { 1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 16, 17 }) {
+			std::vector<float> source(srcStride * channels);
+			for(size_t i = 0; i < source.size(); i++) { source[i] = (float)i; }
+			std::vector<float> dest(frames * channels, -1.0f);
+			SimdKernel::interleave(dest.data(), source.data(), srcStride, channels, frames);
+			for(size_t frame = 0; frame < frames; frame++) {
+				for(size_t channel = 0; channel < channels; channel++) {
+					ASSERT_EQ((float)((channel * srcStride) + frame), dest[(frame * channels) + channel])
+						<< SimdKernel::getInstructionSetName(is) << ": channels=" << channels << ", frame=" << frame << ", channel=" << channel;
+				}
+			}
+		}
+	}
+}
+
+// All implementations should add arrays of any count, including unaligned tail.
+TEST_F(SimdKernelUnitTest, add)
+{
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		for(size_t count : { 1, 3, 4, 7, 8, 15, 16, 17, 1001 }) {
+			std::vector<float> src1(count), src2(count), dest(count + 1, -1.0f);
+			for(size_t i = 0; i < count; i++) {
+				src1[i] = (float)i * 0.25f;
+				src2[i] = (float)(count - i) * -0.5f;
+			}
+			// Source may start at any element of the table.
+			SimdKernel::add(&dest[1], src1.data(), src2.data(), count);
+			EXPECT_EQ(-1.0f, dest[0]);
+			for(size_t i = 0; i < count; i++) {
+				ASSERT_EQ(src1[i] + src2[i], dest[i + 1]) << SimdKernel::getInstructionSetName(is) << ": count=" << count << ", i=" << i;
+			}
+		}
+	}
+}
+
+// Chirp should be sine of the phase, and all instruction sets should generate identical samples.
+TEST_F(SimdKernelUnitTest, chirp)
+{
+	static const size_t frames = 67;
+	static const double pi = 3.14159265358979323846;
+
+	std::vector<float> shape(frames), curve(frames);
+	for(size_t i = 0; i < frames; i++) {
+		shape[i] = (float)i;
+		curve[i] = (float)(0.0003 * i * i);
+	}
+
+	for(float rate : { 0.0001f, 0.01f, 0.2f, 0.5f }) {
+		std::vector<float> expected;
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::vector<float> dest(frames);
+			SimdKernel::chirp(dest.data(), frames, 0.7f, rate, shape.data(), curve.data(), 0.5f);
+			for(size_t i = 0; i < frames; i++) {
+				auto phase = 0.7 + ((double)rate * shape[i]) + curve[i];
+				ASSERT_NEAR(0.5 * sin(2 * pi * phase), dest[i], 1e-5) << "rate=" << rate << ", i=" << i;
+			}
+			if(expected.empty()) { expected = dest; }
+			ASSERT_EQ(0, memcmp(expected.data(), dest.data(), frames * sizeof(float))) << SimdKernel::getInstructionSetName(is) << ": rate=" << rate;
+		}
+	}
+}
+
+// Noise should be -1.0 ~ +1.0 of height, continue from any index, and all instruction sets should generate identical samples.
+TEST_F(SimdKernelUnitTest, noise)
+{
+	static const size_t count = 1003;
+	static const UINT32 index = 0xfffffe00;
+
+	for(auto kernel : { SimdKernel::whiteNoise, SimdKernel::pinkNoise }) {
+		std::vector<float> expected;
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::vector<float> dest(count), head(count);
+			kernel(dest.data(), count, 7, index, 0.5f);
+			for(size_t i = 0; i < count; i++) {
+				ASSERT_LE(-0.5f, dest[i]) << SimdKernel::getInstructionSetName(is) << ": i=" << i;
+				ASSERT_GT(0.5f, dest[i]) << SimdKernel::getInstructionSetName(is) << ": i=" << i;
+			}
+			// Index wraps around.
+			kernel(head.data(), 3, 7, index, 0.5f);
+			kernel(&head[3], count - 3, 7, index + 3, 0.5f);
+			ASSERT_EQ(0, memcmp(dest.data(), head.data(), count * sizeof(float))) << SimdKernel::getInstructionSetName(is);
+			if(expected.empty()) { expected = dest; }
+			ASSERT_EQ(0, memcmp(expected.data(), dest.data(), count * sizeof(float))) << SimdKernel::getInstructionSetName(is);
+		}
+	}
+}
+
+// Bits should be expanded from any index, including bits before the byte boundary and the tail.
+TEST_F(SimdKernelUnitTest, expandBits)
+{
+	static const UINT64 bits[] = { 0x0123456789abcdefull, 0xfedcba9876543210ull, 0xa5a5a5a55a5a5a5aull };
+
+	for(auto is : getInstructionSets()) {
+		SimdKernel::setInstructionSet(is);
+		for(size_t index : { 0, 1, 7, 8, 13, 64, 100 }) {
+			for(size_t count : { 0, 1, 5, 8, 9, 16, 31, 64, 92 }) {
+				if(sizeof(bits) * 8 < index + count) { continue; }
+				std::vector<float> dest(count + 1, 0.5f);
+				SimdKernel::expandBits(dest.data(), bits, index, count, -1.0f, 1.0f);
+				for(size_t i = 0; i < count; i++) {
+					auto n = index + i;
+					ASSERT_EQ(((bits[n / 64] >> (n % 64)) & 1) ? -1.0f : 1.0f, dest[i])
+						<< SimdKernel::getInstructionSetName(is) << ": index=" << index << ", count=" << count << ", i=" << i;
+				}
+				ASSERT_EQ(0.5f, dest[count]);
+			}
+		}
+	}
+}
+
+// Hadamard transform should be product of Hadamard matrix, and all instruction sets should generate identical values.
+TEST_F(SimdKernelUnitTest, hadamard)
+{
+	for(size_t size = 1; size <= 1024; size *= 2) {
+		std::vector<float> src(size);
+		for(size_t i = 0; i < size; i++) { src[i] = (float)((i * 37) % 101) - 50.0f; }
+
+		std::vector<float> expected;
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			auto data = src;
+			SimdKernel::hadamard(data.data(), size);
+			for(size_t a = 0; a < size; a++) {
+				double sum = 0;
+				for(size_t b = 0; b < size; b++) {
+					size_t bits = a & b, parity = 0;
+					for(; bits; bits &= bits - 1) { parity ^= 1; }
+					sum += parity ? -src[b] : src[b];
+				}
+				ASSERT_EQ(sum, data[a]) << SimdKernel::getInstructionSetName(is) << ": size=" << size << ", a=" << a;
+			}
+			if(expected.empty()) { expected = data; }
+			ASSERT_EQ(0, memcmp(expected.data(), data.data(), size * sizeof(float))) << SimdKernel::getInstructionSetName(is) << ": size=" << size;
+		}
+	}
+}
+
+// Oscillator bank should sum oscillators of wave tables, and all instruction sets should generate identical samples.
+TEST_F(SimdKernelUnitTest, oscillatorBank)
+{
+	static const size_t tableSize = 1 << SimdKernel::OscillatorBankTableBits;
+	static const size_t frames = 1003;
+	static const double pi = 3.14159265358979323846;
+
+	// Table 0 is sine wave, and table 1 is sawtooth wave.
+	std::vector<float> tables((tableSize + 1) * 2);
+	for(size_t i = 0; i <= tableSize; i++) {
+		tables[i] = (float)sin(2 * pi * i / tableSize);
+		tables[tableSize + 1 + i] = (float)(((double)(i % tableSize) / tableSize * 2) - 1);
+	}
+
+	for(size_t oscillators : { 8, 16, 24, 40, 256 }) {
+		std::vector<UINT32> offsets(oscillators), deltas(oscillators), initialPhases(oscillators);
+		std::vector<float> levels(oscillators);
+		for(size_t i = 0; i < oscillators; i++) {
+			offsets[i] = (UINT32)((i % 3) ? 0 : (tableSize + 1));
+			deltas[i] = (UINT32)(0x01000000 + (i * 0x00123457));
+			initialPhases[i] = (UINT32)(i * 0x10000001);
+			levels[i] = 1.0f / (i + 2);
+		}
+
+		// Reference calculated by double.
+		for(size_t i = 0; i < frames; i += 97) {
+			double expected = 0;
+			for(size_t o = 0; o < oscillators; o++) {
+				auto phase = (UINT32)(initialPhases[o] + (deltas[o] * (UINT32)i));
+				auto position = (double)phase / 4294967296.0 * tableSize;
+				auto index = (size_t)position;
+				auto table = &tables[offsets[o]];
+				expected += (table[index] + ((table[index + 1] - table[index]) * (position - index))) * levels[o];
+			}
+			std::vector<UINT32> phases(initialPhases);
+			float actual[1];
+			for(size_t f = 0; f < i; f++) {
+				for(size_t o = 0; o < oscillators; o++) { phases[o] += deltas[o]; }
+			}
+			SimdKernel::oscillatorBank(actual, 1, tables.data(), offsets.data(), phases.data(), deltas.data(), levels.data(), oscillators);
+			ASSERT_NEAR(expected, actual[0], 1e-5 * oscillators) << "oscillators=" << oscillators << ", frame=" << i;
+		}
+
+		SimdKernel::setInstructionSet(SimdKernel::InstructionSet::Scalar);
+		std::vector<UINT32> expectedPhases(initialPhases);
+		std::vector<float> expected(frames);
+		SimdKernel::oscillatorBank(expected.data(), frames, tables.data(), offsets.data(), expectedPhases.data(), deltas.data(), levels.data(), oscillators);
+		for(size_t o = 0; o < oscillators; o++) {
+			ASSERT_EQ((UINT32)(initialPhases[o] + (deltas[o] * (UINT32)frames)), expectedPhases[o]);
+		}
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::vector<UINT32> phases(initialPhases);
+			std::vector<float> actual(frames);
+			SimdKernel::oscillatorBank(actual.data(), 13, tables.data(), offsets.data(), phases.data(), deltas.data(), levels.data(), oscillators);
+			SimdKernel::oscillatorBank(&actual[13], frames - 13, tables.data(), offsets.data(), phases.data(), deltas.data(), levels.data(), oscillators);
+			ASSERT_EQ(0, memcmp(expected.data(), actual.data(), frames * sizeof(float)))
+				<< SimdKernel::getInstructionSetName(is) << ": oscillators=" << oscillators;
+			ASSERT_EQ(expectedPhases, phases) << SimdKernel::getInstructionSetName(is);
+		}
+	}
+}
+
+// Oscillator should read wave table with 64-bit phase, and all instruction sets should generate identical samples.
+TEST_F(SimdKernelUnitTest, oscillator)
+{
+	static const size_t tableSize = 1 << SimdKernel::OscillatorBankTableBits;
+	static const size_t frames = 1003;
+	static const double pi = 3.14159265358979323846;
+
+	std::vector<float> table(tableSize + 1);
+	for(size_t i = 0; i <= tableSize; i++) {
+		table[i] = (float)sin(2 * pi * i / tableSize);
+	}
+
+	// Phase wraps around and low 32 bits carry to high 32 bits in the frames.
+	for(UINT64 delta : { 0x0123456789abcdefull, 0x00000000ffffffffull, 0x7fffffffffffffffull }) {
+		const UINT64 initialPhase = 0xfedcba9876543210ull;
+		const float level = 0.75f;
+
+		// Reference calculated by double.
+		for(size_t i = 0; i < frames; i += 97) {
+			auto phase = (UINT32)((initialPhase + (delta * i)) >> 32);
+			auto position = (double)phase / 4294967296.0 * tableSize;
+			auto index = (size_t)position;
+			auto expected = (table[index] + ((table[index + 1] - table[index]) * (position - index))) * level;
+			float actual[1];
+			SimdKernel::oscillator(actual, 1, table.data(), initialPhase + (delta * i), delta, level);
+			ASSERT_NEAR(expected, actual[0], 1e-6) << "delta=" << delta << ", frame=" << i;
+		}
+
+		SimdKernel::setInstructionSet(SimdKernel::InstructionSet::Scalar);
+		std::vector<float> expected(frames);
+		SimdKernel::oscillator(expected.data(), frames, table.data(), initialPhase, delta, level);
+		for(auto is : getInstructionSets()) {
+			SimdKernel::setInstructionSet(is);
+			std::vector<float> actual(frames);
+			SimdKernel::oscillator(actual.data(), 13, table.data(), initialPhase, delta, level);
+			SimdKernel::oscillator(&actual[13], frames - 13, table.data(), initialPhase + (delta * 13), delta, level);
+			ASSERT_EQ(0, memcmp(expected.data(), actual.data(), frames * sizeof(float)))
+				<< SimdKernel::getInstructionSetName(is) << ": delta=" << delta;
+		}
+	}
+}
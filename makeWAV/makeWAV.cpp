@@ -6,6 +6,8 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <vector>
+#include <chrono>
 
 int main(int argc, char* argv[])
 {
@@ -14,12 +16,23 @@ int main(int argc, char* argv[])
 
 	auto duty = PcmDataEnumerator::DefaultDuty;
 	auto peakPosition = PcmDataEnumerator::DefaultPeakPosition;
+	auto seed = PcmDataEnumerator::DefaultSeed;
+	auto order = PcmDataEnumerator::DefaultOrder;
 	DWORD samplesPerSecond = 44100;
 	WORD channels = 1;
 	WORD key = 440;
 	float level = 1.0f;
 	float phaseShift = 0;
 	WORD sec = 1;
+	auto synthesisMode = IPcmData::SynthesisMode::CycleTable;
+	size_t maxExactPeriodDataSize = 0;
+	size_t partials = 1;
+	auto dither = IPcmData::DitherType::None;
+	std::string digits;
+	size_t toneMilliseconds = IPcmData::DefaultDigitToneMilliseconds;
+	size_t pauseMilliseconds = IPcmData::DefaultDigitPauseMilliseconds;
+	WORD endKey = 20000;
+	auto sweepLaw = IPcmData::SweepLaw::Logarithmic;
 	const PcmDataEnumerator::SampleDataTypeProperty* sampleDataTypeProperty = nullptr;
 	const PcmDataEnumerator::WaveFormProperty* waveFormProperty = nullptr;
 	std::string wavFileName;
@@ -33,12 +46,28 @@ int main(int argc, char* argv[])
 		if(strchr(arg, '=')) {
 			if(sscanf_s(arg, "duty=%f", &fVal) == 1) { duty = fVal; }
 			else if(sscanf_s(arg, "peak=%f", &fVal) == 1) { peakPosition = fVal; }
+			else if(sscanf_s(arg, "seed=%d", &iVal) == 1) { seed = (float)iVal; }
+			else if(sscanf_s(arg, "order=%d", &iVal) == 1) { order = (float)iVal; }
 			else if(sscanf_s(arg, "sps=%d", &iVal) == 1) { samplesPerSecond = iVal; }
 			else if(sscanf_s(arg, "ch=%d", &iVal) == 1) { channels = iVal; }
 			else if(sscanf_s(arg, "key=%d", &iVal) == 1) { key = iVal; }
 			else if(sscanf_s(arg, "lvl=%f", &fVal) == 1) { level = fVal; }
 			else if(sscanf_s(arg, "sft=%f", &fVal) == 1) { phaseShift = fVal; }
 			else if(sscanf_s(arg, "sec=%d", &iVal) == 1) { sec = iVal; }
+			else if(sscanf_s(arg, "partials=%d", &iVal) == 1) { partials = iVal; }
+			else if(_strnicmp(arg, "digits=", 7) == 0) { digits = &arg[7]; }
+			else if(sscanf_s(arg, "on=%d", &iVal) == 1) { toneMilliseconds = iVal; }
+			else if(sscanf_s(arg, "off=%d", &iVal) == 1) { pauseMilliseconds = iVal; }
+			else if(_stricmp(arg, "mode=table") == 0) { synthesisMode = IPcmData::SynthesisMode::CycleTable; }
+			else if(_stricmp(arg, "mode=osc") == 0) { synthesisMode = IPcmData::SynthesisMode::Oscillator; }
+			else if(_stricmp(arg, "mode=bank") == 0) { synthesisMode = IPcmData::SynthesisMode::OscillatorBank; }
+			else if(_stricmp(arg, "mode=exact") == 0) { maxExactPeriodDataSize = IPcmData::DefaultMaxExactPeriodDataSize; }
+			else if(_stricmp(arg, "mode=sweep") == 0) { synthesisMode = IPcmData::SynthesisMode::Sweep; }
+			else if(sscanf_s(arg, "end=%d", &iVal) == 1) { endKey = iVal; }
+			else if(_stricmp(arg, "law=lin") == 0) { sweepLaw = IPcmData::SweepLaw::Linear; }
+			else if(_stricmp(arg, "law=log") == 0) { sweepLaw = IPcmData::SweepLaw::Logarithmic; }
+			else if(_stricmp(arg, "dither=none") == 0) { dither = IPcmData::DitherType::None; }
+			else if(_stricmp(arg, "dither=tpdf") == 0) { dither = IPcmData::DitherType::TPDF; }
 			else {
 				std::cerr << "Unknown argument: " << arg << std::endl;
 				argError = true;
@@ -59,11 +88,22 @@ int main(int argc, char* argv[])
 				}
 				break;
 			case 1:
-				// Sample data type
+				// Sample data type: bits per sample, or "24in32" for 24-bit sample in 32-bit container.
+				// Suffix 'i' or 'f' selects integer or float sample of the same size. e.g. "32i", "64f".
+				// Without suffix, the first type of the bits per sample is selected("32" is float).
 				{
-					WORD bitsPerSample = atoi(arg);
+					int validBitsPerSample = 0, bitsPerSample = 0;
+					char suffix = '\0';
+					if(sscanf_s(arg, "%din%d", &validBitsPerSample, &bitsPerSample) != 2) {
+						validBitsPerSample = bitsPerSample = atoi(arg);
+						auto length = strlen(arg);
+						if(length && isalpha(arg[length - 1])) { suffix = arg[length - 1]; }
+					}
 					for(auto& sp : sampleDataTypeProperties) {
-						if(bitsPerSample == sp.bitsPerSample) {
+						auto isFloat = (sp.formatTag == WAVE_FORMAT_IEEE_FLOAT);
+						if((suffix == 'i') && isFloat) { continue; }
+						if((suffix == 'f') && !isFloat) { continue; }
+						if((bitsPerSample == sp.bitsPerSample) && (validBitsPerSample == sp.validBitsPerSample)) {
 							sampleDataTypeProperty = &sp;
 							break;
 						}
@@ -88,12 +128,18 @@ int main(int argc, char* argv[])
 
 	if(argError || !waveFormProperty || !sampleDataTypeProperty || wavFileName.empty()) {
 		std::cerr << "Usage:"
-			" makeWAV [duty=Duty] [peak=PeakPosition] [sps=SamplesPerSecond] [ch=Channels] [key=Key] [lvl=Level] [sft=PhaseSift] [sec=Second]"
+			" makeWAV [duty=Duty] [peak=PeakPosition] [seed=Seed] [order=Order] [sps=SamplesPerSecond] [ch=Channels] [key=Key] [lvl=Level] [sft=PhaseSift] [sec=Second] [mode=table|osc|bank|exact|sweep] [end=EndKey] [law=lin|log] [partials=Partials] [dither=none|tpdf]"
+			" [digits=Digits] [on=ToneMilliseconds] [off=PauseMilliseconds]"
 			" WaveForm SampleDataType WAVFileName";
 		std::cerr << "\n    waveForm:";
 		for(auto& wp : waveFormProperties) { std::cerr << " '" << wp.name << "'"; };
 		std::cerr << "\n    sampleDataType:";
-		for(auto& sp : sampleDataTypeProperties) { std::cerr << " " << sp.bitsPerSample; };
+		for(auto& sp : sampleDataTypeProperties) {
+			std::cerr << " ";
+			if(sp.validBitsPerSample != sp.bitsPerSample) { std::cerr << sp.validBitsPerSample << "in"; }
+			std::cerr << sp.bitsPerSample;
+			if((sp.validBitsPerSample == sp.bitsPerSample) && (sp.bitsPerSample >= 32)) { std::cerr << ((sp.formatTag == WAVE_FORMAT_IEEE_FLOAT) ? "f" : "i"); }
+		};
 		std::cerr << std::endl;
 		return 1;
 	}
@@ -106,11 +152,32 @@ int main(int argc, char* argv[])
 	case PcmDataEnumerator::FactoryParameter::PeakPosition:
 		param = peakPosition;
 		break;
+	case PcmDataEnumerator::FactoryParameter::Digit:
+		// Digit of continuous tone generated without digits=.
+		if(auto p = strchr(PcmDataEnumerator::getDigits(waveFormProperty->type), toupper(digits.empty() ? '0' : digits[0]))) {
+			param = (float)(p - PcmDataEnumerator::getDigits(waveFormProperty->type));
+		}
+		break;
+	case PcmDataEnumerator::FactoryParameter::Seed:
+		param = seed;
+		break;
+	case PcmDataEnumerator::FactoryParameter::Order:
+		param = order;
+		break;
+	}
+
+	// Partials are summed only by oscillator bank. Sweep and digits ignore partials=.
+	if((1 < partials) && digits.empty() && (synthesisMode != IPcmData::SynthesisMode::Sweep)) {
+		synthesisMode = IPcmData::SynthesisMode::OscillatorBank;
 	}
 
 	std::cout << "Creating WaveGenerator for " << waveFormProperty->name << "," << sampleDataTypeProperty->bitsPerSample << " bits per sample, Parameter=" << param << std::endl;
 	auto gen = waveFormProperty->factory(sampleDataTypeProperty->type, param);
-	auto pcmData(createPcmData(samplesPerSecond, channels, gen));
+	auto pcmData(createPcmData(samplesPerSecond, channels, gen, synthesisMode));
+	if(!pcmData) {
+		std::cerr << "Failed to create PcmData: Channels should be 1 ~ " << IPcmData::MaxChannels << std::endl;
+		return 1;
+	}
 
 	std::cout << "Generating " << pcmData->getWaveFormTypeName() << "(" << pcmData->getSampleDataTypeName() << ") to " << wavFileName
 		<< "\nSamples Per Second=" << samplesPerSecond
@@ -119,14 +186,43 @@ int main(int argc, char* argv[])
 		<< ", Level=" << level
 		<< ", Phase Shift=" << phaseShift
 		<< ", Second=" << sec
+		<< ", Synthesis mode=" << PcmDataEnumerator::getSynthesisModeProperty(pcmData->getSynthesisMode()).name
+		<< ", Dither=" << ((dither == IPcmData::DitherType::TPDF) ? "TPDF" : "None")
 		<< "\n\n";
 
 	std::ofstream wavFile(wavFileName, std::ios_base::binary);
 
-	pcmData->generate(key, level, phaseShift);
 	const size_t duration = 1;
 	auto bufferSize = pcmData->getSampleBufferSize(duration * 1000);
 	auto buffer = std::make_unique<BYTE[]>(bufferSize);
+	HR_EXPECT_OK(pcmData->setBlockSize(bufferSize));
+	HR_EXPECT_OK(pcmData->setExactPeriod(maxExactPeriodDataSize));
+	HR_EXPECT_OK(pcmData->setDither(dither));
+	// Whole script of digits or sweep is written once.
+	auto isScript = !digits.empty() || (synthesisMode == IPcmData::SynthesisMode::Sweep);
+	if(synthesisMode == IPcmData::SynthesisMode::Sweep) {
+		// Sweep from key to end in sec seconds.
+		if(FAILED(HR_EXPECT_OK(pcmData->generateSweep(key, endKey, sec * 1000, sweepLaw, level)))) { return 1; }
+		std::cout << "Sweep " << key << " Hz to " << endKey << " Hz, " << ((sweepLaw == IPcmData::SweepLaw::Linear) ? "Linear" : "Logarithmic") << "\n";
+	} else if(!digits.empty()) {
+		// Script of digits does not depend on sec=.
+		if(FAILED(HR_EXPECT_OK(pcmData->generateDigits(digits.c_str(), toneMilliseconds, pauseMilliseconds, level)))) { return 1; }
+	} else if(1 < partials) {
+		// Harmonic series of the key with the same level, that is summed by oscillator bank.
+		std::vector<IPcmData::ToneParameter> tones;
+		for(size_t i = 1; i <= partials; i++) {
+			tones.push_back({ key * (float)i, level / partials, 0, waveFormProperty->type, param });
+		}
+		if(FAILED(HR_EXPECT_OK(pcmData->generateTones(tones.data(), tones.size())))) { return 1; }
+	} else {
+		pcmData->generate(key, level, phaseShift);
+	}
+	std::cout << "Cycle data size=" << pcmData->getCycleDataSize()
+		<< (pcmData->isTiled() ? "(Tiled)" : "")
+		<< ", Cycles=" << pcmData->getCycles()
+		<< ", Frequency error=" << pcmData->getFrequencyError()
+		<< ", Buffer size=" << bufferSize
+		<< "\n\n";
 
 	/* RIFF waveform audio format
 	*  https://ja.wikipedia.org/wiki/WAV
@@ -135,52 +231,56 @@ int main(int argc, char* argv[])
 	*   +04 Size of RIFF chunk that includes following data.
 	*   +08 `WAVE` : FourCC of WAV file.
 	*   +0c `fmt ` : fmt chunk = WAVEFORMATEX, PCMWAVEFORMAT, WAVEFORMATEXTENSIBLE, ...
-	*   +10 Size of fmt chunk. = 0x10(PCMWAVEFORMAT)
+	*   +10 Size of fmt chunk. = 0x10(PCMWAVEFORMAT) or 0x28(WAVEFORMATEXTENSIBLE)
 	*   +14 wFormatTag
 	*   +16 nChannels
 	*   +18 nSamplesPerSec
 	*   +1c nAvgBytesPerSec
 	*   +20 nBlockAlign
 	*   +22 wBitsPerSample
-	*   +24 `data` : data chunk
+	*   +24 `data` : data chunk(PCMWAVEFORMAT)
 	*   +28 Size of data chunk.
 	*   +2c PCM data. L-ch -> R-ch
+	*
+	*   WAVEFORMATEXTENSIBLE(24-bit sample in 32-bit container) continues from +24:
+	*   +24 cbSize = 0x16
+	*   +26 wValidBitsPerSample
+	*   +28 dwChannelMask
+	*   +2c SubFormat(GUID)
+	*   +3c `data` : data chunk
 	*/
-	DWORD dataSize = bufferSize * sec / duration;
-	struct Header {
-		struct Riff {
-			DWORD chankTag;
-			DWORD size;
-		} riff;
-		struct Wave {
-			DWORD chankTag;
-			struct Fmt {
-				DWORD chankTag;
-				DWORD size;
-				PCMWAVEFORMAT format;
-			} fmt;
-			struct Data {
-				DWORD chankTag;
-				DWORD size;
-			} data;
-		} wave;
-	} header = {
-		{ *(DWORD*)"RIFF", sizeof(Header::Wave) + dataSize },
-		{ *(DWORD*)"WAVE" , {
-			*(DWORD*)"fmt ", sizeof(Header::Wave::Fmt::format), {
-					pcmData->getFormatTag(), pcmData->getChannels(), pcmData->getSamplesPerSec(),
-					pcmData->getSamplesPerSec() * pcmData->getBlockAlign(),
-					pcmData->getBlockAlign(), pcmData->getBitsPerSample()
-				},
-			},
-			{ *(DWORD*)"data", dataSize }
-		}
+	DWORD dataSize = (DWORD)(isScript ? pcmData->getSampleBufferSize(0) : (bufferSize * sec / duration));
+	WAVEFORMATEXTENSIBLE format;
+	pcmData->getWaveFormat(format);
+	DWORD formatSize = format.Format.cbSize ? (sizeof(WAVEFORMATEX) + format.Format.cbSize) : sizeof(PCMWAVEFORMAT);
+	struct Chunk {
+		DWORD chankTag;
+		DWORD size;
 	};
+	const Chunk riff = { *(DWORD*)"RIFF", (DWORD)(sizeof(DWORD) + sizeof(Chunk) + formatSize + sizeof(Chunk) + dataSize) };
+	const DWORD wave = *(DWORD*)"WAVE";
+	const Chunk fmt = { *(DWORD*)"fmt ", formatSize };
+	const Chunk data = { *(DWORD*)"data", dataSize };
 
-	wavFile.write((const char*)&header, sizeof(header));
+	wavFile.write((const char*)&riff, sizeof(riff));
+	wavFile.write((const char*)&wave, sizeof(wave));
+	wavFile.write((const char*)&fmt, sizeof(fmt));
+	wavFile.write((const char*)&format, formatSize);
+	wavFile.write((const char*)&data, sizeof(data));
 
-	for(size_t totalSec = 0; totalSec < sec; totalSec += duration) {
-		if(FAILED(HR_EXPECT_OK(pcmData->copyTo(buffer.get(), bufferSize)))) break;
-		wavFile.write((const char*)buffer.get(), bufferSize);
+	// Time to copy samples is measured to show how fast the data is rendered compared with real time.
+	std::chrono::steady_clock::duration renderTime(0);
+	for(size_t written = 0; written < dataSize; written += bufferSize) {
+		auto size = min(bufferSize, dataSize - written);
+		auto start = std::chrono::steady_clock::now();
+		if(FAILED(HR_EXPECT_OK(pcmData->copyTo(buffer.get(), size)))) break;
+		renderTime += std::chrono::steady_clock::now() - start;
+		wavFile.write((const char*)buffer.get(), size);
 	}
+
+	auto dataSec = (double)dataSize / format.Format.nAvgBytesPerSec;
+	auto renderSec = std::chrono::duration<double>(renderTime).count();
+	std::cout << "Rendered " << dataSec << " sec in " << (renderSec * 1000) << " mSec";
+	if(0 < renderSec) { std::cout << "(" << (dataSec / renderSec) << " x real time)"; }
+	std::cout << std::endl;
 }